@@ -0,0 +1,225 @@
+#include "Common/AABBTree.hpp"
+
+namespace Marbas {
+
+int32_t
+AABBTree::Insert(const BoundingBox& box, uint32_t userData) {
+  auto proxy = AllocateNode();
+  auto& node = m_nodes[proxy];
+  node.box = box;
+  node.fatBox = GetFatBox(box);
+  node.userData = userData;
+  node.height = 0;
+  InsertLeaf(proxy);
+  m_proxyCount++;
+  return proxy;
+}
+
+void
+AABBTree::Remove(int32_t proxy) {
+  RemoveLeaf(proxy);
+  FreeNode(proxy);
+  m_proxyCount--;
+}
+
+bool
+AABBTree::Move(int32_t proxy, const BoundingBox& box) {
+  auto& node = m_nodes[proxy];
+  node.box = box;
+
+  // the fat box is built again if it's too large, otherwise the leaf moved far away keeps a huge box
+  auto fatBox = GetFatBox(box);
+  auto hugeBox = GetFatBox(fatBox);
+  if (node.fatBox.Contains(box) && hugeBox.Contains(node.fatBox)) {
+    return false;
+  }
+
+  RemoveLeaf(proxy);
+  m_nodes[proxy].fatBox = fatBox;
+  InsertLeaf(proxy);
+  return true;
+}
+
+void
+AABBTree::Clear() {
+  m_nodes.clear();
+  m_root = nullNode;
+  m_freeList = nullNode;
+  m_proxyCount = 0;
+}
+
+int32_t
+AABBTree::AllocateNode() {
+  if (m_freeList == nullNode) {
+    m_nodes.emplace_back();
+    return static_cast<int32_t>(m_nodes.size() - 1);
+  }
+
+  auto node = m_freeList;
+  m_freeList = m_nodes[node].parent;
+  m_nodes[node] = Node();
+  return node;
+}
+
+void
+AABBTree::FreeNode(int32_t node) {
+  m_nodes[node].parent = m_freeList;
+  m_nodes[node].height = -1;
+  m_freeList = node;
+}
+
+void
+AABBTree::InsertLeaf(int32_t leaf) {
+  if (m_root == nullNode) {
+    m_root = leaf;
+    m_nodes[leaf].parent = nullNode;
+    return;
+  }
+
+  // find the best sibling, the cost is the perimeter of the new parent and the perimeters increased in the ancestors
+  const auto leafBox = m_nodes[leaf].fatBox;
+  auto index = m_root;
+  while (!m_nodes[index].IsLeaf()) {
+    const auto& node = m_nodes[index];
+    const float perimeter = node.fatBox.GetPerimeter();
+    const float combinedPerimeter = BoundingBox::Union(node.fatBox, leafBox).GetPerimeter();
+
+    // the cost to create a new parent for this node and the leaf
+    const float cost = 2.0f * combinedPerimeter;
+
+    // the minimum cost to push the leaf down the tree
+    const float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+    auto getDescendCost = [&](int32_t child) {
+      const auto& childBox = m_nodes[child].fatBox;
+      float childCost = BoundingBox::Union(childBox, leafBox).GetPerimeter();
+      if (!m_nodes[child].IsLeaf()) childCost -= childBox.GetPerimeter();
+      return childCost + inheritanceCost;
+    };
+    const float cost1 = getDescendCost(node.child1);
+    const float cost2 = getDescendCost(node.child2);
+
+    if (cost < cost1 && cost < cost2) break;
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  // create a new parent for the sibling and the leaf, the node may be reallocated, so the reference isn't kept
+  const auto sibling = index;
+  const auto oldParent = m_nodes[sibling].parent;
+  const auto newParent = AllocateNode();
+  m_nodes[newParent].parent = oldParent;
+  m_nodes[newParent].fatBox = BoundingBox::Union(leafBox, m_nodes[sibling].fatBox);
+  m_nodes[newParent].height = m_nodes[sibling].height + 1;
+  m_nodes[newParent].child1 = sibling;
+  m_nodes[newParent].child2 = leaf;
+  m_nodes[sibling].parent = newParent;
+  m_nodes[leaf].parent = newParent;
+
+  if (oldParent == nullNode) {
+    m_root = newParent;
+  } else if (m_nodes[oldParent].child1 == sibling) {
+    m_nodes[oldParent].child1 = newParent;
+  } else {
+    m_nodes[oldParent].child2 = newParent;
+  }
+
+  Refit(newParent);
+}
+
+void
+AABBTree::RemoveLeaf(int32_t leaf) {
+  if (leaf == m_root) {
+    m_root = nullNode;
+    return;
+  }
+
+  // the sibling takes the place of the parent
+  const auto parent = m_nodes[leaf].parent;
+  const auto grandParent = m_nodes[parent].parent;
+  const auto sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+  m_nodes[sibling].parent = grandParent;
+  FreeNode(parent);
+
+  if (grandParent == nullNode) {
+    m_root = sibling;
+    return;
+  }
+  if (m_nodes[grandParent].child1 == parent) {
+    m_nodes[grandParent].child1 = sibling;
+  } else {
+    m_nodes[grandParent].child2 = sibling;
+  }
+  Refit(grandParent);
+}
+
+void
+AABBTree::Refit(int32_t node) {
+  while (node != nullNode) {
+    node = Balance(node);
+
+    auto& current = m_nodes[node];
+    const auto& child1 = m_nodes[current.child1];
+    const auto& child2 = m_nodes[current.child2];
+    current.fatBox = BoundingBox::Union(child1.fatBox, child2.fatBox);
+    current.height = 1 + std::max(child1.height, child2.height);
+
+    node = current.parent;
+  }
+}
+
+int32_t
+AABBTree::Balance(int32_t iA) {
+  // A is the node, B and C are its children
+  auto& a = m_nodes[iA];
+  if (a.IsLeaf() || a.height < 2) return iA;
+
+  const auto iB = a.child1;
+  const auto iC = a.child2;
+  auto& b = m_nodes[iB];
+  auto& c = m_nodes[iC];
+  const int32_t balance = c.height - b.height;
+
+  // rotate the higher child up, its higher child is kept and its lower child is given to A
+  auto rotate = [&](int32_t iUp, Node& up, Node& other, int32_t& childOfA) {
+    const auto iF = up.child1;
+    const auto iG = up.child2;
+    auto& f = m_nodes[iF];
+    auto& g = m_nodes[iG];
+
+    up.child1 = iA;
+    up.parent = a.parent;
+    a.parent = iUp;
+    if (up.parent == nullNode) {
+      m_root = iUp;
+    } else if (m_nodes[up.parent].child1 == iA) {
+      m_nodes[up.parent].child1 = iUp;
+    } else {
+      m_nodes[up.parent].child2 = iUp;
+    }
+
+    const bool keepF = f.height > g.height;
+    const auto iKeep = keepF ? iF : iG;
+    const auto iGive = keepF ? iG : iF;
+    auto& keep = m_nodes[iKeep];
+    auto& give = m_nodes[iGive];
+    up.child2 = iKeep;
+    childOfA = iGive;
+    give.parent = iA;
+    a.fatBox = BoundingBox::Union(other.fatBox, give.fatBox);
+    a.height = 1 + std::max(other.height, give.height);
+    up.fatBox = BoundingBox::Union(a.fatBox, keep.fatBox);
+    up.height = 1 + std::max(a.height, keep.height);
+    return iUp;
+  };
+
+  if (balance > 1) return rotate(iC, c, b, a.child2);
+  if (balance < -1) return rotate(iB, b, c, a.child1);
+  return iA;
+}
+
+BoundingBox
+AABBTree::GetFatBox(const BoundingBox& box) const {
+  auto margin = (box.max - box.min) * m_marginRatio;
+  return {box.min - margin, box.max + margin};
+}
+
+}  // namespace Marbas
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Common/BoundingBox.hpp"
+#include "Common/Common.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief a dynamic bounding volume hierarchy of the boxes, the boxes can be inserted, moved and removed at any time.
+ *
+ * Every leaf keeps a fat box enlarged by a margin, a box moved inside its fat box doesn't change the tree, otherwise
+ * the leaf is removed and inserted again. The leaf is inserted beside the node with the least increased perimeter,
+ * and the tree is balanced by rotations on the way back to the root, so the queries visit O(log n) nodes.
+ *
+ * @see Box2D b2DynamicTree
+ */
+class MARBAS_EXPORT AABBTree {
+ public:
+  static constexpr int32_t nullNode = -1;
+
+  /**
+   * @param marginRatio the margin of the fat box relative to the extent of the box
+   */
+  explicit AABBTree(float marginRatio = 0.1f) : m_marginRatio(marginRatio) {}
+
+ public:
+  /**
+   * @brief insert a box
+   *
+   * @param userData the data returned by the queries
+   * @return the proxy used to move or remove the box
+   */
+  int32_t
+  Insert(const BoundingBox& box, uint32_t userData);
+
+  void
+  Remove(int32_t proxy);
+
+  /**
+   * @brief move the box of the proxy
+   *
+   * @return true if the leaf is inserted again
+   */
+  bool
+  Move(int32_t proxy, const BoundingBox& box);
+
+  void
+  Clear();
+
+  uint32_t
+  GetUserData(int32_t proxy) const {
+    return m_nodes[proxy].userData;
+  }
+
+  const BoundingBox&
+  GetBox(int32_t proxy) const {
+    return m_nodes[proxy].box;
+  }
+
+  const BoundingBox&
+  GetFatBox(int32_t proxy) const {
+    return m_nodes[proxy].fatBox;
+  }
+
+  size_t
+  GetProxyCount() const {
+    return m_proxyCount;
+  }
+
+  int32_t
+  GetHeight() const {
+    return m_root == nullNode ? 0 : m_nodes[m_root].height;
+  }
+
+  /**
+   * @brief call func(userData) for every box which is on the frustum
+   */
+  template <typename Func>
+  void
+  QueryFrustum(const Frustum& frustum, Func&& func) const {
+    Query([&](const BoundingBox& box) { return box.IsOnFrustum(frustum); }, std::forward<Func>(func));
+  }
+
+  /**
+   * @brief call func(userData) for every box overlapped with the box
+   */
+  template <typename Func>
+  void
+  QueryBox(const BoundingBox& queryBox, Func&& func) const {
+    Query([&](const BoundingBox& box) { return box.Overlap(queryBox); }, std::forward<Func>(func));
+  }
+
+  /**
+   * @brief call func(userData) for every box overlapped with the sphere
+   */
+  template <typename Func>
+  void
+  QuerySphere(const glm::vec3& center, float radius, Func&& func) const {
+    Query([&](const BoundingBox& box) { return box.IntersectSphere(center, radius); }, std::forward<Func>(func));
+  }
+
+  /**
+   * @brief call func(userData, distance) for every box hit by the ray, the distance is where the ray enters the box
+   *
+   * @param direction the normalized direction of the ray
+   */
+  template <typename Func>
+  void
+  QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Func&& func) const {
+    const auto invDirection = 1.0f / direction;
+    float distance = 0;
+    Query([&](const BoundingBox& box) { return box.IntersectRay(origin, invDirection, maxDistance, distance); },
+          [&](uint32_t userData) { func(userData, distance); });
+  }
+
+ private:
+  /**
+   * @brief visit the nodes whose fat box passes the test, the leaf is tested by its own box before calling func
+   */
+  template <typename Test, typename Func>
+  void
+  Query(Test&& test, Func&& func) const {
+    if (m_root == nullNode) return;
+
+    Vector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_root);
+    while (!stack.empty()) {
+      const auto& node = m_nodes[stack.back()];
+      stack.pop_back();
+      if (!test(node.fatBox)) continue;
+
+      if (node.IsLeaf()) {
+        if (test(node.box)) func(node.userData);
+      } else {
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+      }
+    }
+  }
+
+  int32_t
+  AllocateNode();
+
+  void
+  FreeNode(int32_t node);
+
+  void
+  InsertLeaf(int32_t leaf);
+
+  void
+  RemoveLeaf(int32_t leaf);
+
+  /**
+   * @brief fix the boxes and the heights from the node to the root, and balance the nodes on the way
+   */
+  void
+  Refit(int32_t node);
+
+  /**
+   * @brief rotate the child up if the node is unbalanced
+   *
+   * @return the root of the subtree after rotating
+   */
+  int32_t
+  Balance(int32_t node);
+
+  BoundingBox
+  GetFatBox(const BoundingBox& box) const;
+
+ private:
+  struct Node {
+    BoundingBox fatBox;  // the box containing the subtree, or the fat box of the leaf
+    BoundingBox box;     // the box inserted by the user, only for the leaf
+    int32_t parent = nullNode;  // the next free node if the node is free
+    int32_t child1 = nullNode;
+    int32_t child2 = nullNode;
+    int32_t height = 0;  // the leaf is 0, and the free node is -1
+    uint32_t userData = 0;
+
+    bool
+    IsLeaf() const {
+      return child1 == nullNode;
+    }
+  };
+
+  Vector<Node> m_nodes;
+  int32_t m_root = nullNode;
+  int32_t m_freeList = nullNode;
+  size_t m_proxyCount = 0;
+  float m_marginRatio;
+};
+
+}  // namespace Marbas
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "Common/Frustum.hpp"
+#include "Common/MathCommon.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief an axis aligned bounding box in the world space, the default box is empty
+ */
+struct BoundingBox {
+  glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+  static BoundingBox
+  Union(const BoundingBox& lhs, const BoundingBox& rhs) {
+    return {glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max)};
+  }
+
+  glm::vec3
+  GetCenter() const {
+    return (min + max) * 0.5f;
+  }
+
+  glm::vec3
+  GetHalfExtent() const {
+    return (max - min) * 0.5f;
+  }
+
+  /**
+   * @brief half of the surface area, it's the cost of the node in the bounding volume hierarchy
+   */
+  float
+  GetPerimeter() const {
+    auto extent = max - min;
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+  }
+
+  bool
+  Contains(const BoundingBox& other) const {
+    return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z && other.max.x <= max.x &&
+           other.max.y <= max.y && other.max.z <= max.z;
+  }
+
+  bool
+  Overlap(const BoundingBox& other) const {
+    return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z && other.min.x <= max.x &&
+           other.min.y <= max.y && other.min.z <= max.z;
+  }
+
+  bool
+  IsOnFrustum(const Frustum& frustum) const {
+    // @see https://gdbooks.gitbooks.io/3dcollisions/content/Chapter2/static_aabb_plane.html
+    const auto center = GetCenter();
+    const auto halfExtent = GetHalfExtent();
+    auto isOnOrForwardPlan = [&](const Plan& plan) {
+      const float r = glm::dot(halfExtent, glm::abs(plan.normal));
+      return -r <= plan.getSignedDistanceToPlan(center);
+    };
+    return isOnOrForwardPlan(frustum.leftFace) && isOnOrForwardPlan(frustum.rightFace) &&
+           isOnOrForwardPlan(frustum.topFace) && isOnOrForwardPlan(frustum.bottomFace) &&
+           isOnOrForwardPlan(frustum.nearFace) && isOnOrForwardPlan(frustum.farFace);
+  }
+
+  bool
+  IntersectSphere(const glm::vec3& center, float radius) const {
+    auto offset = glm::clamp(center, min, max) - center;
+    return glm::dot(offset, offset) <= radius * radius;
+  }
+
+  /**
+   * @brief the slab test of the ray, the distance where the ray enters the box is returned by the distance
+   *
+   * @param invDirection the reciprocal of the direction of the ray
+   */
+  bool
+  IntersectRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, float& distance) const {
+    auto t1 = (min - origin) * invDirection;
+    auto t2 = (max - origin) * invDirection;
+    auto tMin = glm::min(t1, t2);
+    auto tMax = glm::max(t1, t2);
+    float enter = std::max({tMin.x, tMin.y, tMin.z, 0.0f});
+    float exit = std::min({tMax.x, tMax.y, tMax.z, maxDistance});
+    distance = enter;
+    return enter <= exit;
+  }
+
+  /**
+   * @brief the box containing this box transformed by the matrix
+   * @see https://github.com/erich666/GraphicsGems/blob/master/gems/TransBox.c
+   */
+  BoundingBox
+  Transform(const glm::mat4& matrix) const {
+    const auto center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.0f));
+    const auto halfExtent = GetHalfExtent();
+    glm::vec3 newHalfExtent(0.0f);
+    for (int i = 0; i < 3; i++) {
+      newHalfExtent += glm::abs(glm::vec3(matrix[i])) * halfExtent[i];
+    }
+    return {center - newHalfExtent, center + newHalfExtent};
+  }
+};
+
+}  // namespace Marbas
@@ -0,0 +1,154 @@
+#include "Common/BoundingBoxArray.hpp"
+
+#include <array>
+#include <bit>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MARBAS_CULLING_SSE
+#endif
+
+namespace Marbas {
+
+void
+BoundingBoxArray::Push(const BoundingBox& box) {
+  m_centerX.emplace_back();
+  m_centerY.emplace_back();
+  m_centerZ.emplace_back();
+  m_halfExtentX.emplace_back();
+  m_halfExtentY.emplace_back();
+  m_halfExtentZ.emplace_back();
+  Set(GetSize() - 1, box);
+}
+
+void
+BoundingBoxArray::Set(size_t index, const BoundingBox& box) {
+  const auto center = box.GetCenter();
+  const auto halfExtent = box.GetHalfExtent();
+  m_centerX[index] = center.x;
+  m_centerY[index] = center.y;
+  m_centerZ[index] = center.z;
+  m_halfExtentX[index] = halfExtent.x;
+  m_halfExtentY[index] = halfExtent.y;
+  m_halfExtentZ[index] = halfExtent.z;
+}
+
+BoundingBox
+BoundingBoxArray::Get(size_t index) const {
+  const glm::vec3 center(m_centerX[index], m_centerY[index], m_centerZ[index]);
+  const glm::vec3 halfExtent(m_halfExtentX[index], m_halfExtentY[index], m_halfExtentZ[index]);
+  return {center - halfExtent, center + halfExtent};
+}
+
+void
+BoundingBoxArray::RemoveSwapBack(size_t index) {
+  for (auto* array : {&m_centerX, &m_centerY, &m_centerZ, &m_halfExtentX, &m_halfExtentY, &m_halfExtentZ}) {
+    (*array)[index] = array->back();
+    array->pop_back();
+  }
+}
+
+void
+BoundingBoxArray::Clear() {
+  for (auto* array : {&m_centerX, &m_centerY, &m_centerZ, &m_halfExtentX, &m_halfExtentY, &m_halfExtentZ}) {
+    array->clear();
+  }
+}
+
+void
+BoundingBoxArray::CullFrustum(const Frustum& frustum, Vector<uint32_t>& visible) const {
+  // the box is on the frustum if it's on or in front of every plane, the projected radius of the box on the normal of
+  // the plane is dot(halfExtent, abs(normal)), it's computed in the same order as BoundingBox::IsOnFrustum
+  struct PlaneData {
+    float normalX, normalY, normalZ;
+    float absNormalX, absNormalY, absNormalZ;
+    float distance;
+  };
+  std::array<PlaneData, 6> planes;
+  const std::array<const Plan*, 6> faces = {&frustum.leftFace, &frustum.rightFace, &frustum.topFace,
+                                            &frustum.bottomFace, &frustum.nearFace, &frustum.farFace};
+  for (size_t i = 0; i < faces.size(); i++) {
+    const auto& normal = faces[i]->normal;
+    planes[i] = {normal.x, normal.y, normal.z, std::abs(normal.x), std::abs(normal.y), std::abs(normal.z),
+                 faces[i]->distance};
+  }
+
+  const auto count = static_cast<uint32_t>(GetSize());
+  uint32_t index = 0;
+
+#if defined(__AVX__)
+  for (; index + 8 <= count; index += 8) {
+    const __m256 centerX = _mm256_loadu_ps(m_centerX.data() + index);
+    const __m256 centerY = _mm256_loadu_ps(m_centerY.data() + index);
+    const __m256 centerZ = _mm256_loadu_ps(m_centerZ.data() + index);
+    const __m256 halfExtentX = _mm256_loadu_ps(m_halfExtentX.data() + index);
+    const __m256 halfExtentY = _mm256_loadu_ps(m_halfExtentY.data() + index);
+    const __m256 halfExtentZ = _mm256_loadu_ps(m_halfExtentZ.data() + index);
+
+    __m256 isInside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto& plane : planes) {
+      __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.normalX), centerX),
+                                      _mm256_mul_ps(_mm256_set1_ps(plane.normalY), centerY));
+      distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.normalZ), centerZ));
+      distance = _mm256_sub_ps(distance, _mm256_set1_ps(plane.distance));
+
+      __m256 radius = _mm256_add_ps(_mm256_mul_ps(halfExtentX, _mm256_set1_ps(plane.absNormalX)),
+                                    _mm256_mul_ps(halfExtentY, _mm256_set1_ps(plane.absNormalY)));
+      radius = _mm256_add_ps(radius, _mm256_mul_ps(halfExtentZ, _mm256_set1_ps(plane.absNormalZ)));
+
+      const __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), radius);
+      isInside = _mm256_and_ps(isInside, _mm256_cmp_ps(negativeRadius, distance, _CMP_LE_OQ));
+    }
+
+    for (auto mask = static_cast<uint32_t>(_mm256_movemask_ps(isInside)); mask != 0; mask &= mask - 1) {
+      visible.push_back(index + std::countr_zero(mask));
+    }
+  }
+#elif defined(MARBAS_CULLING_SSE)
+  for (; index + 4 <= count; index += 4) {
+    const __m128 centerX = _mm_loadu_ps(m_centerX.data() + index);
+    const __m128 centerY = _mm_loadu_ps(m_centerY.data() + index);
+    const __m128 centerZ = _mm_loadu_ps(m_centerZ.data() + index);
+    const __m128 halfExtentX = _mm_loadu_ps(m_halfExtentX.data() + index);
+    const __m128 halfExtentY = _mm_loadu_ps(m_halfExtentY.data() + index);
+    const __m128 halfExtentZ = _mm_loadu_ps(m_halfExtentZ.data() + index);
+
+    __m128 isInside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+    for (const auto& plane : planes) {
+      __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normalX), centerX),
+                                   _mm_mul_ps(_mm_set1_ps(plane.normalY), centerY));
+      distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.normalZ), centerZ));
+      distance = _mm_sub_ps(distance, _mm_set1_ps(plane.distance));
+
+      __m128 radius = _mm_add_ps(_mm_mul_ps(halfExtentX, _mm_set1_ps(plane.absNormalX)),
+                                 _mm_mul_ps(halfExtentY, _mm_set1_ps(plane.absNormalY)));
+      radius = _mm_add_ps(radius, _mm_mul_ps(halfExtentZ, _mm_set1_ps(plane.absNormalZ)));
+
+      const __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+      isInside = _mm_and_ps(isInside, _mm_cmple_ps(negativeRadius, distance));
+    }
+
+    for (auto mask = static_cast<uint32_t>(_mm_movemask_ps(isInside)); mask != 0; mask &= mask - 1) {
+      visible.push_back(index + std::countr_zero(mask));
+    }
+  }
+#endif
+
+  // the remaining boxes
+  for (; index < count; index++) {
+    bool isInside = true;
+    for (const auto& plane : planes) {
+      const float distance =
+          plane.normalX * m_centerX[index] + plane.normalY * m_centerY[index] + plane.normalZ * m_centerZ[index] -
+          plane.distance;
+      const float radius = m_halfExtentX[index] * plane.absNormalX + m_halfExtentY[index] * plane.absNormalY +
+                           m_halfExtentZ[index] * plane.absNormalZ;
+      isInside &= -radius <= distance;
+    }
+    if (isInside) visible.push_back(index);
+  }
+}
+
+}  // namespace Marbas
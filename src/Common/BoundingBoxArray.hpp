@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Common/BoundingBox.hpp"
+#include "Common/Common.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief the bounding boxes stored as structure of arrays. Every coordinate of the centers and the half extents has its
+ * own array, so the culling kernel loads the same coordinate of several boxes into one SIMD register.
+ */
+class MARBAS_EXPORT BoundingBoxArray {
+ public:
+  size_t
+  GetSize() const {
+    return m_centerX.size();
+  }
+
+  void
+  Push(const BoundingBox& box);
+
+  void
+  Set(size_t index, const BoundingBox& box);
+
+  BoundingBox
+  Get(size_t index) const;
+
+  /**
+   * @brief remove the box by moving the last box to its index
+   */
+  void
+  RemoveSwapBack(size_t index);
+
+  void
+  Clear();
+
+  /**
+   * @brief append the indices of the boxes on the frustum to the visible in ascending order.
+   *
+   * The boxes are tested against the six planes 8 at a time with AVX or 4 at a time with SSE, the result is the same as
+   * BoundingBox::IsOnFrustum.
+   */
+  void
+  CullFrustum(const Frustum& frustum, Vector<uint32_t>& visible) const;
+
+ private:
+  Vector<float> m_centerX;
+  Vector<float> m_centerY;
+  Vector<float> m_centerZ;
+  Vector<float> m_halfExtentX;
+  Vector<float> m_halfExtentY;
+  Vector<float> m_halfExtentZ;
+};
+
+}  // namespace Marbas
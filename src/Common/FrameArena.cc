@@ -0,0 +1,47 @@
+#include "Common/FrameArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Marbas {
+
+void*
+FrameArena::Allocate(size_t size, size_t alignment) {
+  if (!m_blocks.empty()) {
+    auto& block = m_blocks.back();
+    const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+    const auto address = (base + m_offset + alignment - 1) & ~(alignment - 1);
+    if (address + size <= base + block.size) {
+      m_offset = address + size - base;
+      return reinterpret_cast<void*>(address);
+    }
+  }
+
+  // the new block is large enough for the allocation even if it's not aligned
+  const auto blockSize = std::max(m_blockSize, size + alignment);
+  m_blocks.push_back({std::make_unique<std::byte[]>(blockSize), blockSize});
+  m_offset = 0;
+  return Allocate(size, alignment);
+}
+
+void
+FrameArena::Reset() {
+  m_offset = 0;
+  if (m_blocks.size() <= 1) return;
+
+  // the memory used in this frame is likely to be used in the next frame too
+  const auto capacity = GetCapacity();
+  m_blocks.clear();
+  m_blocks.push_back({std::make_unique<std::byte[]>(capacity), capacity});
+}
+
+size_t
+FrameArena::GetCapacity() const {
+  size_t capacity = 0;
+  for (const auto& block : m_blocks) {
+    capacity += block.size;
+  }
+  return capacity;
+}
+
+}  // namespace Marbas
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include "Common/Common.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief a linear allocator for the data only used in a frame.
+ *
+ * The memory is allocated by bumping an offset and released all at once by Reset. The blocks allocated in a frame
+ * are merged into one block when it's reset, so the arena doesn't allocate any more once it's warmed up.
+ */
+class MARBAS_EXPORT FrameArena final {
+ public:
+  explicit FrameArena(size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+  FrameArena(const FrameArena&) = delete;
+  FrameArena&
+  operator=(const FrameArena&) = delete;
+
+ public:
+  /**
+   * @brief allocate an array of the type, the destructor of the elements is never called, so the type must be
+   * trivially destructible
+   */
+  template <typename T>
+  std::span<T>
+  Allocate(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>, "the destructor isn't called by the arena");
+    if (count == 0) return {};
+    auto* data = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    std::uninitialized_value_construct_n(data, count);
+    return {data, count};
+  }
+
+  void*
+  Allocate(size_t size, size_t alignment);
+
+  /**
+   * @brief release all the memory allocated from the arena, the spans allocated before can't be used any more
+   */
+  void
+  Reset();
+
+  size_t
+  GetCapacity() const;
+
+  size_t
+  GetBlockCount() const {
+    return m_blocks.size();
+  }
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  size_t m_blockSize;
+  Vector<Block> m_blocks;
+  size_t m_offset = 0;  // the offset in the last block
+};
+
+}  // namespace Marbas
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "Common.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief a fixed size thread pool, the tasks are executed in the order of submitting
+ */
+class ThreadPool final {
+ public:
+  explicit ThreadPool(uint32_t threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+    for (uint32_t i = 0; i < threadCount; i++) {
+      m_threads.emplace_back([this] { WorkLoop(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock(m_mutex);
+      m_isStop = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads) {
+      thread.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool&
+  operator=(const ThreadPool&) = delete;
+
+ public:
+  uint32_t
+  GetThreadCount() const {
+    return static_cast<uint32_t>(m_threads.size());
+  }
+
+  template <typename Func>
+  std::future<std::invoke_result_t<Func>>
+  Submit(Func&& func) {
+    using Result = std::invoke_result_t<Func>;
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+    auto future = task->get_future();
+    {
+      std::lock_guard lock(m_mutex);
+      m_tasks.push([task] { (*task)(); });
+    }
+    m_condition.notify_one();
+    return future;
+  }
+
+  /**
+   * @brief call func(i) for i in [0, count) on the pool and wait for all of them. The caller thread also runs the
+   * tasks, so it won't dead lock even if it's called in the worker thread.
+   *
+   * If func throws, the remaining indices are skipped and the first exception is rethrown in the caller thread after
+   * all the tasks are finished.
+   */
+  template <typename Func>
+  void
+  ParallelFor(uint32_t count, Func&& func) {
+    struct State {
+      std::atomic_uint32_t next = 0;
+      std::atomic_uint32_t finished = 0;
+      std::atomic_bool isFailed = false;
+      std::mutex exceptionMutex;
+      std::exception_ptr exception;
+    };
+
+    // the helper task may start after all indices are finished, it won't touch the func in that case
+    auto state = std::make_shared<State>();
+    auto work = [state, count, &func] {
+      for (uint32_t i = state->next++; i < count; i = state->next++) {
+        // the index is still counted as finished when func throws, otherwise the caller waits forever
+        if (!state->isFailed) {
+          try {
+            func(i);
+          } catch (...) {
+            std::lock_guard lock(state->exceptionMutex);
+            if (!state->exception) state->exception = std::current_exception();
+            state->isFailed = true;
+          }
+        }
+        if (++state->finished == count) {
+          state->finished.notify_all();
+        }
+      }
+    };
+
+    const uint32_t helperCount = std::min(GetThreadCount(), count > 0 ? count - 1 : 0);
+    for (uint32_t i = 0; i < helperCount; i++) {
+      Submit(work);
+    }
+    work();
+
+    for (uint32_t finished = state->finished; finished != count; finished = state->finished) {
+      state->finished.wait(finished);
+    }
+
+    if (state->exception) {
+      std::rethrow_exception(state->exception);
+    }
+  }
+
+ private:
+  void
+  WorkLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_isStop || !m_tasks.empty(); });
+        if (m_isStop && m_tasks.empty()) return;
+        task = std::move(m_tasks.front());
+        m_tasks.pop();
+      }
+      task();
+    }
+  }
+
+ private:
+  Vector<std::thread> m_threads;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_isStop = false;
+};
+
+}  // namespace Marbas
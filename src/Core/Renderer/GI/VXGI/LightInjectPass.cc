@@ -6,7 +6,11 @@
 
 namespace Marbas::GI {
 
-LightInjectPass::LightInjectPass(const LightInjectPassCreateInfo& createInfo) : m_rhiFactory(createInfo.rhiFactory) {}
+LightInjectPass::LightInjectPass(const LightInjectPassCreateInfo& createInfo)
+    : m_rhiFactory(createInfo.rhiFactory),
+      m_voxelDiffuse(createInfo.voxelDiffuse),
+      m_voxelNormal(createInfo.voxelNormal),
+      m_voxelRadiance(createInfo.voxelRadiance) {}
 
 LightInjectPass::~LightInjectPass() {}
 
@@ -14,6 +18,11 @@ void
 LightInjectPass::SetUp(RenderGraphComputeBuilder& builder) {
   auto& lightArgument = LightRenderComponent::GetDescriptorSetArgument();
 
+  // the radiance is injected from the voxels of this frame, and it's cleared before the injection
+  builder.ReadExternalTexture(m_voxelDiffuse);
+  builder.ReadExternalTexture(m_voxelNormal);
+  builder.WriteExternalTexture(m_voxelRadiance);
+
   builder.BeginPipeline();
   builder.AddShaderArgument(VoxelRenderComponent::GetLightInjectDescriptorArgument());
   builder.AddShaderArgument(lightArgument);
@@ -32,7 +41,8 @@ LightInjectPass::Execute(RenderGraphComputeRegistry& registry, ComputeCommandBuf
   DLOG_IF(WARNING, renderLightDataView.size() > 1)
       << FORMAT("multi {} in the scene", NAMEOF_TYPE(LightRenderComponent));
   auto& renderLightData = scene->Get<LightRenderComponent>(renderLightDataView[0]);
-  auto& lightDataSet = renderLightData.m_lightSet;
+  const auto frameIndex = registry.GetFrameIndex();
+  auto lightDataSet = renderLightData.m_lightSets[frameIndex];
 
   auto giDataView = scene->View<VoxelRenderComponent>();
 
@@ -41,7 +51,7 @@ LightInjectPass::Execute(RenderGraphComputeRegistry& registry, ComputeCommandBuf
     auto& resolution = giData.m_resolution;
     commandBuffer.ClearColor(giData.m_voxelRadiance, {0, 0, 0, 0}, 0, 1, 0, 1);
     commandBuffer.BeginPipeline(pipeline);
-    commandBuffer.BindDescriptorSet(pipeline, {giData.m_setForLightInject, lightDataSet});
+    commandBuffer.BindDescriptorSet(pipeline, {giData.m_setsForLightInject[frameIndex], lightDataSet});
     commandBuffer.Dispatch(resolution / 8, resolution / 8, resolution / 8);
     commandBuffer.EndPipeline(pipeline);
   }
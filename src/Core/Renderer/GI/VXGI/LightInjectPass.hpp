@@ -7,6 +7,9 @@ namespace Marbas::GI {
 
 struct LightInjectPassCreateInfo {
   RHIFactory* rhiFactory;
+  RenderGraphTextureHandler voxelDiffuse;
+  RenderGraphTextureHandler voxelNormal;
+  RenderGraphTextureHandler voxelRadiance;
 };
 
 class LightInjectPass final {
@@ -26,6 +29,9 @@ class LightInjectPass final {
 
  private:
   RHIFactory* m_rhiFactory = nullptr;
+  RenderGraphTextureHandler m_voxelDiffuse;
+  RenderGraphTextureHandler m_voxelNormal;
+  RenderGraphTextureHandler m_voxelRadiance;
 };
 
 }  // namespace Marbas::GI
@@ -9,15 +9,13 @@ namespace Marbas::GI {
 
 VXGIPass::VXGIPass(const VXGIPassCreateInfo& createInfo)
     : m_rhiFactory(createInfo.m_rhiFactory),
-      m_width(createInfo.m_widht),
-      m_height(createInfo.m_height),
       m_positionRoughnessTexture(createInfo.m_positionRoughnessTexture),
       m_normalMetallicTexture(createInfo.m_normalMetallicTexture),
       m_diffuseTexture(createInfo.m_diffuseTexture),
       m_finalTexture(createInfo.m_finalTexture),
-      m_reflectTexture(createInfo.m_reflectTexture) {
+      m_reflectTexture(createInfo.m_reflectTexture),
+      m_voxelRadiance(createInfo.m_voxelRadiance) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  auto bufCtx = m_rhiFactory->GetBufferContext();
 
   SamplerCreateInfo samplerCreateInfo{
       .filter = Marbas::Filter::MIN_MAG_MIP_LINEAR,
@@ -33,21 +31,29 @@ VXGIPass::VXGIPass(const VXGIPassCreateInfo& createInfo)
   m_sampler = pipelineCtx->CreateSampler(samplerCreateInfo);
 
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
-  m_set = pipelineCtx->CreateDescriptorSet(m_argument);
-
-  m_cameraInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), false);
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_set,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 void
 VXGIPass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+
+  // the camera info is updated every frame, so every frame in flight has its own buffer
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    auto set = pipelineCtx->CreateDescriptorSet(m_argument);
+    auto* cameraInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), false);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraInfoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_sets.push_back(set);
+    m_cameraInfoBuffers.push_back(cameraInfoBuffer);
+  }
+
   // builder.ReadTexture(m_voxelTexture, m_sampler, 0, 1, 0, 8);
   builder.ReadTexture(m_positionRoughnessTexture, m_sampler);
   builder.ReadTexture(m_normalMetallicTexture, m_sampler);
@@ -55,6 +61,10 @@ VXGIPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.WriteTexture(m_finalTexture, TextureAttachmentType::COLOR);
   builder.WriteTexture(m_reflectTexture, TextureAttachmentType::COLOR);
 
+  // the mipmaps of the radiance are generated before it's traced
+  builder.ReadExternalTexture(m_voxelRadiance);
+  builder.WriteExternalTexture(m_voxelRadiance);
+
   DescriptorSetArgument argument;
   argument.Bind(0, DescriptorType::IMAGE);
   argument.Bind(1, DescriptorType::IMAGE);
@@ -84,8 +94,6 @@ VXGIPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.AddShader("Shader/ScreenSpace.vert.spv", ShaderType::VERTEX_SHADER);
   builder.AddShader("Shader/vxgi.frag.spv", ShaderType::FRAGMENT_SHADER);
   builder.EndPipeline();
-
-  builder.SetFramebufferSize(m_width, m_height, 1);
 }
 
 void
@@ -98,21 +106,24 @@ VXGIPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer&
 
   m_cameraInfo.cameraPos = scene->GetEditorCamera()->GetPosition();
   auto bufferCtx = m_rhiFactory->GetBufferContext();
-  bufferCtx->UpdateBuffer(m_cameraInfoBuffer, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufferCtx->UpdateBuffer(m_cameraInfoBuffers[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
+  const auto width = registry.GetFramebufferWidth();
+  const auto height = registry.GetFramebufferHeight();
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
   viewport[0].y = 0;
-  viewport[0].width = m_width;
-  viewport[0].height = m_height;
+  viewport[0].width = width;
+  viewport[0].height = height;
   viewport[0].minDepth = 0;
   viewport[0].maxDepth = 1;
 
   std::array<ScissorInfo, 1> scissor;
   scissor[0].x = 0;
   scissor[0].y = 0;
-  scissor[0].height = m_height;
-  scissor[0].width = m_width;
+  scissor[0].height = height;
+  scissor[0].width = width;
 
   auto giDataView = world.view<VXGIGlobalComponent>();
   auto& giData = world.get<VXGIGlobalComponent>(giDataView[0]);
@@ -123,7 +134,7 @@ VXGIPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer&
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}, {0, 0, 0, 0}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {inputSet, giData.m_set, m_set});
+  commandList.BindDescriptorSet(pipeline, {inputSet, giData.m_sets[frameIndex], m_sets[frameIndex]});
   commandList.Draw(6, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -12,8 +12,7 @@ struct VXGIPassCreateInfo {
   RenderGraphTextureHandler m_diffuseTexture;
   RenderGraphTextureHandler m_finalTexture;
   RenderGraphTextureHandler m_reflectTexture;
-  uint32_t m_widht;
-  uint32_t m_height;
+  RenderGraphTextureHandler m_voxelRadiance;
 };
 
 class VXGIPass {
@@ -31,16 +30,13 @@ class VXGIPass {
   IsEnable(RenderGraphGraphicsRegistry& registry);
 
  private:
-  uint32_t m_width;
-  uint32_t m_height;
-
   struct CameraInfo {
     glm::vec3 cameraPos = glm::vec3(0, 0, 0);
   } m_cameraInfo;
 
   DescriptorSetArgument m_argument;
-  uintptr_t m_set;
-  Buffer* m_cameraInfoBuffer;
+  Vector<uintptr_t> m_sets;  // one descriptor set for each frame in flight
+  Vector<Buffer*> m_cameraInfoBuffers;
 
   RHIFactory* m_rhiFactory;
   uintptr_t m_sampler;
@@ -49,6 +45,7 @@ class VXGIPass {
   RenderGraphTextureHandler m_diffuseTexture;
   RenderGraphTextureHandler m_finalTexture;
   RenderGraphTextureHandler m_reflectTexture;
+  RenderGraphTextureHandler m_voxelRadiance;
 };
 
 }  // namespace Marbas::GI
@@ -14,28 +14,10 @@ VoxelVisulzationPass::VoxelVisulzationPass(const VoxelVisulzationPassCreateInfo&
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
 
   m_voxelInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_voxelInfo, sizeof(m_voxelInfo), false);
-  m_cameraInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(m_cameraInfo), false);
 
   m_argument.Clear();
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
   m_argument.Bind(1, DescriptorType::UNIFORM_BUFFER);
-  m_set = pipelineCtx->CreateDescriptorSet(m_argument);
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_set,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_voxelInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_set,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 1,
-      .buffer = m_cameraInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 
   SamplerCreateInfo samplerCreateInfo{
       .filter = Marbas::Filter::MIN_MAG_MIP_LINEAR,
@@ -53,6 +35,34 @@ VoxelVisulzationPass::VoxelVisulzationPass(const VoxelVisulzationPassCreateInfo&
 
 void
 VoxelVisulzationPass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+
+  // the camera info is updated every frame, so every frame in flight has its own buffer, the voxel info is shared
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    auto* cameraInfoBuffer =
+        bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(m_cameraInfo), false);
+    auto set = pipelineCtx->CreateDescriptorSet(m_argument);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = m_voxelInfoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 1,
+        .buffer = cameraInfoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_cameraInfoBuffers.push_back(cameraInfoBuffer);
+    m_sets.push_back(set);
+  }
+
   builder.ReadTexture(m_voxelTexture, m_sampler);
   builder.WriteTexture(m_resultTexture, TextureAttachmentType::COLOR);
   builder.WriteTexture(m_depthTexture, TextureAttachmentType::DEPTH);
@@ -99,7 +109,8 @@ VoxelVisulzationPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCom
 
   m_cameraInfo.view = camera->GetViewMatrix();
   m_cameraInfo.projection = camera->GetProjectionMatrix();
-  bufferContext->UpdateBuffer(m_cameraInfoBuffer, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufferContext->UpdateBuffer(m_cameraInfoBuffers[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
   /**
    * record command
@@ -126,7 +137,7 @@ VoxelVisulzationPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCom
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}, {1, 1}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {voxelSet, m_set});
+  commandList.BindDescriptorSet(pipeline, {voxelSet, m_sets[frameIndex]});
   commandList.Draw(256 * 256 * 256, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -39,7 +39,7 @@ class VoxelVisulzationPass {
     glm::mat4 view;
     glm::mat4 projection;
   } m_cameraInfo;
-  Buffer* m_cameraInfoBuffer = nullptr;
+  Vector<Buffer*> m_cameraInfoBuffers;  // one buffer for each frame in flight
 
   RenderGraphTextureHandler m_voxelTexture;
   RenderGraphTextureHandler m_resultTexture;
@@ -47,7 +47,7 @@ class VoxelVisulzationPass {
   uintptr_t m_sampler;
 
   DescriptorSetArgument m_argument;
-  uintptr_t m_set;
+  Vector<uintptr_t> m_sets;
 
   RHIFactory* m_rhiFactory;
   uint32_t m_width;
@@ -1,6 +1,7 @@
 #include "VoxelizationPass.hpp"
 
 #include <nameof.hpp>
+#include <optional>
 
 #include "Core/Common.hpp"
 #include "Core/Scene/System/RenderSystemJob/RenderSystem.hpp"
@@ -8,7 +9,10 @@
 namespace Marbas::GI {
 
 VoxelizationPass::VoxelizationPass(const VoxelizationCreateInfo& createInfo)
-    : m_shadowMap(createInfo.shadowMap), m_rhiFactory(createInfo.rhiFactory) {
+    : m_shadowMap(createInfo.shadowMap),
+      m_voxelDiffuse(createInfo.voxelDiffuse),
+      m_voxelNormal(createInfo.voxelNormal),
+      m_rhiFactory(createInfo.rhiFactory) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
   auto bufCtx = m_rhiFactory->GetBufferContext();
 
@@ -37,6 +41,10 @@ void
 VoxelizationPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.ReadTexture(m_shadowMap, m_sampler);
 
+  // the voxel textures are owned by the VoxelRenderComponent, they are only declared to order the voxel passes
+  builder.WriteExternalTexture(m_voxelDiffuse);
+  builder.WriteExternalTexture(m_voxelNormal);
+
   DescriptorSetArgument m_inputGBufferArgument;
   m_inputGBufferArgument.Bind(0, DescriptorType::IMAGE);  // shadow map
 
@@ -72,7 +80,8 @@ VoxelizationPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommand
   DLOG_IF(WARNING, renderLightDataView.size() > 1)
       << FORMAT("multi {} in the scene", NAMEOF_TYPE(LightRenderComponent));
   auto& renderLightData = world.get<LightRenderComponent>(renderLightDataView[0]);
-  auto& lightDataSet = renderLightData.m_lightSet;
+  const auto frameIndex = registry.GetFrameIndex();
+  auto lightDataSet = renderLightData.m_lightSets[frameIndex];
 
   auto giDataView = world.view<VoxelRenderComponent>();
 
@@ -163,26 +172,19 @@ VoxelizationPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommand
     commandBuffer.SetViewports(viewportInfo);
     commandBuffer.SetScissors(scissorInfo);
 
-    auto view = world.view<ModelSceneNode, RenderableTag>();
-    for (auto&& [modelNode, modelNodeComp] : view.each()) {
-      glm::mat4 modelTransform(1.0);
-      if (world.any_of<TransformComp>(modelNode)) {
-        modelTransform = world.get<TransformComp>(modelNode).GetGlobalTransform();
+    std::optional<uint32_t> lastModelIndex;
+    for (const auto& drawItem : userData->view->drawItems) {
+      if (lastModelIndex != drawItem.modelIndex) {
+        commandBuffer.PushConstant(pipeline, drawItem.transform, sizeof(glm::mat4), 0);
+        lastModelIndex = drawItem.modelIndex;
       }
 
-      commandBuffer.PushConstant(pipeline, &modelTransform, sizeof(glm::mat4), 0);
-      for (auto mesh : modelNodeComp.m_meshEntities) {
-        if (!world.any_of<MeshRenderComponent>(mesh)) continue;
-
-        auto& meshRenderComponent = world.get<MeshRenderComponent>(mesh);
-        auto& indexCount = meshRenderComponent.m_indexCount;
-
-        commandBuffer.BindDescriptorSet(
-            pipeline, {set, giData.m_setForVoxelization, meshRenderComponent.m_descriptorSet, lightDataSet});
-        commandBuffer.BindVertexBuffer(meshRenderComponent.m_vertexBuffer);
-        commandBuffer.BindIndexBuffer(meshRenderComponent.m_indexBuffer);
-        commandBuffer.DrawIndexed(meshRenderComponent.m_indexCount, 1, 0, 0, 0);
-      }
+      const auto* meshRenderComponent = drawItem.mesh;
+      const auto meshSet = meshRenderComponent->m_descriptorSets[frameIndex];
+      commandBuffer.BindDescriptorSet(pipeline, {set, giData.m_setsForVoxelization[frameIndex], meshSet, lightDataSet});
+      commandBuffer.BindVertexBuffer(meshRenderComponent->m_vertexBuffer);
+      commandBuffer.BindIndexBuffer(meshRenderComponent->m_indexBuffer);
+      commandBuffer.DrawIndexed(meshRenderComponent->m_indexCount, 1, 0, 0, 0);
     }
     commandBuffer.EndPipeline(pipeline);
   }
@@ -8,6 +8,8 @@ namespace Marbas::GI {
 struct VoxelizationCreateInfo {
   RenderGraphTextureHandler shadowMap;
   // RenderGraphTextureHandler voxelScene;
+  RenderGraphTextureHandler voxelDiffuse;
+  RenderGraphTextureHandler voxelNormal;
   RHIFactory* rhiFactory;
 };
 
@@ -36,6 +38,8 @@ class VoxelizationPass {
 
  private:
   RenderGraphTextureHandler m_shadowMap;
+  RenderGraphTextureHandler m_voxelDiffuse;
+  RenderGraphTextureHandler m_voxelNormal;
 
   // entt::observer m_staticModelAddObserver;
   // entt::observer m_giCreateObserver;
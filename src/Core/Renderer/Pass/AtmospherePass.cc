@@ -2,6 +2,7 @@
 
 #include <glog/logging.h>
 
+#include "Core/Renderer/RenderGraph/RenderGraphHasher.hpp"
 #include "Core/Scene/Component/Component.hpp"
 #include "Core/Scene/System/RenderSystemJob/RenderSystem.hpp"
 
@@ -14,7 +15,6 @@ AtmospherePass::AtmospherePass(const AtmospherePassCreateInfo& createInfo)
       m_transmittanceLUT(createInfo.transmittanceLUT),
       m_multiscatterLUT(createInfo.multiscatterLUT),
       m_finalColorTexture(createInfo.colorTexture) {
-  auto bufCtx = m_rhiFactory->GetBufferContext();
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
 
   SamplerCreateInfo samplerCreateInfo{
@@ -30,34 +30,12 @@ AtmospherePass::AtmospherePass(const AtmospherePassCreateInfo& createInfo)
   };
   m_sampler = pipelineCtx->CreateSampler(samplerCreateInfo);
 
-  m_cameraInfoUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), true);
-  m_atmosphereInfoBuffer =
-      bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_atmosphereInfo, sizeof(AtmosphereInfo), false);
-
   // descriptor set
 
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
   m_argument.Bind(1, DescriptorType::UNIFORM_BUFFER);
   m_inputArgument.Bind(0, DescriptorType::IMAGE);
   m_inputArgument.Bind(1, DescriptorType::IMAGE);
-
-  m_descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraInfoUBO,
-      .offset = 0,
-      .arrayElement = 0,
-  });
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 1,
-      .buffer = m_atmosphereInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 AtmospherePass::~AtmospherePass() {
@@ -67,12 +45,47 @@ AtmospherePass::~AtmospherePass() {
   pipelineCtx->DestroySampler(m_sampler);
   bufCtx->DestroyBuffer(m_vertexBuffer);
   bufCtx->DestroyBuffer(m_indexBuffer);
-  bufCtx->DestroyBuffer(m_cameraInfoUBO);
-  bufCtx->DestroyBuffer(m_atmosphereInfoBuffer);
+  for (auto* cameraInfoUBO : m_cameraInfoUBOs) {
+    bufCtx->DestroyBuffer(cameraInfoUBO);
+  }
+  for (auto* atmosphereInfoBuffer : m_atmosphereInfoBuffers) {
+    bufCtx->DestroyBuffer(atmosphereInfoBuffer);
+  }
 }
 
 void
 AtmospherePass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+
+  // the uniform buffers are updated every frame, so every frame in flight has its own buffers
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    auto* cameraInfoUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), true);
+    auto* atmosphereInfoBuffer =
+        bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_atmosphereInfo, sizeof(AtmosphereInfo), false);
+
+    auto descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraInfoUBO,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 1,
+        .buffer = atmosphereInfoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_cameraInfoUBOs.push_back(cameraInfoUBO);
+    m_atmosphereInfoBuffers.push_back(atmosphereInfoBuffer);
+    m_descriptorSets.push_back(descriptorSet);
+  }
+
   builder.WriteTexture(m_finalColorTexture);
   builder.ReadTexture(m_transmittanceLUT, m_sampler);
   builder.ReadTexture(m_multiscatterLUT, m_sampler);
@@ -118,7 +131,8 @@ AtmospherePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBu
   auto* bufCtx = m_rhiFactory->GetBufferContext();
   m_cameraInfo.view = camera->GetViewMatrix();
   m_cameraInfo.projection = camera->GetProjectionMatrix();
-  bufCtx->UpdateBuffer(m_cameraInfoUBO, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufCtx->UpdateBuffer(m_cameraInfoUBOs[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
   // set atmosphere infomation
   auto sunView = world.view<DirectionLightComponent, SunLightTag>();
@@ -137,7 +151,7 @@ AtmospherePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBu
   m_atmosphereInfo.planetRadius = physicalSky.planetRadius;
   m_atmosphereInfo.ozoneCenterHeight = physicalSky.ozoneCenterHeight;
   m_atmosphereInfo.ozoneWidth = physicalSky.ozoneWidth;
-  bufCtx->UpdateBuffer(m_atmosphereInfoBuffer, &m_atmosphereInfo, sizeof(AtmosphereInfo), 0);
+  bufCtx->UpdateBuffer(m_atmosphereInfoBuffers[frameIndex], &m_atmosphereInfo, sizeof(AtmosphereInfo), 0);
 
   /**
    * record command
@@ -160,7 +174,7 @@ AtmospherePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBu
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}, {1, 1}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {m_descriptorSet, inputSet});
+  commandList.BindDescriptorSet(pipeline, {m_descriptorSets[frameIndex], inputSet});
   commandList.Draw(6, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -184,4 +198,31 @@ AtmospherePass::IsEnable(RenderGraphGraphicsRegistry& registry) {
   return sunView.size_hint() > 0;
 }
 
+uint64_t
+AtmospherePass::GetInputHash(RenderGraphGraphicsRegistry& registry) {
+  const auto* scene = reinterpret_cast<Job::RenderUserData*>(registry.GetUserData())->scene;
+  auto& world = scene->GetWorld();
+  const auto& physicalSky = world.get<EnvironmentComponent>(world.view<EnvironmentComponent>()[0]).physicalSky;
+  const auto& sun = world.get<DirectionLightComponent>(*world.view<DirectionLightComponent, SunLightTag>().begin());
+
+  RenderGraphHasher hasher;
+  auto camera = scene->GetEditorCamera();
+  const auto view = camera->GetViewMatrix();
+  const auto projection = camera->GetProjectionMatrix();
+  hasher.AddBytes(&view, sizeof(view));
+  hasher.AddBytes(&projection, sizeof(projection));
+
+  hasher.AddBytes(&sun.m_direction, sizeof(sun.m_direction));
+  hasher.AddBytes(&sun.m_color, sizeof(sun.m_color));
+  hasher.Add(sun.m_energy);
+  hasher.Add(physicalSky.atmosphereHeight);
+  hasher.Add(physicalSky.rayleighScalarHeight);
+  hasher.Add(physicalSky.mieScalarHeight);
+  hasher.Add(physicalSky.mieAnisotropy);
+  hasher.Add(physicalSky.planetRadius);
+  hasher.Add(physicalSky.ozoneCenterHeight);
+  hasher.Add(physicalSky.ozoneWidth);
+  return hasher.GetHash();
+}
+
 }  // namespace Marbas
@@ -30,6 +30,13 @@ class AtmospherePass final {
   bool
   IsEnable(RenderGraphGraphicsRegistry& registry);
 
+  /**
+   * @brief the sky view only depends on the camera, the sun and the atmosphere parameters, so it isn't drawn again
+   * if none of them is changed
+   */
+  uint64_t
+  GetInputHash(RenderGraphGraphicsRegistry& registry);
+
  private:
   RHIFactory* m_rhiFactory = nullptr;
 
@@ -37,7 +44,7 @@ class AtmospherePass final {
     glm::mat4 view;
     glm::mat4 projection;
   } m_cameraInfo;
-  Buffer* m_cameraInfoUBO = nullptr;
+  Vector<Buffer*> m_cameraInfoUBOs;  // one buffer for each frame in flight
 
   struct AtmosphereInfo {
     // the start point is the sun, and it has beed normalized
@@ -54,11 +61,11 @@ class AtmospherePass final {
     float ozoneCenterHeight = 25000;
     float ozoneWidth = 15000;
   } m_atmosphereInfo;
-  Buffer* m_atmosphereInfoBuffer = nullptr;
+  Vector<Buffer*> m_atmosphereInfoBuffers;
   uintptr_t m_sampler;
 
   DescriptorSetArgument m_argument;
-  uintptr_t m_descriptorSet;
+  Vector<uintptr_t> m_descriptorSets;
   DescriptorSetArgument m_inputArgument;
 
   Buffer* m_vertexBuffer = nullptr;
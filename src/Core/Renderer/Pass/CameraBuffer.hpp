@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Marbas {
+
+/**
+ * @brief the camera uniform buffer shared by the passes through the render graph, it's written by the geometry pass
+ *        every frame and read by the passes after it. The shader can declare a prefix of it.
+ */
+struct CameraBufferInfo {
+  glm::mat4 view;
+  glm::mat4 projection;
+  alignas(16) glm::vec3 right;
+  alignas(16) glm::vec3 up;
+  alignas(16) glm::vec3 pos;
+  float farPlane;
+  float nearPlane;
+};
+
+}  // namespace Marbas
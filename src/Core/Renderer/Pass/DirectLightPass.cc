@@ -9,8 +9,6 @@ namespace Marbas {
 
 DirectLightPass::DirectLightPass(const DirectLightPassCreateInfo& createInfo)
     : m_rhiFactory(createInfo.rhiFactory),
-      m_width(createInfo.width),
-      m_height(createInfo.height),
       m_diffuseTexture(createInfo.diffuseTexture),
       m_normalTexture(createInfo.normalTeture),
       m_positionTexture(createInfo.positionTeture),
@@ -22,7 +20,6 @@ DirectLightPass::DirectLightPass(const DirectLightPassCreateInfo& createInfo)
       m_directionalShadowmap(createInfo.directionalShadowmap),
       m_finalColorTexture(createInfo.finalColorTexture) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  auto bufCtx = m_rhiFactory->GetBufferContext();
 
   SamplerCreateInfo samplerCreateInfo{
       .filter = Marbas::Filter::MIN_MAG_MIP_LINEAR,
@@ -38,20 +35,6 @@ DirectLightPass::DirectLightPass(const DirectLightPassCreateInfo& createInfo)
   m_sampler = pipelineCtx->CreateSampler(samplerCreateInfo);
 
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
-  m_descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
-
-  void* data = &m_cameraInfo;
-  auto size = sizeof(CameraInfo);
-  m_cameraInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, data, size, false);
-
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 DirectLightPass::~DirectLightPass() {
@@ -59,14 +42,39 @@ DirectLightPass::~DirectLightPass() {
   auto bufCtx = m_rhiFactory->GetBufferContext();
 
   pipelineCtx->DestroySampler(m_sampler);
-  pipelineCtx->DestroyDescriptorSet(m_descriptorSet);
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
+  }
 
-  bufCtx->DestroyBuffer(m_cameraInfoBuffer);
+  for (auto* cameraInfoBuffer : m_cameraInfoBuffers) {
+    bufCtx->DestroyBuffer(cameraInfoBuffer);
+  }
 }
 
 void
 DirectLightPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   constexpr int shadowArraySize = DirectionShadowComponent::shadowMapArraySize;
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+
+  // the camera info is updated every frame, so every frame in flight has its own buffer
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    void* data = &m_cameraInfo;
+    auto size = sizeof(CameraInfo);
+    auto* cameraInfoBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, data, size, false);
+    auto descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
+
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraInfoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_cameraInfoBuffers.push_back(cameraInfoBuffer);
+    m_descriptorSets.push_back(descriptorSet);
+  }
 
   builder.ReadTexture(m_diffuseTexture, m_sampler);
   builder.ReadTexture(m_normalTexture, m_sampler);
@@ -77,8 +85,6 @@ DirectLightPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.ReadTexture(m_indirectSpecular, m_sampler);
   builder.WriteTexture(m_finalColorTexture);
 
-  builder.SetFramebufferSize(m_width, m_height, 1);
-
   builder.BeginPipeline();
   builder.EnableDepthTest(false);
   builder.AddColorTarget(ColorTargetDesc{
@@ -119,33 +125,36 @@ DirectLightPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandB
   auto& camera = scene->GetEditorCamera();
   m_cameraInfo.cameraPos = camera->GetPosition();
   m_cameraInfo.cameraView = camera->GetViewMatrix();
-  bufCtx->UpdateBuffer(m_cameraInfoBuffer, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufCtx->UpdateBuffer(m_cameraInfoBuffers[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
+  const auto width = registry.GetFramebufferWidth();
+  const auto height = registry.GetFramebufferHeight();
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
   viewport[0].y = 0;
-  viewport[0].width = m_width;
-  viewport[0].height = m_height;
+  viewport[0].width = width;
+  viewport[0].height = height;
   viewport[0].minDepth = 0;
   viewport[0].maxDepth = 1;
 
   std::array<ScissorInfo, 1> scissor;
   scissor[0].x = 0;
   scissor[0].y = 0;
-  scissor[0].height = m_height;
-  scissor[0].width = m_width;
+  scissor[0].height = height;
+  scissor[0].width = width;
 
   auto renderLightDataView = world.view<LightRenderComponent>();
   DLOG_IF(WARNING, renderLightDataView.size() > 1)
       << FORMAT("multi {} in the scene", NAMEOF_TYPE(LightRenderComponent));
   auto& renderLightData = world.get<LightRenderComponent>(renderLightDataView[0]);
-  auto& lightDataSet = renderLightData.m_lightSet;
+  auto lightDataSet = renderLightData.m_lightSets[frameIndex];
 
   commandList.Begin();
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {inputSet, lightDataSet, m_descriptorSet});
+  commandList.BindDescriptorSet(pipeline, {inputSet, lightDataSet, m_descriptorSets[frameIndex]});
   commandList.Draw(6, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -14,8 +14,6 @@ namespace Marbas {
 
 struct DirectLightPassCreateInfo {
   RHIFactory* rhiFactory;
-  uint32_t width;
-  uint32_t height;
   RenderGraphTextureHandler diffuseTexture;
   RenderGraphTextureHandler normalTeture;
   RenderGraphTextureHandler positionTeture;
@@ -45,18 +43,16 @@ class DirectLightPass {
 
  private:
   RHIFactory* m_rhiFactory;
-  uint32_t m_width;
-  uint32_t m_height;
 
   uintptr_t m_sampler;
   DescriptorSetArgument m_argument;
-  uintptr_t m_descriptorSet;
+  Vector<uintptr_t> m_descriptorSets;  // one descriptor set for each frame in flight
 
   struct CameraInfo {
     glm::vec3 cameraPos;
     alignas(16) glm::mat4 cameraView;
   } m_cameraInfo;
-  Buffer* m_cameraInfoBuffer = nullptr;
+  Vector<Buffer*> m_cameraInfoBuffers;
 
   RenderGraphTextureHandler m_diffuseTexture;
   RenderGraphTextureHandler m_normalTexture;
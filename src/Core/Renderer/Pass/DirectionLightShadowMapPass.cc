@@ -1,6 +1,7 @@
 #include "DirectionLightShadowMapPass.hpp"
 
 #include <nameof.hpp>
+#include <optional>
 
 #include "AssetManager/ModelAsset.hpp"
 #include "Common/MathCommon.hpp"
@@ -53,11 +54,6 @@ DirectionShadowMapPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsC
   auto view = world.view<DirectionLightComponent, DirectionShadowComponent>();
   auto shadowCount = view.size_hint();
 
-  /**
-   * render the scene
-   */
-  auto modelView = world.view<ModelSceneNode, RenderableTag>();
-
   // load all model and calculate the sum of mesh
   auto modelManager = AssetManager<ModelAsset>::GetInstance();
   auto bufferContext = m_rhiFactory->GetBufferContext();
@@ -66,7 +62,7 @@ DirectionShadowMapPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsC
   DLOG_IF(WARNING, renderLightDataView.size() > 1)
       << FORMAT("multi {} in the scene", NAMEOF_TYPE(LightRenderComponent));
   auto& renderLightData = world.get<LightRenderComponent>(renderLightDataView[0]);
-  auto& lightDataSet = renderLightData.m_lightSet;
+  auto lightDataSet = renderLightData.m_lightSets[registry.GetFrameIndex()];
 
   /**
    * Record command
@@ -100,28 +96,23 @@ DirectionShadowMapPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsC
     commandList.SetViewports({&viewportInfo, 1});
     commandList.SetScissors({&scissorInfo, 1});
 
-    for (auto&& [entity, modelSceneNode] : modelView.each()) {
-      glm::mat4 model = glm::mat4(1.0);
-      if (world.any_of<TransformComp>(entity)) {
-        const auto& transformComp = world.get<TransformComp>(entity);
-        model = transformComp.GetGlobalTransform();
+    /**
+     * render the visible models, the transform is pushed once for all the meshes of a model
+     */
+    std::optional<uint32_t> lastModelIndex;
+    for (const auto& drawItem : userData->view->drawItems) {
+      if (lastModelIndex != drawItem.modelIndex) {
+        m_constant.model = *drawItem.transform;
+        commandList.PushConstant(pipeline, &m_constant, sizeof(Constant), 0);
+        lastModelIndex = drawItem.modelIndex;
       }
-      m_constant.model = model;
-
-      commandList.PushConstant(pipeline, &m_constant, sizeof(Constant), 0);
 
-      for (auto mesh : modelSceneNode.m_meshEntities) {
-        if (!world.any_of<MeshRenderComponent>(mesh)) continue;
-
-        auto& meshRenderComponent = world.get<MeshRenderComponent>(mesh);
-        auto& indexCount = meshRenderComponent.m_indexCount;
-
-        std::vector<uintptr_t> sets = {lightDataSet};
-        commandList.BindDescriptorSet(pipeline, sets);
-        commandList.BindVertexBuffer(meshRenderComponent.m_vertexBuffer);
-        commandList.BindIndexBuffer(meshRenderComponent.m_indexBuffer);
-        commandList.DrawIndexed(indexCount, 1, 0, 0, 0);
-      }
+      const auto* meshRenderComponent = drawItem.mesh;
+      std::vector<uintptr_t> sets = {lightDataSet};
+      commandList.BindDescriptorSet(pipeline, sets);
+      commandList.BindVertexBuffer(meshRenderComponent->m_vertexBuffer);
+      commandList.BindIndexBuffer(meshRenderComponent->m_indexBuffer);
+      commandList.DrawIndexed(meshRenderComponent->m_indexCount, 1, 0, 0, 0);
     }
   }
 
@@ -7,37 +7,25 @@
 namespace Marbas {
 
 GridRenderPass::GridRenderPass(const GridRenderPassCreateInfo& createInfo)
-    : m_width(createInfo.width),
-      m_height(createInfo.height),
-      m_rhiFactory(createInfo.rhiFactory),
+    : m_rhiFactory(createInfo.rhiFactory),
       // m_scene(createInfo.scene),
       m_finalColorTexture(createInfo.finalColorTexture),
-      m_finalDepthTexture(createInfo.finalDepthTexture) {
-  auto* bufCtx = m_rhiFactory->GetBufferContext();
-  auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
-  m_cameraInfoUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), false);
-
+      m_finalDepthTexture(createInfo.finalDepthTexture),
+      m_cameraBuffer(createInfo.cameraBuffer) {
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
-  m_descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
-
-  BindBufferInfo bindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraInfoUBO,
-      .offset = 0,
-      .arrayElement = 0,
-  };
-  pipelineCtx->BindBuffer(bindBufferInfo);
-}
-
-GridRenderPass::~GridRenderPass() {
-  auto* bufCtx = m_rhiFactory->GetBufferContext();
-  bufCtx->DestroyBuffer(m_cameraInfoUBO);
 }
 
 void
 GridRenderPass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
+
+  // the camera info is written by the geometry pass, every frame in flight has its own copy
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    m_descriptorSets.push_back(pipelineCtx->CreateDescriptorSet(m_argument));
+    m_boundCameraBuffers.push_back(nullptr);
+  }
+
+  builder.ReadBuffer(m_cameraBuffer);
   builder.WriteTexture(m_finalColorTexture);
   builder.WriteTexture(m_finalDepthTexture, TextureAttachmentType::DEPTH);
 
@@ -67,8 +55,6 @@ GridRenderPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.AddShader("Shader/grid.vert.spv", ShaderType::VERTEX_SHADER);
   builder.AddShader("Shader/grid.frag.spv", ShaderType::FRAGMENT_SHADER);
   builder.EndPipeline();
-
-  builder.SetFramebufferSize(m_width, m_height, 1);
 }
 
 void
@@ -76,42 +62,45 @@ GridRenderPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBu
   auto pipeline = registry.GetPipeline(0);
   auto framebuffer = registry.GetFrameBuffer();
 
-  const auto* scene = reinterpret_cast<Job::RenderUserData*>(registry.GetUserData())->scene;
-
-  // set camera info
-  auto camera = scene->GetEditorCamera();
-  auto* bufCtx = m_rhiFactory->GetBufferContext();
-  m_cameraInfo.up = camera->GetUpVector();
-  m_cameraInfo.m_far = camera->GetFar();
-  m_cameraInfo.m_near = camera->GetNear();
-  m_cameraInfo.pos = camera->GetPosition();
-  m_cameraInfo.view = camera->GetViewMatrix();
-  m_cameraInfo.right = camera->GetRightVector();
-  m_cameraInfo.perspective = camera->GetProjectionMatrix();
-  bufCtx->UpdateBuffer(m_cameraInfoUBO, &m_cameraInfo, sizeof(CameraInfo), 0);
+  // bind the camera info, the buffer is recreated if the graph is compiled again
+  const auto frameIndex = registry.GetFrameIndex();
+  auto* cameraBuffer = registry.GetBuffer(m_cameraBuffer);
+  if (m_boundCameraBuffers[frameIndex] != cameraBuffer) {
+    m_rhiFactory->GetPipelineContext()->BindBuffer(BindBufferInfo{
+        .descriptorSet = m_descriptorSets[frameIndex],
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_boundCameraBuffers[frameIndex] = cameraBuffer;
+  }
 
   /**
    * record command
    */
+  const auto width = registry.GetFramebufferWidth();
+  const auto height = registry.GetFramebufferHeight();
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
   viewport[0].y = 0;
-  viewport[0].width = m_width;
-  viewport[0].height = m_height;
+  viewport[0].width = width;
+  viewport[0].height = height;
   viewport[0].minDepth = 0;
   viewport[0].maxDepth = 1;
 
   std::array<ScissorInfo, 1> scissor;
   scissor[0].x = 0;
   scissor[0].y = 0;
-  scissor[0].height = m_height;
-  scissor[0].width = m_width;
+  scissor[0].height = height;
+  scissor[0].width = width;
 
   commandList.Begin();
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {m_descriptorSet});
+  commandList.BindDescriptorSet(pipeline, {m_descriptorSets[frameIndex]});
   commandList.Draw(6, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/Renderer/Pass/CameraBuffer.hpp"
 #include "Core/Renderer/RenderGraph/RenderGraphBuilder.hpp"
 #include "Core/Renderer/RenderGraph/RenderGraphRegistry.hpp"
 #include "Core/Scene/Scene.hpp"
@@ -8,18 +9,16 @@
 namespace Marbas {
 
 struct GridRenderPassCreateInfo {
-  uint32_t width;
-  uint32_t height;
   // Scene* scene;
   RHIFactory* rhiFactory;
   RenderGraphTextureHandler finalColorTexture;
   RenderGraphTextureHandler finalDepthTexture;
+  RenderGraphBufferHandler cameraBuffer;
 };
 
 class GridRenderPass final {
  public:
   GridRenderPass(const GridRenderPassCreateInfo& createInfo);
-  ~GridRenderPass();
 
   void
   SetUp(RenderGraphGraphicsBuilder& builder);
@@ -35,27 +34,16 @@ class GridRenderPass final {
   }
 
  private:
-  struct CameraInfo {
-    glm::mat4 view;
-    glm::mat4 perspective;
-    alignas(16) glm::vec3 right;
-    alignas(16) glm::vec3 up;
-    alignas(16) glm::vec3 pos;
-    float m_far;
-    float m_near;
-  } m_cameraInfo;
-  Buffer* m_cameraInfoUBO;
-
   DescriptorSetArgument m_argument;
-  uintptr_t m_descriptorSet;
+  Vector<uintptr_t> m_descriptorSets;  // one descriptor set for each frame in flight
+  Vector<Buffer*> m_boundCameraBuffers;
 
-  uint32_t m_width;
-  uint32_t m_height;
   // Scene* m_scene;
   RHIFactory* m_rhiFactory;
 
   RenderGraphTextureHandler m_finalColorTexture;
   RenderGraphTextureHandler m_finalDepthTexture;
+  RenderGraphBufferHandler m_cameraBuffer;
 };
 
 }  // namespace Marbas
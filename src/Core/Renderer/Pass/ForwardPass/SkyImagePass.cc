@@ -51,9 +51,7 @@ SkyImagePass::SkyImagePass(const SkyImagePassCreateInfo& createInfo)
       m_finalColorTexture(createInfo.finalColorTexture),
       m_finalDepthTexture(createInfo.finalDepthTexture),
       // m_scene(createInfo.scene),
-      m_rhiFactory(createInfo.rhiFactory),
-      m_width(createInfo.width),
-      m_height(createInfo.height) {
+      m_rhiFactory(createInfo.rhiFactory) {
   auto bufCtx = m_rhiFactory->GetBufferContext();
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
 
@@ -61,8 +59,6 @@ SkyImagePass::SkyImagePass(const SkyImagePassCreateInfo& createInfo)
   auto indexBufSize = indices.size() * sizeof(uint32_t);
   m_vertexBuffer = bufCtx->CreateBuffer(BufferType::VERTEX_BUFFER, vertices.data(), vertexBufSize, true);
   m_indexBuffer = bufCtx->CreateBuffer(BufferType::INDEX_BUFFER, indices.data(), indexBufSize, true);
-  m_cameraInfoUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), true);
-  m_clearUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_clearInfo, sizeof(ClearValueInfo), true);
 
   SamplerCreateInfo samplerCreateInfo{
       .filter = Marbas::Filter::MIN_MAG_MIP_LINEAR,
@@ -81,24 +77,6 @@ SkyImagePass::SkyImagePass(const SkyImagePassCreateInfo& createInfo)
   m_atmosphereArgument.Bind(0, DescriptorType::IMAGE);
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
   m_argument.Bind(1, DescriptorType::UNIFORM_BUFFER);
-
-  m_descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraInfoUBO,
-      .offset = 0,
-      .arrayElement = 0,
-  });
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 1,
-      .buffer = m_clearUBO,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 SkyImagePass::~SkyImagePass() {
@@ -107,13 +85,49 @@ SkyImagePass::~SkyImagePass() {
 
   bufCtx->DestroyBuffer(m_vertexBuffer);
   bufCtx->DestroyBuffer(m_indexBuffer);
-  bufCtx->DestroyBuffer(m_cameraInfoUBO);
+  for (auto* cameraInfoUBO : m_cameraInfoUBOs) {
+    bufCtx->DestroyBuffer(cameraInfoUBO);
+  }
+  for (auto* clearUBO : m_clearUBOs) {
+    bufCtx->DestroyBuffer(clearUBO);
+  }
   pipelineCtx->DestroySampler(m_sampler);
-  pipelineCtx->DestroyDescriptorSet(m_descriptorSet);
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
+  }
 }
 
 void
 SkyImagePass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+
+  // the uniform buffers are updated every frame, so every frame in flight has its own buffers
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    auto* cameraInfoUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), true);
+    auto* clearUBO = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_clearInfo, sizeof(ClearValueInfo), true);
+    auto descriptorSet = pipelineCtx->CreateDescriptorSet(m_argument);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraInfoUBO,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 1,
+        .buffer = clearUBO,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_cameraInfoUBOs.push_back(cameraInfoUBO);
+    m_clearUBOs.push_back(clearUBO);
+    m_descriptorSets.push_back(descriptorSet);
+  }
+
   builder.ReadTexture(m_atmosphereTexture, m_sampler);
   builder.WriteTexture(m_finalColorTexture);
   builder.WriteTexture(m_finalDepthTexture, TextureAttachmentType::DEPTH);
@@ -143,8 +157,6 @@ SkyImagePass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.AddShaderArgument(m_argument);
   builder.AddShaderArgument(m_atmosphereArgument);
   builder.EndPipeline();
-
-  builder.SetFramebufferSize(m_width, m_height, 1);
 }
 
 void
@@ -167,7 +179,8 @@ SkyImagePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   auto* bufCtx = m_rhiFactory->GetBufferContext();
   m_cameraInfo.view = camera->GetViewMatrix();
   m_cameraInfo.projection = camera->GetProjectionMatrix();
-  bufCtx->UpdateBuffer(m_cameraInfoUBO, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufCtx->UpdateBuffer(m_cameraInfoUBOs[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
   // set clear value
   m_clearInfo.isClear = component.currentItem == EnvironmentComponent::clearValueItem;
@@ -175,7 +188,7 @@ SkyImagePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   m_clearInfo.clearValue[1] = component.clearValueSky.clearValue[1];
   m_clearInfo.clearValue[2] = component.clearValueSky.clearValue[2];
   m_clearInfo.clearValue[3] = component.clearValueSky.clearValue[3];
-  bufCtx->UpdateBuffer(m_clearUBO, &m_clearInfo, sizeof(ClearValueInfo), 0);
+  bufCtx->UpdateBuffer(m_clearUBOs[frameIndex], &m_clearInfo, sizeof(ClearValueInfo), 0);
 
   // bind hdr image
   // FIX: 绑定了image后无法还原
@@ -206,19 +219,21 @@ SkyImagePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   /**
    * record command
    */
+  const auto width = registry.GetFramebufferWidth();
+  const auto height = registry.GetFramebufferHeight();
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
   viewport[0].y = 0;
-  viewport[0].width = m_width;
-  viewport[0].height = m_height;
+  viewport[0].width = width;
+  viewport[0].height = height;
   viewport[0].minDepth = 0;
   viewport[0].maxDepth = 1;
 
   std::array<ScissorInfo, 1> scissor;
   scissor[0].x = 0;
   scissor[0].y = 0;
-  scissor[0].height = m_height;
-  scissor[0].width = m_width;
+  scissor[0].height = height;
+  scissor[0].width = width;
 
   commandList.Begin();
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}, {1, 1}});
@@ -226,7 +241,7 @@ SkyImagePass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   commandList.SetScissors(scissor);
   commandList.BindVertexBuffer(m_vertexBuffer);
   commandList.BindIndexBuffer(m_indexBuffer);
-  commandList.BindDescriptorSet(pipeline, {m_descriptorSet, atmosphereSet});
+  commandList.BindDescriptorSet(pipeline, {m_descriptorSets[frameIndex], atmosphereSet});
   commandList.DrawIndexed(indices.size(), 1, 0, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
@@ -7,8 +7,6 @@
 namespace Marbas {
 
 struct SkyImagePassCreateInfo {
-  uint32_t width;
-  uint32_t height;
   RHIFactory* rhiFactory = nullptr;
   RenderGraphTextureHandler finalColorTexture;
   RenderGraphTextureHandler finalDepthTexture;
@@ -42,17 +40,15 @@ class SkyImagePass final {
 
   DescriptorSetArgument m_atmosphereArgument;
   DescriptorSetArgument m_argument;
-  uintptr_t m_descriptorSet;
+  Vector<uintptr_t> m_descriptorSets;  // one descriptor set for each frame in flight
 
-  Buffer* m_cameraInfoUBO = nullptr;
-  Buffer* m_clearUBO = nullptr;
+  Vector<Buffer*> m_cameraInfoUBOs;
+  Vector<Buffer*> m_clearUBOs;
   Buffer* m_vertexBuffer = nullptr;
   Buffer* m_indexBuffer = nullptr;
   uintptr_t m_sampler;
 
   RHIFactory* m_rhiFactory = nullptr;
-  uint32_t m_width;
-  uint32_t m_height;
   RenderGraphTextureHandler m_finalColorTexture;
   RenderGraphTextureHandler m_finalDepthTexture;
   RenderGraphTextureHandler m_atmosphereTexture;
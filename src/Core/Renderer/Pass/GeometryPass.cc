@@ -3,6 +3,7 @@
 #include <glog/logging.h>
 
 #include <nameof.hpp>
+#include <optional>
 
 #include "AssetManager/ModelAsset.hpp"
 #include "Core/Common.hpp"
@@ -18,9 +19,8 @@ GeometryPass::GeometryPass(const GeometryPassCreateInfo& createInfo)
       m_positionRoughnessTexture(createInfo.positionRoughnessTexture),
       m_depthTexture(createInfo.depthTexture),
       m_colorTexture(createInfo.colorTexture),
-      m_rhiFactory(createInfo.rhiFactory),
-      m_width(createInfo.width),
-      m_height(createInfo.height) {
+      m_cameraBuffer(createInfo.cameraBuffer),
+      m_rhiFactory(createInfo.rhiFactory) {
   auto pipelineContext = m_rhiFactory->GetPipelineContext();
   auto bufferContext = m_rhiFactory->GetBufferContext();
 
@@ -37,10 +37,6 @@ GeometryPass::GeometryPass(const GeometryPassCreateInfo& createInfo)
   };
   m_sampler = pipelineContext->CreateSampler(samplerCreateInfo);
 
-  // create camera matrix buffer
-  constexpr auto cameraBufferSize = sizeof(CameraMatrix);
-  m_cameraBuffer = bufferContext->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraMatrix, cameraBufferSize, false);
-
   // create empty image
   m_emptyImage = bufferContext->CreateImage(ImageCreateInfo{});
   m_emptyImageView = bufferContext->CreateImageView(ImageViewCreateInfo{
@@ -52,21 +48,21 @@ GeometryPass::GeometryPass(const GeometryPassCreateInfo& createInfo)
       .layerCount = 1,
   });
 
-  // create descirptor
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
-  m_descriptorSet = pipelineContext->CreateDescriptorSet(m_argument);
-  pipelineContext->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 void
 GeometryPass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto pipelineContext = m_rhiFactory->GetPipelineContext();
+
+  // the camera buffer is owned by the render graph and every frame in flight has its own copy, so every frame has its
+  // own descriptor set, the buffer is bound when the pass is executed because it's created when the graph compiles
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    m_descriptorSets.push_back(pipelineContext->CreateDescriptorSet(m_argument));
+    m_boundCameraBuffers.push_back(nullptr);
+  }
+
+  builder.WriteBuffer(m_cameraBuffer);
   builder.WriteTexture(m_colorTexture);
   builder.WriteTexture(m_positionRoughnessTexture);
   builder.WriteTexture(m_normalMetallicTexture);
@@ -112,8 +108,6 @@ GeometryPass::SetUp(RenderGraphGraphicsBuilder& builder) {
   builder.AddBlendAttachments({false});
   builder.SetBlendConstant(0, 0, 0, 0);
   builder.EndPipeline();
-
-  builder.SetFramebufferSize(m_width, m_height, 1);
 }
 
 void
@@ -121,7 +115,6 @@ GeometryPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   auto* userData = reinterpret_cast<Job::RenderUserData*>(registry.GetUserData());
   auto* scene = userData->scene;
 
-  auto& world = scene->GetWorld();
   auto camera = scene->GetEditorCamera();
 
   auto* bufferContext = m_rhiFactory->GetBufferContext();
@@ -134,13 +127,28 @@ GeometryPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
    * load all model and calculate the sum of mesh
    */
 
-  // update camera buffer
-  m_cameraMatrix.up = camera->GetUpVector();
-  m_cameraMatrix.pos = camera->GetPosition();
-  m_cameraMatrix.right = camera->GetRightVector();
-  m_cameraMatrix.projection = camera->GetProjectionMatrix();
-  m_cameraMatrix.view = camera->GetViewMatrix();
-  bufferContext->UpdateBuffer(m_cameraBuffer, &m_cameraMatrix, sizeof(CameraMatrix), 0);
+  // update camera buffer, the buffer is recreated if the graph is compiled again, so bind it again when it's changed
+  m_cameraInfo.up = camera->GetUpVector();
+  m_cameraInfo.pos = camera->GetPosition();
+  m_cameraInfo.right = camera->GetRightVector();
+  m_cameraInfo.projection = camera->GetProjectionMatrix();
+  m_cameraInfo.view = camera->GetViewMatrix();
+  m_cameraInfo.farPlane = camera->GetFar();
+  m_cameraInfo.nearPlane = camera->GetNear();
+  const auto frameIndex = registry.GetFrameIndex();
+  auto* cameraBuffer = registry.GetBuffer(m_cameraBuffer);
+  bufferContext->UpdateBuffer(cameraBuffer, &m_cameraInfo, sizeof(CameraBufferInfo), 0);
+  if (m_boundCameraBuffers[frameIndex] != cameraBuffer) {
+    pipelineContext->BindBuffer(BindBufferInfo{
+        .descriptorSet = m_descriptorSets[frameIndex],
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_boundCameraBuffers[frameIndex] = cameraBuffer;
+  }
 
   /**
    * record command
@@ -148,19 +156,21 @@ GeometryPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   auto pipeline = registry.GetPipeline(0);
   auto framebuffer = registry.GetFrameBuffer();
 
+  const auto width = registry.GetFramebufferWidth();
+  const auto height = registry.GetFramebufferHeight();
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
   viewport[0].y = 0;
-  viewport[0].width = m_width;
-  viewport[0].height = m_height;
+  viewport[0].width = width;
+  viewport[0].height = height;
   viewport[0].minDepth = 0;
   viewport[0].maxDepth = 1;
 
   std::array<ScissorInfo, 1> scissor;
   scissor[0].x = 0;
   scissor[0].y = 0;
-  scissor[0].height = m_height;
-  scissor[0].width = m_width;
+  scissor[0].height = height;
+  scissor[0].width = width;
 
   commandList.Begin();
   commandList.BeginPipeline(pipeline, framebuffer,
@@ -173,26 +183,20 @@ GeometryPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuff
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
 
-  auto view = world.view<ModelSceneNode, RenderableTag>();
-  for (auto&& [entity, modelSceneNode] : view.each()) {
-    glm::mat4 model = glm::mat4(1.0);
-    if (world.any_of<TransformComp>(entity)) {
-      const auto& transformComp = world.get<TransformComp>(entity);
-      model = transformComp.GetGlobalTransform();
+  // the transform is pushed once for all the meshes of a model
+  std::optional<uint32_t> lastModelIndex;
+  for (const auto& drawItem : userData->view->drawItems) {
+    if (lastModelIndex != drawItem.modelIndex) {
+      commandList.PushConstant(pipeline, drawItem.transform, sizeof(glm::mat4), 0);
+      lastModelIndex = drawItem.modelIndex;
     }
 
-    commandList.PushConstant(pipeline, &model, sizeof(glm::mat4), 0);
-    for (auto mesh : modelSceneNode.m_meshEntities) {
-      if (!world.any_of<MeshRenderComponent>(mesh)) continue;
-
-      auto& meshRenderComponent = world.get<MeshRenderComponent>(mesh);
-      auto& indexCount = meshRenderComponent.m_indexCount;
-
-      commandList.BindDescriptorSet(pipeline, {meshRenderComponent.m_descriptorSet, m_descriptorSet});
-      commandList.BindVertexBuffer(meshRenderComponent.m_vertexBuffer);
-      commandList.BindIndexBuffer(meshRenderComponent.m_indexBuffer);
-      commandList.DrawIndexed(indexCount, 1, 0, 0, 0);
-    }
+    const auto* meshRenderComponent = drawItem.mesh;
+    const auto meshSet = meshRenderComponent->m_descriptorSets[frameIndex];
+    commandList.BindDescriptorSet(pipeline, {meshSet, m_descriptorSets[frameIndex]});
+    commandList.BindVertexBuffer(meshRenderComponent->m_vertexBuffer);
+    commandList.BindIndexBuffer(meshRenderComponent->m_indexBuffer);
+    commandList.DrawIndexed(meshRenderComponent->m_indexCount, 1, 0, 0, 0);
   }
 
   commandList.EndPipeline(pipeline);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AssetManager/AssetManager.hpp"
+#include "CameraBuffer.hpp"
 #include "Core/Renderer/RenderGraph/RenderGraphBuilder.hpp"
 #include "Core/Renderer/RenderGraph/RenderGraphRegistry.hpp"
 #include "Core/Scene/System/RenderSystemJob/RenderSystem.hpp"
@@ -9,23 +10,16 @@
 namespace Marbas {
 
 struct GeometryPassCreateInfo {
-  uint32_t width;
-  uint32_t height;
   RenderGraphTextureHandler normalMetallicTexture;
   RenderGraphTextureHandler colorTexture;
   RenderGraphTextureHandler positionRoughnessTexture;
   RenderGraphTextureHandler depthTexture;
+  RenderGraphBufferHandler cameraBuffer;
   RHIFactory* rhiFactory;
 };
 
 class GeometryPass {
-  struct CameraMatrix {
-    glm::mat4 view;
-    glm::mat4 projection;
-    alignas(16) glm::vec3 right;
-    alignas(16) glm::vec3 up;
-    alignas(16) glm::vec3 pos;
-  } m_cameraMatrix;
+  CameraBufferInfo m_cameraInfo;
 
  public:
   GeometryPass(const GeometryPassCreateInfo& createInfo);
@@ -49,16 +43,14 @@ class GeometryPass {
   RenderGraphTextureHandler m_colorTexture;
   RenderGraphTextureHandler m_positionRoughnessTexture;
   RenderGraphTextureHandler m_depthTexture;
+  RenderGraphBufferHandler m_cameraBuffer;
   RHIFactory* m_rhiFactory = nullptr;
 
   DescriptorSetArgument m_argument;
-  uintptr_t m_descriptorSet;
-
-  uint32_t m_height = 0;
-  uint32_t m_width = 0;
+  Vector<uintptr_t> m_descriptorSets;  // one descriptor set for each frame in flight
+  Vector<Buffer*> m_boundCameraBuffers;
 
   uintptr_t m_sampler;
-  Buffer* m_cameraBuffer = nullptr;
   Image* m_emptyImage = nullptr;
   ImageView* m_emptyImageView = nullptr;
 };
@@ -14,7 +14,6 @@ SSAOPass::SSAOPass(const SSAOCreateInfo& createInfo)
       m_ssaoTexture(createInfo.ssaoTexture),
       m_rhiFactory(createInfo.rhiFactory) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  auto bufCtx = m_rhiFactory->GetBufferContext();
 
   SamplerCreateInfo samplerCreateInfo{
       .filter = Marbas::Filter::MIN_MAG_MIP_LINEAR,
@@ -28,22 +27,30 @@ SSAOPass::SSAOPass(const SSAOCreateInfo& createInfo)
       .borderColor = Marbas::BorderColor::IntOpaqueBlack,
   };
   m_sampler = pipelineCtx->CreateSampler(samplerCreateInfo);
-
-  m_cameraBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), false);
   m_argument.Bind(0, DescriptorType::UNIFORM_BUFFER);
-  m_set = pipelineCtx->CreateDescriptorSet(m_argument);
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_set,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_cameraBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
 }
 
 void
 SSAOPass::SetUp(RenderGraphGraphicsBuilder& builder) {
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+
+  // the camera info is updated every frame, so every frame in flight has its own buffer
+  for (uint32_t i = 0; i < builder.GetFrameInFlightCount(); i++) {
+    auto* cameraBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &m_cameraInfo, sizeof(CameraInfo), false);
+    auto set = pipelineCtx->CreateDescriptorSet(m_argument);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = cameraBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_cameraBuffers.push_back(cameraBuffer);
+    m_sets.push_back(set);
+  }
+
   builder.ReadTexture(m_posTexture, m_sampler);
   builder.ReadTexture(m_normalTexture, m_sampler);
   builder.ReadTexture(m_depthTexture, m_sampler);
@@ -88,7 +95,8 @@ SSAOPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer&
   m_cameraInfo.m_position = camera->GetPosition();
   m_cameraInfo.m_viewMatrix = camera->GetViewMatrix();
   m_cameraInfo.m_projectMatrix = camera->GetProjectionMatrix();
-  bufCtx->UpdateBuffer(m_cameraBuffer, &m_cameraInfo, sizeof(CameraInfo), 0);
+  const auto frameIndex = registry.GetFrameIndex();
+  bufCtx->UpdateBuffer(m_cameraBuffers[frameIndex], &m_cameraInfo, sizeof(CameraInfo), 0);
 
   std::array<ViewportInfo, 1> viewport;
   viewport[0].x = 0;
@@ -108,7 +116,7 @@ SSAOPass::Execute(RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer&
   commandList.BeginPipeline(pipeline, framebuffer, {{0, 0, 0, 0}});
   commandList.SetViewports(viewport);
   commandList.SetScissors(scissor);
-  commandList.BindDescriptorSet(pipeline, {inputSet, m_set});
+  commandList.BindDescriptorSet(pipeline, {inputSet, m_sets[frameIndex]});
   commandList.Draw(6, 1, 0, 0);
   commandList.EndPipeline(pipeline);
   commandList.End();
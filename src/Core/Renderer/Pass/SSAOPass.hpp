@@ -45,10 +45,10 @@ class SSAOPass {
     alignas(16) glm::mat4 m_viewMatrix;
     alignas(16) glm::mat4 m_projectMatrix;
   } m_cameraInfo;
-  Buffer* m_cameraBuffer = nullptr;
+  Vector<Buffer*> m_cameraBuffers;  // one buffer for each frame in flight
 
   DescriptorSetArgument m_argument;
-  uintptr_t m_set;
+  Vector<uintptr_t> m_sets;
 
   uint32_t m_width;
   uint32_t m_height;
@@ -2,75 +2,1146 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <iterator>
+#include <numeric>
+#include <set>
 
 #include "RenderGraphPass.hpp"
 
 namespace Marbas {
 
+// escape the name in the strings of the DOT and JSON dumps
+static String
+EscapeString(StringView str) {
+  String result;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      default:
+        result += c;
+    }
+  }
+  return result;
+}
+
+static bool
+IsOverlap(const details::ImageDesc& a, const details::ImageDesc& b) {
+  if (a.m_handler.index != b.m_handler.index) return false;
+  auto isRangeOverlap = [](uint32_t aBase, uint32_t aCount, uint32_t bBase, uint32_t bCount) {
+    return aBase < bBase + bCount && bBase < aBase + aCount;
+  };
+  return isRangeOverlap(a.m_baseLayer, a.m_layerCount, b.m_baseLayer, b.m_layerCount) &&
+         isRangeOverlap(a.m_baseLevel, a.m_levelCount, b.m_baseLevel, b.m_levelCount);
+}
+
+void
+RenderGraph::AddGraphOutput(const RenderGraphTextureHandler& handler) {
+  m_graphOutputs.insert(m_resourceManager->m_graphTexture[handler.index].get());
+}
+
+void
+RenderGraph::AddGraphOutput(const RenderGraphBufferHandler& handler) {
+  m_graphOutputs.insert(m_resourceManager->m_graphBuffer[handler.index].get());
+}
+
+bool
+RenderGraph::BuildDependency() {
+  using Node = details::RenderGraphNode;
+  const int passCount = static_cast<int>(m_passes.size());
+
+  m_passDependency.assign(passCount, {});
+  auto addDependency = [&](int from, int to, bool isDataFlow) {
+    if (from == to) return;
+    auto& dependency = m_passDependency[to];
+    auto iter = std::find_if(dependency.begin(), dependency.end(), [&](auto& dep) { return dep.pass == from; });
+    if (iter == dependency.end()) {
+      dependency.push_back({from, isDataFlow});
+    } else {
+      iter->isDataFlow |= isDataFlow;
+    }
+  };
+
+  HashMap<const Node*, int> firstWriter;
+  for (int i = 0; i < passCount; i++) {
+    for (const auto* res : m_passes[i]->GetOutputs()) {
+      firstWriter.try_emplace(res, i);
+    }
+  }
+
+  // walk the passes in the declaration order, the last writer of a resource must run before the pass which reads or
+  // writes it, and the readers must run before the next writer.
+  bool isValid = true;
+  m_lastFrameReads.clear();
+  HashMap<const Node*, int> lastWriter;
+  HashMap<const Node*, Vector<int>> lastReaders;
+  for (int i = 0; i < passCount; i++) {
+    for (const auto* res : m_passes[i]->GetInputs()) {
+      if (auto iter = lastWriter.find(res); iter != lastWriter.end()) {
+        addDependency(iter->second, i, true);
+      } else if (auto iter = firstWriter.find(res); iter != firstWriter.end() && iter->second != i) {
+        // the pass would read the content of the last frame, it's only allowed for the external resource whose
+        // content is kept outside the graph, the other resource must be read by ReadHistoryTexture
+        const auto* resource = dynamic_cast<const details::RenderGraphResource*>(res);
+        if (resource != nullptr && resource->IsExternal()) {
+          m_lastFrameReads.insert(res);
+        } else {
+          LOG(ERROR) << FORMAT("the pass: {} reads the resource: {} before the pass: {} writes it, add the writer "
+                               "first or read the previous frame by a history texture",
+                               m_passes[i]->GetName(), res->GetName(), m_passes[iter->second]->GetName());
+          isValid = false;
+        }
+      }
+      lastReaders[res].push_back(i);
+    }
+
+    for (const auto* res : m_passes[i]->GetOutputs()) {
+      if (auto iter = lastWriter.find(res); iter != lastWriter.end()) {
+        addDependency(iter->second, i, true);
+      }
+      for (int reader : lastReaders[res]) {
+        addDependency(reader, i, false);
+      }
+      lastReaders[res].clear();
+      lastWriter[res] = i;
+    }
+  }
+  return isValid;
+}
+
+void
+RenderGraph::CullPass() {
+  using Node = details::RenderGraphNode;
+  const int passCount = static_cast<int>(m_passes.size());
+
+  HashSet<const Node*> outputs = m_graphOutputs;
+  if (outputs.empty()) {
+    HashSet<const Node*> readResources;
+    for (auto* pass : m_passes) {
+      readResources.insert(pass->GetInputs().begin(), pass->GetInputs().end());
+    }
+    for (auto* pass : m_passes) {
+      for (const auto* res : pass->GetOutputs()) {
+        if (!readResources.contains(res)) outputs.insert(res);
+      }
+    }
+  }
+
+  // the pass which doesn't write any resource may have side effect outside the graph, so never cull it. The history
+  // texture and the external resource read before it's written are read by the next frame, so the pass writing them
+  // is never culled either.
+  auto isRootOutput = [&](const Node* res) {
+    const auto* resource = dynamic_cast<const details::RenderGraphResource*>(res);
+    return outputs.contains(res) || m_lastFrameReads.contains(res) || (resource != nullptr && resource->IsHistory());
+  };
+  Vector<int> stack;
+  m_passCulled.assign(passCount, true);
+  for (int i = 0; i < passCount; i++) {
+    const auto& passOutputs = m_passes[i]->GetOutputs();
+    bool isRoot = passOutputs.empty() || std::any_of(passOutputs.begin(), passOutputs.end(), isRootOutput);
+    if (isRoot) {
+      m_passCulled[i] = false;
+      stack.push_back(i);
+    }
+  }
+
+  while (!stack.empty()) {
+    int pass = stack.back();
+    stack.pop_back();
+    for (const auto& dependency : m_passDependency[pass]) {
+      if (!dependency.isDataFlow || !m_passCulled[dependency.pass]) continue;
+      m_passCulled[dependency.pass] = false;
+      stack.push_back(dependency.pass);
+    }
+  }
+
+  for (int i = 0; i < passCount; i++) {
+    DLOG_IF(INFO, m_passCulled[i]) << FORMAT("cull the pass: {}", m_passes[i]->GetName());
+  }
+}
+
+bool
+RenderGraph::SortPass() {
+  const int passCount = static_cast<int>(m_passes.size());
+
+  Vector<int> inDegree(passCount, 0);
+  Vector<Vector<int>> successors(passCount);
+  for (int i = 0; i < passCount; i++) {
+    for (const auto& dependency : m_passDependency[i]) {
+      successors[dependency.pass].push_back(i);
+      inDegree[i]++;
+    }
+  }
+
+  // Kahn's algorithm, the pass added earlier has the higher priority if there are several ready passes. The passes
+  // without a declared dependency keep the declaration order, because they may still access the same resources
+  // outside the graph, e.g. the images owned by the components.
+  std::set<int> readyPasses;
+  for (int i = 0; i < passCount; i++) {
+    if (inDegree[i] == 0) readyPasses.insert(i);
+  }
+
+  Vector<int> order;
+  while (!readyPasses.empty()) {
+    int pass = *readyPasses.begin();
+    readyPasses.erase(readyPasses.begin());
+    order.push_back(pass);
+    for (int successor : successors[pass]) {
+      if (--inDegree[successor] == 0) readyPasses.insert(successor);
+    }
+  }
+
+  if (order.size() != passCount) {
+    for (int i = 0; i < passCount; i++) {
+      LOG_IF(ERROR, inDegree[i] != 0) << FORMAT("the pass: {} is in a dependency cycle", m_passes[i]->GetName());
+    }
+    return false;
+  }
+
+  m_executePasses.clear();
+  for (int pass : order) {
+    if (m_passCulled[pass]) continue;
+    m_executePasses.push_back(m_passes[pass]);
+  }
+  return true;
+}
+
+void
+RenderGraph::AllocateResource() {
+  using Resource = details::RenderGraphResource;
+  const int passCount = static_cast<int>(m_executePasses.size());
+
+  // the lifetime of the resource is [first pass, last pass] in the execute order
+  struct Lifetime {
+    int first;
+    int last;
+    Vector<int> users;
+  };
+  HashMap<Resource*, Lifetime> lifetimes;
+  Vector<Resource*> resources;
+  auto useResource = [&](details::RenderGraphNode* node, int passIndex) {
+    // the external resource isn't allocated by the graph
+    auto* resource = dynamic_cast<Resource*>(node);
+    if (resource == nullptr || resource->IsExternal()) return;
+    auto [iter, isInsert] = lifetimes.try_emplace(resource, Lifetime{passIndex, passIndex});
+    if (isInsert) {
+      resources.push_back(resource);
+    }
+    iter->second.first = std::min(iter->second.first, passIndex);
+    iter->second.last = std::max(iter->second.last, passIndex);
+    if (iter->second.users.empty() || iter->second.users.back() != passIndex) {
+      iter->second.users.push_back(passIndex);
+    }
+  };
+  for (int i = 0; i < passCount; i++) {
+    for (auto* res : m_executePasses[i]->GetInputs()) useResource(res, i);
+    for (auto* res : m_executePasses[i]->GetOutputs()) useResource(res, i);
+    for (auto* res : m_executePasses[i]->GetHistoryInputs()) useResource(res, i);
+  }
+
+  // the outputs of the amortized pass are read in the frames it's skipped
+  HashSet<Resource*> amortizedOutputs;
+  for (auto* pass : m_executePasses) {
+    if (!pass->IsAmortized()) continue;
+    for (auto* res : pass->GetOutputs()) {
+      if (auto* resource = dynamic_cast<Resource*>(res); resource != nullptr) amortizedOutputs.insert(resource);
+    }
+  }
+
+  // the graph output, the output of the amortized pass and the resource created by other graph are alive in the whole
+  // frame, so don't alias them
+  auto isPersistent = [&](Resource* resource) {
+    bool isCreateByOther = resource->IsCreate() && !m_resourceAllocations.contains(resource);
+    return !resource->IsTransient() || isCreateByOther || m_graphOutputs.contains(resource) ||
+           amortizedOutputs.contains(resource);
+  };
+  for (auto* resource : resources) {
+    if (isPersistent(resource)) {
+      lifetimes[resource].first = 0;
+      lifetimes[resource].last = passCount - 1;
+    }
+  }
+
+  // the persistent resource is shared with the users outside the graph, so it has only one copy. The transient
+  // resource has a copy for every frame in flight. The history resource has one more copy, the frames in flight may
+  // still read the copy written last while the next copy is written.
+  HashMap<Resource*, ResourceAllocation> allocations;
+  for (auto* resource : resources) {
+    if (!isPersistent(resource)) continue;
+    if (!resource->IsCreate() || m_resourceAllocations.contains(resource)) {
+      allocations[resource] = {resource, resource->IsHistory() ? m_fifCount + 1 : 1};
+    }
+  }
+
+  // assign the transient resource to the first compatible owner which is free since the resource is first used, the
+  // owner used by the last compiling is preferred, so the resource isn't changed if the passes using it aren't changed
+  struct AliasSlot {
+    Resource* owner;
+    int last;
+    Vector<int> users;  // the passes using the last resource assigned to the owner
+  };
+  Vector<AliasSlot> slots;
+  Vector<Resource*> transientResources;
+  std::copy_if(resources.begin(), resources.end(), std::back_inserter(transientResources),
+               [&](auto* resource) { return !isPersistent(resource); });
+  std::stable_sort(transientResources.begin(), transientResources.end(),
+                   [&](auto* a, auto* b) { return lifetimes[a].first < lifetimes[b].first; });
+
+  for (auto* resource : transientResources) {
+    const auto& lifetime = lifetimes[resource];
+    auto isFree = [&](const AliasSlot& slot) {
+      return slot.last < lifetime.first && slot.owner->IsAliasCompatible(*resource);
+    };
+    auto iter = slots.end();
+    if (auto lastIter = m_resourceAllocations.find(resource); lastIter != m_resourceAllocations.end()) {
+      iter = std::find_if(slots.begin(), slots.end(),
+                          [&](const AliasSlot& slot) { return slot.owner == lastIter->second.owner && isFree(slot); });
+    }
+    if (iter == slots.end()) {
+      iter = std::find_if(slots.begin(), slots.end(), isFree);
+    }
+
+    if (iter != slots.end()) {
+      allocations[resource] = {iter->owner, m_fifCount};
+      for (int user : iter->users) {
+        AddAliasDependency(user, lifetime.first);
+      }
+      iter->last = lifetime.last;
+      iter->users = lifetime.users;
+      continue;
+    }
+    allocations[resource] = {resource, m_fifCount};
+    slots.push_back({resource, lifetime.last, lifetime.users});
+  }
+
+  // the transient resource which isn't used anymore is released to save the memory, but the persistent resource may
+  // be used outside the graph, so keep it
+  for (auto& [resource, allocation] : m_resourceAllocations) {
+    if (allocations.contains(resource)) continue;
+    if (resource->IsTransient() && !m_graphOutputs.contains(resource)) {
+      resource->Release();
+    } else {
+      allocations[resource] = allocation;
+    }
+  }
+
+  // recreate the resource if its create info or its owner is changed, the resource whose owner is recreated must
+  // alias the new images or buffers
+  auto isChanged = [&](Resource* resource, const ResourceAllocation& allocation) {
+    auto lastIter = m_resourceAllocations.find(resource);
+    return lastIter == m_resourceAllocations.end() || lastIter->second.owner != allocation.owner ||
+           lastIter->second.copyCount != allocation.copyCount || !resource->IsCreate() || resource->IsDirty();
+  };
+  HashSet<Resource*> changedOwners;
+  for (auto& [resource, allocation] : allocations) {
+    if (allocation.owner == resource && isChanged(resource, allocation)) {
+      changedOwners.insert(resource);
+    }
+  }
+  Vector<Resource*> changedAliases;
+  for (auto& [resource, allocation] : allocations) {
+    if (allocation.owner == resource) continue;
+    if (isChanged(resource, allocation) || changedOwners.contains(allocation.owner)) {
+      changedAliases.push_back(resource);
+    }
+  }
+
+  for (auto* resource : changedAliases) resource->Release();
+  for (auto* resource : changedOwners) resource->Release();
+  for (auto* resource : changedOwners) {
+    resource->Create(allocations[resource].copyCount);
+  }
+  for (auto* resource : changedAliases) {
+    auto* owner = allocations[resource].owner;
+    resource->AliasWith(*owner);
+    DLOG(INFO) << FORMAT("alias the resource {} with {}", resource->GetName(), owner->GetName());
+  }
+  m_resourceAllocations = std::move(allocations);
+
+  m_resourceLifetimes.clear();
+  for (auto* resource : resources) {
+    const auto& lifetime = lifetimes[resource];
+    m_resourceLifetimes.push_back({resource, lifetime.first, lifetime.last, isPersistent(resource)});
+  }
+
+  m_historyTextures.clear();
+  for (auto& [resource, allocation] : m_resourceAllocations) {
+    if (!resource->IsHistory()) continue;
+    auto* texture = dynamic_cast<details::RenderGraphTexture*>(resource);
+    if (texture == nullptr) continue;
+    auto& history = m_historyTextures.emplace_back(HistoryTexture{texture});
+    for (int i = 0; i < passCount; i++) {
+      const auto& outputs = m_executePasses[i]->outputs;
+      if (std::find(outputs.begin(), outputs.end(), texture) != outputs.end()) history.writers.push_back(i);
+    }
+  }
+
+  m_memoryReport = {};
+  for (auto& [resource, allocation] : m_resourceAllocations) {
+    if (allocation.owner != resource) continue;
+    m_memoryReport.allocatedBytes += resource->GetByteSize() * allocation.copyCount;
+    if (dynamic_cast<details::RenderGraphBuffer*>(resource) != nullptr) {
+      m_memoryReport.bufferCount += allocation.copyCount;
+    } else {
+      m_memoryReport.imageCount += allocation.copyCount;
+    }
+  }
+
+  for (int i = 0; i < passCount; i++) {
+    uint64_t aliveBytes = 0;
+    for (auto* resource : resources) {
+      const auto& lifetime = lifetimes[resource];
+      if (lifetime.first <= i && i <= lifetime.last) {
+        aliveBytes += resource->GetByteSize();
+      }
+    }
+    m_memoryReport.peakBytes = std::max(m_memoryReport.peakBytes, aliveBytes);
+  }
+
+  for (auto* resource : resources) {
+    m_memoryReport.naiveBytes += resource->GetByteSize();
+    if (dynamic_cast<details::RenderGraphTexture*>(resource) != nullptr) {
+      m_memoryReport.textureCount++;
+    }
+  }
+
+  DLOG(INFO) << FORMAT("render graph memory: naive {} bytes, allocated {} bytes, peak {} bytes, {} images, "
+                       "{} textures, {} buffers",
+                       m_memoryReport.naiveBytes, m_memoryReport.allocatedBytes, m_memoryReport.peakBytes,
+                       m_memoryReport.imageCount, m_memoryReport.textureCount, m_memoryReport.bufferCount);
+}
+
 void
+RenderGraph::AddAliasDependency(int from, int to) {
+  auto fromIter = std::find(m_passes.begin(), m_passes.end(), m_executePasses[from]);
+  auto toIter = std::find(m_passes.begin(), m_passes.end(), m_executePasses[to]);
+  const int fromIndex = static_cast<int>(std::distance(m_passes.begin(), fromIter));
+  auto& dependency = m_passDependency[std::distance(m_passes.begin(), toIter)];
+
+  // the passes using the same memory may run on different queues or overlap on the GPU, so the pass using the memory
+  // first must finish before the next resource is written into it, even if they don't share any resource
+  auto iter = std::find_if(dependency.begin(), dependency.end(), [&](auto& dep) { return dep.pass == fromIndex; });
+  if (iter == dependency.end()) {
+    dependency.push_back({fromIndex, false});
+  }
+}
+
+void
+RenderGraph::InferAttachmentAction() {
+  const int passCount = static_cast<int>(m_executePasses.size());
+
+  Vector<Vector<const details::ImageDesc*>> reads(passCount);
+  Vector<Vector<const details::ImageDesc*>> writes(passCount);
+  for (int i = 0; i < passCount; i++) {
+    m_executePasses[i]->GetTextureAccess(reads[i], writes[i]);
+  }
+
+  auto isAccess = [&](const Vector<Vector<const details::ImageDesc*>>& access, const details::ImageDesc& desc,
+                      int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      for (const auto* other : access[i]) {
+        if (IsOverlap(desc, *other)) return true;
+      }
+    }
+    return false;
+  };
+
+  // the content of the non-transient texture may be used by other graphs or the next frame, so always keep it
+  for (int i = 0; i < passCount; i++) {
+    auto* pass = dynamic_cast<details::RenderGraphGraphicsPass*>(m_executePasses[i]);
+    if (pass == nullptr) continue;
+
+    auto isLoad = [&](const details::ImageDesc& desc) {
+      const auto* texture = m_resourceManager->m_graphTexture[desc.m_handler.index].get();
+      return !texture->IsTransient() || isAccess(writes, desc, 0, i);
+    };
+    auto isStore = [&](const details::ImageDesc& desc) {
+      const auto* texture = m_resourceManager->m_graphTexture[desc.m_handler.index].get();
+      if (!texture->IsTransient() || m_graphOutputs.contains(texture)) return true;
+      return isAccess(reads, desc, i + 1, passCount) || isAccess(writes, desc, i + 1, passCount);
+    };
+    auto isExternal = [&](const details::ImageDesc& desc) {
+      return m_resourceManager->m_graphTexture[desc.m_handler.index]->IsExternal();
+    };
+    pass->UpdateAttachmentAction(isLoad, isStore, isExternal);
+  }
+}
+
+void
+RenderGraph::ReduceDependency() {
+  const int passCount = static_cast<int>(m_executePasses.size());
+
+  HashMap<const details::RenderGraphPass*, int> executeIndex;
+  for (int i = 0; i < passCount; i++) {
+    executeIndex[m_executePasses[i]] = i;
+  }
+
+  // only keep the dependencies which can't be implied by other dependencies. The dependency of a pass is always
+  // executed before it, so visit the nearest one first.
+  Vector<Vector<bool>> isReachable(passCount, Vector<bool>(passCount, false));
+  m_executeDependency.assign(passCount, {});
+  for (int i = 0; i < static_cast<int>(m_passes.size()); i++) {
+    auto iter = executeIndex.find(m_passes[i]);
+    if (iter == executeIndex.end()) continue;
+    const int pass = iter->second;
+
+    Vector<int> dependency;
+    for (const auto& dep : m_passDependency[i]) {
+      auto depIter = executeIndex.find(m_passes[dep.pass]);
+      if (depIter == executeIndex.end() || depIter->second >= pass) continue;
+      dependency.push_back(depIter->second);
+    }
+    std::sort(dependency.begin(), dependency.end(), std::greater<int>());
+    dependency.erase(std::unique(dependency.begin(), dependency.end()), dependency.end());
+
+    for (int dep : dependency) {
+      if (isReachable[pass][dep]) continue;
+      m_executeDependency[pass].push_back(dep);
+      isReachable[pass][dep] = true;
+      for (int j = 0; j < dep; j++) {
+        if (isReachable[dep][j]) isReachable[pass][j] = true;
+      }
+    }
+  }
+}
+
+void
+RenderGraph::PlanSubmit(const Vector<bool>& isEnable, Vector<RenderGraphSubmitBatch>& batches) const {
+  const int passCount = static_cast<int>(m_executePasses.size());
+
+  // the disabled pass passes its dependencies to the passes depending on it
+  Vector<Vector<int>> dependency(passCount);
+  for (int i = 0; i < passCount; i++) {
+    for (int dep : m_executeDependency[i]) {
+      if (isEnable[dep]) {
+        dependency[i].push_back(dep);
+      } else {
+        dependency[i].insert(dependency[i].end(), dependency[dep].begin(), dependency[dep].end());
+      }
+    }
+  }
+
+  // merge the consecutive passes on the same queue into one batch. The submission order doesn't make the commands on
+  // the same queue finish in order or their writes visible, and the RHI can't record the barriers, so a batch waits
+  // for every batch it depends on by a semaphore, even on the same queue. The passes in a batch are recorded into one
+  // command buffer, so they keep the recording order.
+  batches.clear();
+  Vector<int> batchIndex(passCount, -1);
+  Vector<Vector<bool>> isReachable(passCount, Vector<bool>(passCount, false));
+  auto reach = [&](int batch, int waitBatch) {
+    isReachable[batch][waitBatch] = true;
+    for (int i = 0; i < waitBatch; i++) {
+      if (isReachable[waitBatch][i]) isReachable[batch][i] = true;
+    }
+  };
+  auto waitBatches = [&](int batch, Vector<int>& waits) {
+    std::sort(waits.begin(), waits.end(), std::greater<int>());
+    for (int wait : waits) {
+      if (isReachable[batch][wait]) continue;
+      batches[batch].waitBatches.push_back(wait);
+      reach(batch, wait);
+    }
+  };
+
+  for (int i = 0; i < passCount; i++) {
+    if (!isEnable[i]) continue;
+    auto queue = m_executePasses[i]->GetPassType();
+
+    Vector<int> waits;
+    for (int dep : dependency[i]) {
+      waits.push_back(batchIndex[dep]);
+    }
+
+    // the semaphores are waited before the whole batch, so start a new batch if the pass needs to wait for a batch
+    // which the last batch doesn't wait for, then the passes before it can overlap with that batch
+    int batch = static_cast<int>(batches.size()) - 1;
+    bool isMerge = batch >= 0 && batches[batch].queue == queue &&
+                   std::all_of(waits.begin(), waits.end(),
+                               [&](int wait) { return wait == batch || isReachable[batch][wait]; });
+    if (isMerge) {
+      std::erase(waits, batch);
+    } else {
+      batches.push_back({.queue = queue});
+      batch++;
+
+      // only the first batch waits the external semaphore, so the other batches must wait for it
+      if (batch != 0) waits.push_back(0);
+    }
+
+    waitBatches(batch, waits);
+    batches[batch].passes.push_back(i);
+    batchIndex[i] = batch;
+  }
+
+  // only the last batch signals the external semaphore and the fence, so it must wait for all other batches
+  if (!batches.empty()) {
+    Vector<int> waits(batches.size() - 1);
+    std::iota(waits.begin(), waits.end(), 0);
+    waitBatches(static_cast<int>(batches.size()) - 1, waits);
+  }
+}
+
+RenderGraph::SubmitSchedule&
+RenderGraph::GetSubmitSchedule(const Vector<bool>& isEnable) {
+  if (auto iter = m_submitSchedules.find(isEnable); iter != m_submitSchedules.end()) {
+    return iter->second;
+  }
+
+  SubmitSchedule schedule;
+  PlanSubmit(isEnable, schedule.batches);
+
+  // one semaphore for each dependency between the batches, the semaphores of a frame may be still waited by the GPU
+  // when recording the next frame, so don't share them. The schedules use the same semaphores because only one of
+  // them is executed in a frame.
+  const auto batchCount = schedule.batches.size();
+  schedule.waitSemaphores.assign(m_fifCount, Vector<Vector<Semaphore*>>(batchCount));
+  schedule.signalSemaphores.assign(m_fifCount, Vector<Vector<Semaphore*>>(batchCount));
+  m_semaphores.resize(m_fifCount);
+  for (uint32_t frame = 0; frame < m_fifCount; frame++) {
+    auto& semaphores = m_semaphores[frame];
+    size_t semaphoreIndex = 0;
+    for (size_t batch = 0; batch < batchCount; batch++) {
+      for (int waitBatch : schedule.batches[batch].waitBatches) {
+        if (semaphoreIndex == semaphores.size()) {
+          semaphores.push_back(m_rhiFactory->CreateGPUSemaphore());
+        }
+        auto* semaphore = semaphores[semaphoreIndex++];
+        schedule.signalSemaphores[frame][waitBatch].push_back(semaphore);
+        schedule.waitSemaphores[frame][batch].push_back(semaphore);
+      }
+    }
+  }
+  return m_submitSchedules.emplace(isEnable, std::move(schedule)).first->second;
+}
+
+bool
 RenderGraph::Compile() {
-  // create all resource
-  for (auto& res : m_resourceManager->m_graphTexture) {
-    res.Create();
+  using Clock = std::chrono::steady_clock;
+  auto toMilliseconds = [](Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+  const auto compileBegin = Clock::now();
+
+  // the passes aren't executed in a wrong order, nothing is executed until the graph is compiled successfully
+  if (!BuildDependency()) {
+    LOG(ERROR) << "failed to compile the render graph, the dependency between the passes is invalid";
+    ClearCompileResult();
+    return false;
+  }
+  CullPass();
+  if (!SortPass()) {
+    LOG(ERROR) << "failed to compile the render graph, the passes can't be sorted";
+    ClearCompileResult();
+    return false;
   }
 
-  // create render resource for all pass
-  for (auto& pass : m_passes) {
-    pass->Initialize(this);
+  // create the resource used by the passes, the transient textures may share the image
+  AllocateResource();
+  InferAttachmentAction();
+
+  // create render resource for the pass which isn't initialized or whose resources are outdated. Creating pipelines
+  // is the most expensive part, so they are created on the thread pool first, the passes don't depend on each other
+  // in this step.
+  Vector<details::RenderGraphPass*> initializePasses;
+  std::copy_if(m_executePasses.begin(), m_executePasses.end(), std::back_inserter(initializePasses),
+               [](auto* pass) { return pass->NeedInitialize(); });
+  const auto initializeCount = static_cast<uint32_t>(initializePasses.size());
+
+  m_compileReport.passes.assign(initializeCount, {});
+  auto initializePipeline = [&](uint32_t index) {
+    const auto begin = Clock::now();
+    initializePasses[index]->InitializePipeline(this);
+    m_compileReport.passes[index].milliseconds = toMilliseconds(Clock::now() - begin);
+  };
+  if (m_compileThreadPool != nullptr) {
+    m_compileThreadPool->ParallelFor(initializeCount, initializePipeline);
+  } else {
+    for (uint32_t i = 0; i < initializeCount; i++) {
+      initializePipeline(i);
+    }
+  }
+  for (uint32_t i = 0; i < initializeCount; i++) {
+    const auto begin = Clock::now();
+    initializePasses[i]->Initialize(this);
+    m_compileReport.passes[i].name = initializePasses[i]->GetName();
+    m_compileReport.passes[i].milliseconds += toMilliseconds(Clock::now() - begin);
   }
 
-  // create semaphores
-  for (auto* semaphore : m_semaphores) {
-    m_rhiFactory->DestroyGPUSemaphore(semaphore);
+  // plan the submissions of executing all passes and create their semaphores, the other combinations of the enabled
+  // passes are planned when they are executed
+  ReduceDependency();
+  m_budgetCandidates.reserve(m_executePasses.size());
+  m_submitSchedules.clear();
+  m_submitBatches = &GetSubmitSchedule(Vector<bool>(m_executePasses.size(), true)).batches;
+
+  m_compileReport.milliseconds = toMilliseconds(Clock::now() - compileBegin);
+  for (const auto& [name, milliseconds] : m_compileReport.passes) {
+    DLOG(INFO) << FORMAT("initialize the pass {} in {:.3f} ms", name, milliseconds);
   }
-  m_semaphores.clear();
+  DLOG(INFO) << FORMAT("compile render graph successful in {:.3f} ms, initialize {} of {} passes",
+                       m_compileReport.milliseconds, initializeCount, m_executePasses.size());
+  return true;
+}
 
-  for (int i = 0; i < static_cast<int>(m_passes.size()) - 1; i++) {
-    m_semaphores.push_back(m_rhiFactory->CreateGPUSemaphore());
+void
+RenderGraph::RemovePass(StringView passName) {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, won't remove it", passName);
+    return;
   }
 
-  DLOG(INFO) << "compile render graph successful";
+  auto* pass = *iter;
+  auto erasePass = [&](details::RenderGraphNode* res) {
+    std::erase(res->inputs, pass);
+    std::erase(res->outputs, pass);
+  };
+  std::for_each(pass->inputs.begin(), pass->inputs.end(), erasePass);
+  std::for_each(pass->outputs.begin(), pass->outputs.end(), erasePass);
+  m_passes.erase(iter);
+  delete pass;
+
+  // the compiled result refers to the removed pass
+  ClearCompileResult();
 }
 
 void
-RenderGraph::Execute(Semaphore* waitSemaphore, Semaphore* signalSemaphore, Fence* fence, void* userData) {
-  // find all enabled pass
-  std::vector<int> enablePassesIndex;
+RenderGraph::ClearCompileResult() {
+  m_passDependency.clear();
+  m_passCulled.clear();
+  m_lastFrameReads.clear();
+  m_executePasses.clear();
+  m_executeDependency.clear();
+  m_resourceLifetimes.clear();
+  m_historyTextures.clear();
+  m_submitSchedules.clear();
+  m_submitBatches = nullptr;
+}
+
+void
+RenderGraph::InvalidatePass(StringView passName) {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, won't invalidate it", passName);
+    return;
+  }
+  (*iter)->InvalidatePipeline();
+}
+
+void
+RenderGraph::SetPassInputHash(StringView passName, std::function<uint64_t()> func) {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, won't set its input hash", passName);
+    return;
+  }
+  (*iter)->SetInputHashFunc(std::move(func));
+}
+
+RenderGraphPassStatistics
+RenderGraph::GetPassStatistics(StringView passName) const {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, no statistics of it", passName);
+    return {};
+  }
+  return {(*iter)->GetUpdateCount(), (*iter)->GetSkipCount()};
+}
+
+void
+RenderGraph::SetPassUpdatePolicy(StringView passName, const RenderGraphUpdatePolicy& policy) {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, won't set its update policy", passName);
+    return;
+  }
+  (*iter)->SetUpdatePolicy(policy);
+}
+
+Vector<StringView>
+RenderGraph::GetExecuteOrder() const {
+  Vector<StringView> order;
+  for (auto* pass : m_executePasses) {
+    order.push_back(pass->GetName());
+  }
+  return order;
+}
+
+bool
+RenderGraph::IsCulled(StringView passName) const {
   for (int i = 0; i < m_passes.size(); i++) {
-    if (m_passes[i]->IsEnable(this, userData)) {
-      enablePassesIndex.push_back(i);
+    if (m_passes[i]->GetName() == passName) {
+      return i < m_passCulled.size() && m_passCulled[i];
     }
   }
+  return false;
+}
 
-  // prepare the semaphores
-  std::vector<Semaphore*> enablePassSemaphore;
-  int needSemaphoresCount = static_cast<int>(enablePassesIndex.size()) - 1;
-  if (needSemaphoresCount > 0) {
-    enablePassSemaphore = {m_semaphores.begin(), m_semaphores.begin() + needSemaphoresCount};
+Vector<RenderGraphPassTiming>
+RenderGraph::GetPassTimingHistory(StringView passName) const {
+  auto iter = std::find_if(m_passes.begin(), m_passes.end(), [&](auto* pass) { return pass->GetName() == passName; });
+  if (iter == m_passes.end()) {
+    LOG(WARNING) << FORMAT("can't find the pass: {}, no timing of it", passName);
+    return {};
   }
-  enablePassSemaphore.insert(enablePassSemaphore.begin(), waitSemaphore);
-  enablePassSemaphore.insert(enablePassSemaphore.end(), signalSemaphore);
+  return (*iter)->GetTimingHistory();
+}
+
+static const char*
+GetQueueName(PassType type) {
+  return type == PassType::Graphics ? "graphics" : "compute";
+}
 
-  // record the command
-  for (int& enablePass : enablePassesIndex) {
-    m_passes[enablePass]->Execute(this, userData);
+RenderGraph::GraphDump
+RenderGraph::DumpGraph() const {
+  GraphDump dump;
+  Vector<bool> isEnable(m_executePasses.size(), true);
+  Vector<RenderGraphSubmitBatch> batches;
+  PlanSubmit(isEnable, batches);
+
+  for (int i = 0; i < m_passes.size(); i++) {
+    auto& pass = dump.passes.emplace_back(GraphDump::Pass{m_passes[i]});
+    auto orderIter = std::find(m_executePasses.begin(), m_executePasses.end(), m_passes[i]);
+    if (orderIter != m_executePasses.end()) {
+      pass.order = static_cast<int>(std::distance(m_executePasses.begin(), orderIter));
+    }
+    for (int batch = 0; batch < batches.size(); batch++) {
+      if (std::find(batches[batch].passes.begin(), batches[batch].passes.end(), pass.order) !=
+          batches[batch].passes.end()) {
+        pass.batch = batch;
+      }
+    }
+
+    auto addNode = [&](const details::RenderGraphNode* node) {
+      if (dump.nodeIds.try_emplace(node, static_cast<int>(dump.nodes.size())).second) {
+        dump.nodes.push_back(node);
+      }
+    };
+    std::for_each(m_passes[i]->GetInputs().begin(), m_passes[i]->GetInputs().end(), addNode);
+    std::for_each(m_passes[i]->GetHistoryInputs().begin(), m_passes[i]->GetHistoryInputs().end(), addNode);
+    std::for_each(m_passes[i]->GetOutputs().begin(), m_passes[i]->GetOutputs().end(), addNode);
   }
 
-  // execute the command
-  for (int i = 0; i < static_cast<int>(enablePassesIndex.size() - 1); i++) {
-    int currentIndex = enablePassesIndex[i];
-    m_passes[currentIndex]->Submit(enablePassSemaphore[i], enablePassSemaphore[i + 1], nullptr);
+  HashMap<const details::RenderGraphResource*, int> groupIndices;
+  for (int i = 0; i < m_resourceLifetimes.size(); i++) {
+    auto* resource = m_resourceLifetimes[i].resource;
+    dump.lifetimeIndices[resource] = i;
+    auto iter = m_resourceAllocations.find(resource);
+    if (iter == m_resourceAllocations.end()) continue;
+    auto [groupIter, isInsert] = groupIndices.try_emplace(iter->second.owner, dump.aliasGroups.size());
+    if (isInsert) dump.aliasGroups.emplace_back();
+    dump.aliasGroups[groupIter->second].push_back(resource);
   }
+  std::erase_if(dump.aliasGroups, [](const auto& group) { return group.size() < 2; });
+  return dump;
+}
 
-  // execute the last command
-  if (!enablePassesIndex.empty()) {
-    auto index = static_cast<int>(enablePassesIndex.size()) - 1;
-    int currentPass = enablePassesIndex[index];
-    m_passes[currentPass]->Submit(enablePassSemaphore[index], enablePassSemaphore[index + 1], fence);
+String
+RenderGraph::ExportGraphviz() const {
+  auto dump = DumpGraph();
+  String result = "digraph RenderGraph {\n  rankdir=LR;\n";
+
+  // draw the passes in execute order and the culled passes at last, so the layout follows the frame
+  Vector<int> passes(dump.passes.size());
+  std::iota(passes.begin(), passes.end(), 0);
+  std::stable_sort(passes.begin(), passes.end(), [&](int a, int b) {
+    return static_cast<unsigned>(dump.passes[a].order) < static_cast<unsigned>(dump.passes[b].order);
+  });
+  for (int index : passes) {
+    const auto* pass = &dump.passes[index];
+    auto name = EscapeString(pass->pass->GetName());
+    auto queue = GetQueueName(pass->pass->GetPassType());
+    if (pass->order < 0) {
+      result += FORMAT("  pass{} [shape=box, style=dashed, label=\"{}\\n{} culled\"];\n", index, name, queue);
+    } else {
+      result += FORMAT("  pass{} [shape=box, style=bold, label=\"{}\\n#{} {} batch {}\"];\n", index, name,
+                       pass->order, queue, pass->batch);
+    }
+  }
+
+  for (int i = 0; i < dump.nodes.size(); i++) {
+    auto name = EscapeString(dump.nodes[i]->GetName());
+    auto iter = dump.lifetimeIndices.find(dump.nodes[i]);
+    if (iter == dump.lifetimeIndices.end()) {
+      result += FORMAT("  resource{} [shape=ellipse, style=dashed, label=\"{}\"];\n", i, name);
+      continue;
+    }
+    const auto& lifetime = m_resourceLifetimes[iter->second];
+    auto allocationIter = m_resourceAllocations.find(lifetime.resource);
+    uint32_t copyCount = allocationIter == m_resourceAllocations.end() ? 0 : allocationIter->second.copyCount;
+    result += FORMAT("  resource{} [shape=ellipse, label=\"{}\\n{} bytes x{}\\n[{}, {}]{}\"];\n", i, name,
+                     lifetime.resource->GetByteSize(), copyCount, lifetime.first, lifetime.last,
+                     lifetime.isPersistent ? " persistent" : "");
+  }
+
+  for (int i = 0; i < dump.aliasGroups.size(); i++) {
+    result += FORMAT("  subgraph cluster_alias{} {{\n    label=\"alias {}\";\n", i,
+                     EscapeString(dump.aliasGroups[i].front()->GetName()));
+    for (const auto* resource : dump.aliasGroups[i]) {
+      result += FORMAT("    resource{};\n", dump.nodeIds.at(resource));
+    }
+    result += "  }\n";
+  }
+
+  for (int i = 0; i < dump.passes.size(); i++) {
+    const auto* pass = dump.passes[i].pass;
+    for (const auto* node : pass->GetInputs()) {
+      result += FORMAT("  resource{} -> pass{};\n", dump.nodeIds.at(node), i);
+    }
+    for (const auto* node : pass->GetHistoryInputs()) {
+      result += FORMAT("  resource{} -> pass{} [style=dotted];\n", dump.nodeIds.at(node), i);
+    }
+    for (const auto* node : pass->GetOutputs()) {
+      result += FORMAT("  pass{} -> resource{};\n", i, dump.nodeIds.at(node));
+    }
+  }
+  result += "}\n";
+  return result;
+}
+
+String
+RenderGraph::ExportJson() const {
+  auto dump = DumpGraph();
+  auto toJsonList = [](const auto& nodes) {
+    String list;
+    for (const auto* node : nodes) {
+      list += FORMAT("{}\"{}\"", list.empty() ? "" : ", ", EscapeString(node->GetName()));
+    }
+    return FORMAT("[{}]", list);
+  };
+
+  String result = "{\n  \"passes\": [";
+  for (int i = 0; i < dump.passes.size(); i++) {
+    const auto& pass = dump.passes[i];
+    result += FORMAT("{}\n    {{\"name\": \"{}\", \"queue\": \"{}\", \"culled\": {}, \"order\": {}, "
+                     "\"batch\": {}, \"inputs\": {}, \"historyInputs\": {}, \"outputs\": {}}}",
+                     i == 0 ? "" : ",", EscapeString(pass.pass->GetName()), GetQueueName(pass.pass->GetPassType()),
+                     pass.order < 0, pass.order, pass.batch, toJsonList(pass.pass->GetInputs()),
+                     toJsonList(pass.pass->GetHistoryInputs()), toJsonList(pass.pass->GetOutputs()));
+  }
+  result += "\n  ],\n  \"resources\": [";
+  for (int i = 0; i < m_resourceLifetimes.size(); i++) {
+    const auto& lifetime = m_resourceLifetimes[i];
+    const auto* resource = lifetime.resource;
+    bool isTexture = dynamic_cast<const details::RenderGraphTexture*>(resource) != nullptr;
+
+    // the resource created by other graph isn't allocated by this graph, it has no copy and no owner
+    uint32_t copyCount = 0;
+    String owner = "null";
+    if (auto iter = m_resourceAllocations.find(lifetime.resource); iter != m_resourceAllocations.end()) {
+      copyCount = iter->second.copyCount;
+      owner = FORMAT("\"{}\"", EscapeString(iter->second.owner->GetName()));
+    }
+    result += FORMAT("{}\n    {{\"name\": \"{}\", \"type\": \"{}\", \"bytes\": {}, \"copies\": {}, "
+                     "\"first\": {}, \"last\": {}, \"persistent\": {}, \"history\": {}, \"aliasOwner\": {}}}",
+                     i == 0 ? "" : ",", EscapeString(resource->GetName()), isTexture ? "texture" : "buffer",
+                     resource->GetByteSize(), copyCount, lifetime.first, lifetime.last, lifetime.isPersistent,
+                     resource->IsHistory(), owner);
+  }
+  result += "\n  ],\n  \"aliasGroups\": [";
+  for (int i = 0; i < dump.aliasGroups.size(); i++) {
+    result += FORMAT("{}\n    {}", i == 0 ? "" : ",", toJsonList(dump.aliasGroups[i]));
+  }
+  result += FORMAT("\n  ],\n  \"memory\": {{\"naiveBytes\": {}, \"allocatedBytes\": {}, \"peakBytes\": {}, "
+                   "\"textureCount\": {}, \"imageCount\": {}, \"bufferCount\": {}}}\n}}\n",
+                   m_memoryReport.naiveBytes, m_memoryReport.allocatedBytes, m_memoryReport.peakBytes,
+                   m_memoryReport.textureCount, m_memoryReport.imageCount, m_memoryReport.bufferCount);
+  return result;
+}
+
+std::optional<RenderGraphPassTiming>
+RenderGraph::GetAveragePassTiming(StringView passName) const {
+  auto history = GetPassTimingHistory(passName);
+  if (history.empty()) return std::nullopt;
+
+  RenderGraphPassTiming average;
+  for (const auto& timing : history) {
+    average.recordMilliseconds += timing.recordMilliseconds;
+    average.submitMilliseconds += timing.submitMilliseconds;
+  }
+  average.recordMilliseconds /= history.size();
+  average.submitMilliseconds /= history.size();
+  return average;
+}
+
+void
+RenderGraph::Execute(Semaphore* waitSemaphore, Semaphore* signalSemaphore, Fence* fence, void* userData) {
+  const int passCount = static_cast<int>(m_executePasses.size());
+
+  // find all enabled pass, the amortized pass is only enabled in the frames it's due to update
+  const uint64_t frame = m_frameCount++;
+  m_isEnable.assign(passCount, false);
+  m_budgetCandidates.clear();
+  for (int i = 0; i < passCount; i++) {
+    auto* pass = m_executePasses[i];
+    if (!pass->IsEnable(this, userData) || !pass->IsUpdateDue(frame)) continue;
+    if (pass->GetUpdatePolicy().isBudgeted) {
+      m_budgetCandidates.push_back(i);
+    } else {
+      m_isEnable[i] = true;
+    }
+  }
+
+  // the budgeted passes waiting longer are executed first, the first one is always executed so none of them starves
+  std::sort(m_budgetCandidates.begin(), m_budgetCandidates.end(), [&](int a, int b) {
+    return m_executePasses[a]->GetLastUpdateFrame() < m_executePasses[b]->GetLastUpdateFrame();
+  });
+  float budgetCost = 0;
+  for (int pass : m_budgetCandidates) {
+    const auto timing = m_executePasses[pass]->GetAverageTiming();
+    const float cost = timing.recordMilliseconds + timing.submitMilliseconds;
+    const bool isOverBudget = m_updateBudget <= 0 || budgetCost + cost > m_updateBudget;
+    if (pass != m_budgetCandidates.front() && isOverBudget) continue;
+    budgetCost += cost;
+    m_isEnable[pass] = true;
+  }
+
+  // skip the passes whose inputs aren't changed, they are visited in the execute order, so the content of the inputs
+  // written by the passes before them in this frame is already increased
+  for (int i = 0; i < passCount; i++) {
+    if (!m_isEnable[i]) continue;
+    auto* pass = m_executePasses[i];
+    if (pass->HasInputHash() && !pass->IsInputChanged(this, userData)) {
+      m_isEnable[i] = false;
+      continue;
+    }
+    pass->BeginUpdate(frame);
+  }
+
+  // the history texture moves to the next copy only in the frames it's written, so the history of a skipped writer
+  // is still the last frame it has written
+  for (auto& history : m_historyTextures) {
+    const bool isWritten =
+        std::any_of(history.writers.begin(), history.writers.end(), [&](int pass) { return m_isEnable[pass]; });
+    history.texture->AdvanceHistory(isWritten);
+  }
+
+  auto& schedule = GetSubmitSchedule(m_isEnable);
+  const auto& batches = schedule.batches;
+  m_submitBatches = &batches;
+
+  // use the resources of this frame in flight
+  const uint32_t frameIndex = m_frameIndex;
+  m_frameIndex = (m_frameIndex + 1) % m_fifCount;
+  if (batches.empty()) {
+    SubmitSignal(waitSemaphore, signalSemaphore, fence, frameIndex);
+    return;
+  }
+  for (int i = 0; i < passCount; i++) {
+    if (!m_isEnable[i]) continue;
+    m_executePasses[i]->SetFrameIndex(frameIndex);
+    m_executePasses[i]->UpdateHistoryBinding(this);
+  }
+  const int batchCount = static_cast<int>(batches.size());
+
+  // record the command, the passes in a batch are recorded into the command buffer of the first pass. The passes
+  // update and bind the descriptor sets when recording, so they are recorded on the caller thread one by one.
+  using Clock = std::chrono::steady_clock;
+  auto toMilliseconds = [](Clock::duration duration) {
+    return std::chrono::duration<float, std::milli>(duration).count();
+  };
+  m_frameTimings.assign(passCount, {});
+  auto recordBatch = [&](uint32_t batchIndex) {
+    const auto& batch = batches[batchIndex];
+    auto* leader = m_executePasses[batch.passes.front()];
+    auto begin = Clock::now();
+    leader->BeginCommandBuffer();
+    for (int pass : batch.passes) {
+      m_executePasses[pass]->RecordInto(leader);
+      m_executePasses[pass]->Execute(this, userData);
+      if (pass != batch.passes.back()) {
+        auto end = Clock::now();
+        m_frameTimings[pass].recordMilliseconds = toMilliseconds(end - begin);
+        begin = end;
+      }
+    }
+    leader->EndCommandBuffer();
+    m_frameTimings[batch.passes.back()].recordMilliseconds = toMilliseconds(Clock::now() - begin);
+  };
+  for (int batch = 0; batch < batchCount; batch++) {
+    recordBatch(batch);
+  }
+
+  // execute the command, the first batch doesn't wait for the other batches and the last batch isn't waited by the
+  // other batches, so they only use the external semaphores and the frame semaphore
+  auto& waitSemaphores = schedule.waitSemaphores[frameIndex];
+  auto& signalSemaphores = schedule.signalSemaphores[frameIndex];
+  const auto frameWaits = GetFrameWaits(waitSemaphore);
+  const auto frameSignals = GetFrameSignals(signalSemaphore);
+  for (int batch = 0; batch < batchCount; batch++) {
+    std::span<Semaphore*> waits = waitSemaphores[batch];
+    std::span<Semaphore*> signals = signalSemaphores[batch];
+    if (batch == 0) waits = frameWaits;
+    if (batch == batchCount - 1) signals = frameSignals;
+
+    const int leaderIndex = batches[batch].passes.front();
+    auto* leader = m_executePasses[leaderIndex];
+    const auto begin = Clock::now();
+    leader->Submit(waits, signals, batch == batchCount - 1 ? fence : nullptr);
+    m_frameTimings[leaderIndex].submitMilliseconds = toMilliseconds(Clock::now() - begin);
+  }
+
+  for (int i = 0; i < passCount; i++) {
+    if (m_isEnable[i]) m_executePasses[i]->AddTiming(m_frameTimings[i]);
   }
 }
 
+void
+RenderGraph::SubmitSignal(Semaphore* waitSemaphore, Semaphore* signalSemaphore, Fence* fence, uint32_t frameIndex) {
+  if (waitSemaphore == nullptr && signalSemaphore == nullptr && fence == nullptr) return;
+
+  // the caller waits for the signal semaphore and the fence even if no pass is enabled, and the wait semaphore must be
+  // consumed before it's signaled again, so submit an empty command buffer
+  if (m_signalCommandBuffers.empty()) {
+    auto bufCtx = m_rhiFactory->GetBufferContext();
+    for (uint32_t i = 0; i < m_fifCount; i++) {
+      m_signalCommandBuffers.push_back(bufCtx->CreateGraphicsCommandBuffer());
+    }
+  }
+
+  auto* commandBuffer = m_signalCommandBuffers[frameIndex];
+  const auto waits = GetFrameWaits(waitSemaphore);
+  const auto signals = GetFrameSignals(signalSemaphore);
+  commandBuffer->Begin();
+  commandBuffer->End();
+  commandBuffer->Submit(waits, signals, fence);
+}
+
+std::span<Semaphore*>
+RenderGraph::GetFrameWaits(Semaphore* waitSemaphore) {
+  size_t count = 0;
+  if (waitSemaphore != nullptr) m_frameWaits[count++] = waitSemaphore;
+
+  // the frame semaphore is consumed by the wait, so it's only waited once after it's signaled
+  if (m_isFrameSemaphoreSignaled) m_frameWaits[count++] = m_frameSemaphore;
+  m_isFrameSemaphoreSignaled = false;
+  return {m_frameWaits.data(), count};
+}
+
+std::span<Semaphore*>
+RenderGraph::GetFrameSignals(Semaphore* signalSemaphore) {
+  size_t count = 0;
+  if (signalSemaphore != nullptr) m_frameSignals[count++] = signalSemaphore;
+
+  // the caller waits for the fence before reusing the resources of a frame in flight, but the persistent resources
+  // are used by every execution, so the next execution waits for this one on the GPU
+  if (m_fifCount > 1) {
+    m_frameSignals[count++] = m_frameSemaphore;
+    m_isFrameSemaphoreSignaled = true;
+  }
+  return {m_frameSignals.data(), count};
+}
+
 void
 RenderGraph::ExecuteAlone(const StringView& passName, Semaphore* waitSemaphore, Semaphore* signalSemaphore,
                           Fence* fence, void* userData) {
@@ -82,13 +1153,37 @@ RenderGraph::ExecuteAlone(const StringView& passName, Semaphore* waitSemaphore,
 
   auto& pass = *iter;
 
+  if (std::find(m_executePasses.begin(), m_executePasses.end(), pass) == m_executePasses.end()) {
+    LOG(WARNING) << FORMAT("can't run pass: {} because it's culled when compiling", passName);
+    return;
+  }
+
   if (!pass->IsEnable(this, userData)) {
     LOG(WARNING) << FORMAT("can't run pass: {} because IsEnable function of this pass return false", passName);
     return;
   }
 
+  // the resources of the frame left by the last execution may be still used by the GPU, so use the next frame
+  pass->SetFrameIndex(m_frameIndex);
+  m_frameIndex = (m_frameIndex + 1) % m_fifCount;
+
+  using Clock = std::chrono::steady_clock;
+  auto toMilliseconds = [](Clock::duration duration) {
+    return std::chrono::duration<float, std::milli>(duration).count();
+  };
+  RenderGraphPassTiming timing;
+  auto begin = Clock::now();
+  pass->UpdateHistoryBinding(this);
+  pass->RecordInto(pass);
+  pass->BeginCommandBuffer();
   pass->Execute(this, userData);
-  pass->Submit(waitSemaphore, signalSemaphore, fence);
+  pass->EndCommandBuffer();
+  timing.recordMilliseconds = toMilliseconds(Clock::now() - begin);
+
+  begin = Clock::now();
+  pass->Submit(GetFrameWaits(waitSemaphore), GetFrameSignals(signalSemaphore), fence);
+  timing.submitMilliseconds = toMilliseconds(Clock::now() - begin);
+  pass->AddTiming(timing);
 }
 
 }  // namespace Marbas
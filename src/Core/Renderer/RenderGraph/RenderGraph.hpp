@@ -1,12 +1,45 @@
 #pragma once
 
+#include <array>
+
 #include "Common/Common.hpp"
+#include "Common/ThreadPool.hpp"
 #include "RHIFactory.hpp"
 #include "RenderGraphPass.hpp"
 #include "RenderGraphResourceManager.hpp"
 
 namespace Marbas {
 
+struct RenderGraphMemoryReport {
+  uint64_t naiveBytes = 0;      // the bytes if every resource used by the graph owns its memory
+  uint64_t allocatedBytes = 0;  // the bytes of the images and buffers created by the graph after aliasing
+  uint64_t peakBytes = 0;       // the max bytes of the resources alive at the same time in a frame
+  uint32_t textureCount = 0;
+  uint32_t imageCount = 0;
+  uint32_t bufferCount = 0;
+};
+
+struct RenderGraphCompileReport {
+  struct PassTime {
+    String name;
+    double milliseconds = 0;  // the time of creating the pipelines, descriptor sets and framebuffers of the pass
+  };
+
+  Vector<PassTime> passes;  // the passes initialized by the last compiling, in execute order
+  double milliseconds = 0;  // the time of the last compiling
+};
+
+struct RenderGraphPassStatistics {
+  uint64_t executeCount = 0;  // the executions of the pass in RenderGraph::Execute
+  uint64_t skipCount = 0;     // the executions skipped because the inputs of the pass aren't changed
+};
+
+struct RenderGraphSubmitBatch {
+  PassType queue;
+  Vector<int> passes;       // the passes recorded into one command buffer, it's the index of the execute order
+  Vector<int> waitBatches;  // the batches which must finish before this batch, including the ones on the same queue
+};
+
 class RenderGraph final {
  public:
   /**
@@ -14,14 +47,29 @@ class RenderGraph final {
    *
    * @param rhiFactory rhi factory
    * @param resourceManager render graph resource manager
-   * @param fifCount frame in flight count
+   * @param fifCount frame in flight count, every pass has fifCount command buffers and the transient resources have
+   *        fifCount copies, so the CPU can record the next frame while the GPU is executing the previous frames. The
+   *        persistent resources have only one copy, so the executions are still ordered on the GPU.
    */
   RenderGraph(RHIFactory* rhiFactory, std::shared_ptr<RenderGraphResourceManager>& resourceManager, int fifCount = 1)
-      : m_rhiFactory(rhiFactory), m_resourceManager(resourceManager) {}
+      : m_rhiFactory(rhiFactory), m_fifCount(std::max(fifCount, 1)), m_resourceManager(resourceManager) {
+    if (m_fifCount > 1) m_frameSemaphore = m_rhiFactory->CreateGPUSemaphore();
+  }
   ~RenderGraph() {
     for (auto pass : m_passes) {
       delete pass;
     }
+    if (m_fifCount > 1) {
+      m_rhiFactory->DestroyGPUSemaphore(m_frameSemaphore);
+    }
+    for (auto* commandBuffer : m_signalCommandBuffers) {
+      m_rhiFactory->GetBufferContext()->DestroyCommandBuffer(commandBuffer);
+    }
+    for (auto& semaphores : m_semaphores) {
+      for (auto* semaphore : semaphores) {
+        m_rhiFactory->DestroyGPUSemaphore(semaphore);
+      }
+    }
   }
 
  public:
@@ -71,19 +119,204 @@ class RenderGraph final {
 
   void
   ClearAllPass() {
-    for (auto* pass : m_passes) {
-      delete pass;
+    while (!m_passes.empty()) {
+      RemovePass(m_passes.back()->GetName());
     }
-    m_passes.clear();
   }
 
+  /**
+   * @brief remove a pass from the graph, the graph must be compiled again before executing. The GPU resources of the
+   * other passes are kept if they aren't affected.
+   */
   void
+  RemovePass(StringView passName);
+
+  /**
+   * @brief recreate the pipelines of the pass on the next compiling, e.g. its shaders are changed
+   */
+  void
+  InvalidatePass(StringView passName);
+
+  /**
+   * @brief set how often the pass is executed, e.g. every N frames, one slice of its work per frame, or within the
+   * update budget. The outputs of an amortized pass are never aliased, so they are valid in the frames it's skipped.
+   *
+   * @note compile the graph again if the pass becomes amortized, so its outputs are kept between the frames
+   */
+  void
+  SetPassUpdatePolicy(StringView passName, const RenderGraphUpdatePolicy& policy);
+
+  /**
+   * @brief set the input hash of the pass, see details::RenderGraphPass::GetInputHash. The struct pass can provide it
+   * by a GetInputHash method instead.
+   *
+   * @note compile the graph again after setting it, so the outputs of the pass are kept between the frames
+   */
+  void
+  SetPassInputHash(StringView passName, std::function<uint64_t()> func);
+
+  /**
+   * @brief the count of the executions and the skips of the pass
+   */
+  RenderGraphPassStatistics
+  GetPassStatistics(StringView passName) const;
+
+  /**
+   * @brief the CPU time that the budgeted passes may spend in a frame, it's estimated by their average timings. The
+   * budgeted pass waiting the longest is always executed, so every budgeted pass is executed eventually. The default
+   * budget 0 executes one budgeted pass in a frame.
+   */
+  void
+  SetUpdateBudget(float milliseconds) {
+    m_updateBudget = milliseconds;
+  }
+
+  /**
+   * @brief mark a texture as the output of the graph, the texture will be used outside the graph.
+   *
+   * @note If no output is marked, all textures that aren't read by any pass of this graph are treated as the output.
+   *
+   * @param handler texture handler
+   */
+  void
+  AddGraphOutput(const RenderGraphTextureHandler& handler);
+
+  /**
+   * @brief mark the buffer as the output of the graph, it's the same as the texture
+   *
+   * @param handler buffer handler
+   */
+  void
+  AddGraphOutput(const RenderGraphBufferHandler& handler);
+
+  /**
+   * @brief build the dependency between passes from the read/write of the resource, sort the passes
+   * topologically, cull the pass whose outputs aren't used, and create the render resource for the remaining pass
+   *
+   * @note The graph can be compiled again after the passes or the textures are changed. Only the changed textures are
+   * recreated, and only the passes whose pipelines are invalidated or whose textures are recreated are initialized
+   * again. The GPU must not use the graph when compiling.
+   *
+   * @return false if the passes can't be ordered, e.g. a pass reads a resource before the pass writing it is added.
+   * Only the external resource can be read before it's written, the pass reads its content of the last frame. Nothing
+   * is executed until the graph is compiled successfully.
+   */
+  bool
   Compile();
 
+  /**
+   * @brief get the name of the passes in execute order, the culled passes are not included
+   */
+  Vector<StringView>
+  GetExecuteOrder() const;
+
+  bool
+  IsCulled(StringView passName) const;
+
+  /**
+   * @brief get the CPU timings of the last executions of the pass, the oldest one is the first. At most
+   * details::RenderGraphPass::timingHistorySize executions are kept, and the frames the pass is disabled in aren't
+   * included.
+   *
+   * @note the RHI doesn't provide timestamp queries, so the GPU time of the pass isn't measured
+   */
+  Vector<RenderGraphPassTiming>
+  GetPassTimingHistory(StringView passName) const;
+
+  /**
+   * @brief the average of the timing history of the pass, or nullopt if the pass isn't executed
+   */
+  std::optional<RenderGraphPassTiming>
+  GetAveragePassTiming(StringView passName) const;
+
+  /**
+   * @brief the memory used by the textures of the graph in a frame, it's updated on compiling
+   */
+  const RenderGraphMemoryReport&
+  GetMemoryReport() const {
+    return m_memoryReport;
+  }
+
+  /**
+   * @brief the time spent by the last compiling, it's logged after compiling too
+   */
+  const RenderGraphCompileReport&
+  GetCompileReport() const {
+    return m_compileReport;
+  }
+
+  /**
+   * @brief dump the compiled graph as a Graphviz DOT graph. The passes are drawn in execute order and the culled passes
+   * are dashed, the resources aliasing the same memory are grouped into a cluster.
+   *
+   * @note the dump only depends on the passes and the resources, so it can be compared between two builds
+   */
+  String
+  ExportGraphviz() const;
+
+  /**
+   * @brief dump the compiled graph as JSON, it has the pass order, the culled passes, the queue and batch of every
+   * pass, the lifetime, byte size, copy count and alias owner of the resources used by the graph, and the memory
+   * report. The external resources are only listed by the passes. The lifetime is the range of the execute order, the
+   * persistent resource lives in the whole frame.
+   */
+  String
+  ExportJson() const;
+
+  /**
+   * @brief create the pipelines of the passes on the thread pool when compiling, the descriptor sets and framebuffers
+   * are still created on the caller thread.
+   *
+   * @note the RHI must allow different pipelines to be created concurrently
+   *
+   * @param threadPool thread pool, nullptr means creating on the caller thread
+   */
+  void
+  SetCompileThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+    m_compileThreadPool = std::move(threadPool);
+  }
+
+  /**
+   * @brief get the submissions of the last execution, or of executing all passes if the graph isn't executed after
+   * compiling
+   */
+  const Vector<RenderGraphSubmitBatch>&
+  GetSubmitBatches() const {
+    static const Vector<RenderGraphSubmitBatch> empty;
+    return m_submitBatches == nullptr ? empty : *m_submitBatches;
+  }
+
+  uint32_t
+  GetFrameInFlightCount() const {
+    return m_fifCount;
+  }
+
+  /**
+   * @brief the index of the frame in flight used by the next execution
+   */
+  uint32_t
+  GetFrameIndex() const {
+    return m_frameIndex;
+  }
+
+  /**
+   * @brief record and submit the enabled passes. Every execution uses the resources of the next frame in flight, so
+   * the caller must wait for the fence of the execution fifCount times ago before calling it. If there are more frames
+   * in flight, the execution waits for the last one on the GPU, because the persistent resources, e.g. the amortized
+   * outputs and the history textures, are shared by all frames.
+   *
+   * The submissions are planned at the first time a combination of the enabled passes is executed after compiling, the
+   * later executions of the same combination don't allocate memory. If no pass is enabled, an empty command buffer is
+   * submitted to wait the semaphore and signal the semaphore and the fence, so the caller can always wait for them.
+   */
   void
   Execute(Semaphore* waitSemaphore = nullptr, Semaphore* signalSemaphore = nullptr, Fence* fence = nullptr,
           void* userData = nullptr);
 
+  /**
+   * @brief record and submit a pass alone, e.g. a pass executed on demand. It uses the resources of the next frame in
+   * flight like Execute, so the caller must wait for the fence in the same way.
+   */
   void
   ExecuteAlone(const StringView& passName, Semaphore* waitSemaphore = nullptr, Semaphore* signalSemaphore = nullptr,
                Fence* fence = nullptr, void* userData = nullptr);
@@ -93,17 +326,157 @@ class RenderGraph final {
   friend class RenderGraphGraphicsBuilder;
   friend class RenderGraphComputeRegistry;
   friend class RenderGraphComputeBuilder;
+  friend class details::RenderGraphPass;
   friend class details::RenderGraphGraphicsPass;
   friend class details::ImageDesc;
 
+  struct PassDependency {
+    int pass;
+    bool isDataFlow;  // false if it only constrains the order (write after read or reusing the aliased memory)
+  };
+
+  bool
+  BuildDependency();
+
+  void
+  CullPass();
+
+  bool
+  SortPass();
+
+  void
+  AllocateResource();
+
+  void
+  InferAttachmentAction();
+
+  void
+  ReduceDependency();
+
+  /**
+   * @brief order the passes using the same memory by an aliased resource, they are indexed by the execute order
+   */
+  void
+  AddAliasDependency(int from, int to);
+
+  /**
+   * @brief forget the compiled result, e.g. the passes are changed or compiling is failed
+   */
+  void
+  ClearCompileResult();
+
+  /**
+   * @brief the submissions of a combination of the enabled passes and the semaphores between them
+   */
+  struct SubmitSchedule {
+    Vector<RenderGraphSubmitBatch> batches;
+    Vector<Vector<Vector<Semaphore*>>> waitSemaphores;  // indexed by the frame in flight and the batch
+    Vector<Vector<Vector<Semaphore*>>> signalSemaphores;
+  };
+
+  void
+  PlanSubmit(const Vector<bool>& isEnable, Vector<RenderGraphSubmitBatch>& batches) const;
+
+  /**
+   * @brief get the schedule of the enabled passes, it's planned and the semaphores are created if it isn't executed
+   * after compiling
+   */
+  SubmitSchedule&
+  GetSubmitSchedule(const Vector<bool>& isEnable);
+
+  void
+  SubmitSignal(Semaphore* waitSemaphore, Semaphore* signalSemaphore, Fence* fence, uint32_t frameIndex);
+
+  /**
+   * @brief the semaphores waited by the first submission of an execution, it's the external semaphore and the frame
+   * semaphore signaled by the last execution
+   */
+  std::span<Semaphore*>
+  GetFrameWaits(Semaphore* waitSemaphore);
+
+  /**
+   * @brief the semaphores signaled by the last submission of an execution, it's the external semaphore and the frame
+   * semaphore waited by the next execution
+   */
+  std::span<Semaphore*>
+  GetFrameSignals(Semaphore* signalSemaphore);
+
+  /**
+   * @brief the compiled graph shared by the DOT and JSON dumps, it's ordered by the added order of the passes instead
+   * of the address, so the dump is stable between the runs
+   */
+  struct GraphDump {
+    struct Pass {
+      const details::RenderGraphPass* pass;
+      int order = -1;  // the execute order, -1 if the pass is culled
+      int batch = -1;  // the submission of the pass when all passes are enabled
+    };
+
+    Vector<Pass> passes;
+    Vector<const details::RenderGraphNode*> nodes;  // the resources used by the passes in first used order
+    HashMap<const details::RenderGraphNode*, int> nodeIds;
+    HashMap<const details::RenderGraphNode*, int> lifetimeIndices;  // the index of m_resourceLifetimes
+    Vector<Vector<const details::RenderGraphResource*>> aliasGroups;  // the resources sharing the same memory
+  };
+
+  GraphDump
+  DumpGraph() const;
+
   RHIFactory* m_rhiFactory;
 
   Vector<details::RenderGraphPass*> m_passes;
 
-  // the semaphores pool, it means the min semaphore count if you want execute all pass.
-  Vector<Semaphore*> m_semaphores;
+  // the compiled result, all of them are indexed by the index of m_passes except m_executePasses
+  Vector<Vector<PassDependency>> m_passDependency;
+  Vector<bool> m_passCulled;
+  Vector<details::RenderGraphPass*> m_executePasses;
+  Vector<Vector<int>> m_executeDependency;  // the direct dependencies of m_executePasses, indexed by the execute order
+  HashMap<Vector<bool>, SubmitSchedule> m_submitSchedules;          // keyed by whether each execute pass is enabled
+  const Vector<RenderGraphSubmitBatch>* m_submitBatches = nullptr;  // the submissions of the last execution
+  HashSet<const details::RenderGraphNode*> m_graphOutputs;
+  HashSet<const details::RenderGraphNode*> m_lastFrameReads;  // the external resources read before they're written
+
+  // the resources created by this graph and the owner of their images or buffers, it's kept between compiling so the
+  // unchanged resources keep their memory
+  struct ResourceAllocation {
+    details::RenderGraphResource* owner;
+    uint32_t copyCount;
+  };
+  HashMap<details::RenderGraphResource*, ResourceAllocation> m_resourceAllocations;
+  struct ResourceLifetime {
+    details::RenderGraphResource* resource;
+    int first;  // the execute order of the first and the last pass using the resource
+    int last;
+    bool isPersistent;
+  };
+  Vector<ResourceLifetime> m_resourceLifetimes;  // the resources allocated by the last compiling in first used order
+  struct HistoryTexture {
+    details::RenderGraphTexture* texture;
+    Vector<int> writers;  // the execute order of the passes writing the texture
+  };
+  Vector<HistoryTexture> m_historyTextures;  // advanced before every execution in which they are written
+  RenderGraphMemoryReport m_memoryReport;
+  RenderGraphCompileReport m_compileReport;
+  // the states of the current execution, they are kept to reuse the memory
+  Vector<bool> m_isEnable;
+  Vector<RenderGraphPassTiming> m_frameTimings;
+  Vector<int> m_budgetCandidates;  // the budgeted passes which are due to update in the current execution
+
+  float m_updateBudget = 0;
+  uint64_t m_frameCount = 0;  // the count of the executions, the update policies of the passes are based on it
+
+  // the semaphores pool of each frame in flight, one semaphore for each dependency between the batches
+  Vector<Vector<Semaphore*>> m_semaphores;
+  Vector<GraphicsCommandBuffer*> m_signalCommandBuffers;  // the empty submission of each frame in flight
+  Semaphore* m_frameSemaphore = nullptr;  // chain the executions when there are more frames in flight
+  bool m_isFrameSemaphoreSignaled = false;
+  std::array<Semaphore*, 2> m_frameWaits;
+  std::array<Semaphore*, 2> m_frameSignals;
+  uint32_t m_fifCount = 1;
+  uint32_t m_frameIndex = 0;
 
   std::shared_ptr<RenderGraphResourceManager> m_resourceManager;
+  std::shared_ptr<ThreadPool> m_compileThreadPool = nullptr;
 };
 
 }  // namespace Marbas
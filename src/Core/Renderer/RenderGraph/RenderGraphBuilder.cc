@@ -1,5 +1,7 @@
 #include "RenderGraphBuilder.hpp"
 
+#include <glog/logging.h>
+
 #include <fstream>
 
 #include "RenderGraph.hpp"
@@ -9,10 +11,15 @@ namespace Marbas {
 RenderGraphGraphicsBuilder::RenderGraphGraphicsBuilder(details::RenderGraphGraphicsPass* pass, RenderGraph* graph)
     : m_graph(graph), m_pass(pass) {}
 
+uint32_t
+RenderGraphGraphicsBuilder::GetFrameInFlightCount() const {
+  return m_graph->GetFrameInFlightCount();
+}
+
 void
 RenderGraphGraphicsBuilder::WriteTexture(const RenderGraphTextureHandler& handler, TextureAttachmentType type,
                                          int baseLayer, int LayerCount, int baseLevel, int levelCount) {
-  auto& res = m_graph->m_resourceManager->m_graphTexture[handler.index];
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
   res.inputs.push_back(m_pass);
   m_pass->outputs.push_back(&res);
   m_pass->AddSubResDesc(type, handler, baseLayer, LayerCount, baseLevel, levelCount);
@@ -21,7 +28,7 @@ RenderGraphGraphicsBuilder::WriteTexture(const RenderGraphTextureHandler& handle
 void
 RenderGraphGraphicsBuilder::ReadTexture(const RenderGraphTextureHandler& handler, uintptr_t sampler, int baseLayer,
                                         int LayerCount, int baseLevel, int levelCount) {
-  auto& res = m_graph->m_resourceManager->m_graphTexture[handler.index];
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
   res.outputs.push_back(m_pass);
   m_pass->inputs.push_back(&res);
   auto* desc = m_pass->AddInputAttachment<details::CombineImageDesc>();
@@ -36,10 +43,14 @@ RenderGraphGraphicsBuilder::ReadTexture(const RenderGraphTextureHandler& handler
 void
 RenderGraphGraphicsBuilder::ReadStorageImage(const RenderGraphTextureHandler& handler, int baseLayer, int layerCount,
                                              int baseLevel, int levelCount) {
-  auto& res = m_graph->m_resourceManager->m_graphTexture[handler.index];
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
   res.outputs.push_back(m_pass);
   m_pass->inputs.push_back(&res);
 
+  // the storage image can be written in the shader, so it's also an output of the pass
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+
   auto* desc = m_pass->AddInputAttachment<details::StorageImageDesc>();
   desc->m_handler = handler;
   desc->m_baseLayer = baseLayer;
@@ -48,6 +59,60 @@ RenderGraphGraphicsBuilder::ReadStorageImage(const RenderGraphTextureHandler& ha
   desc->m_levelCount = levelCount;
 }
 
+void
+RenderGraphGraphicsBuilder::ReadHistoryTexture(const RenderGraphTextureHandler& handler, uintptr_t sampler,
+                                               int baseLayer, int layerCount, int baseLevel, int levelCount) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  if (!res.IsHistory()) {
+    LOG(ERROR) << FORMAT("the texture: {} isn't a history texture, the pass: {} reads its current frame",
+                         res.GetName(), m_pass->GetName());
+    ReadTexture(handler, sampler, baseLayer, layerCount, baseLevel, levelCount);
+    return;
+  }
+
+  m_pass->AddHistoryInput(&res);
+  auto* desc = m_pass->AddInputAttachment<details::CombineImageDesc>();
+  desc->m_sampler = sampler;
+  desc->m_handler = handler;
+  desc->m_baseLayer = baseLayer;
+  desc->m_baseLevel = baseLevel;
+  desc->m_layerCount = layerCount;
+  desc->m_levelCount = levelCount;
+  desc->m_isHistory = true;
+}
+
+void
+RenderGraphGraphicsBuilder::ReadBuffer(const RenderGraphBufferHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  res.outputs.push_back(m_pass);
+  m_pass->inputs.push_back(&res);
+}
+
+void
+RenderGraphGraphicsBuilder::WriteBuffer(const RenderGraphBufferHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+}
+
+void
+RenderGraphGraphicsBuilder::ReadExternalTexture(const RenderGraphTextureHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  LOG_IF(ERROR, !res.IsExternal()) << FORMAT("the texture: {} read by the pass: {} isn't an external texture",
+                                             res.GetName(), m_pass->GetName());
+  res.outputs.push_back(m_pass);
+  m_pass->inputs.push_back(&res);
+}
+
+void
+RenderGraphGraphicsBuilder::WriteExternalTexture(const RenderGraphTextureHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  LOG_IF(ERROR, !res.IsExternal()) << FORMAT("the texture: {} written by the pass: {} isn't an external texture",
+                                             res.GetName(), m_pass->GetName());
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+}
+
 void
 RenderGraphGraphicsBuilder::SetFramebufferSize(uint32_t width, uint32_t height, uint32_t layer) {
   m_pass->m_framebufferWidth = width;
@@ -68,6 +133,11 @@ RenderGraphComputeBuilder::RenderGraphComputeBuilder(Pass* pass, RenderGraph* gr
 
 RenderGraphComputeBuilder::~RenderGraphComputeBuilder() {}
 
+uint32_t
+RenderGraphComputeBuilder::GetFrameInFlightCount() const {
+  return m_graph->GetFrameInFlightCount();
+}
+
 void
 RenderGraphComputeBuilder::EndPipeline() {
   m_pass->m_pipelineCreateInfos.push_back(m_pipelineCreateInfo);
@@ -76,7 +146,7 @@ RenderGraphComputeBuilder::EndPipeline() {
 void
 RenderGraphComputeBuilder::ReadTexture(const TextureHandler& handler, uintptr_t sampler, int baseLayer, int LayerCount,
                                        int baseLevel, int levelCount) {
-  auto& res = m_graph->m_resourceManager->m_graphTexture[handler.index];
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
   res.outputs.push_back(m_pass);
   m_pass->inputs.push_back(&res);
   auto* desc = m_pass->AddInputAttachment<details::CombineImageDesc>();
@@ -91,10 +161,14 @@ RenderGraphComputeBuilder::ReadTexture(const TextureHandler& handler, uintptr_t
 void
 RenderGraphComputeBuilder::ReadStorageImage(const TextureHandler& handler, int baseLayer, int layerCount, int baseLevel,
                                             int levelCount) {
-  auto& res = m_graph->m_resourceManager->m_graphTexture[handler.index];
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
   res.outputs.push_back(m_pass);
   m_pass->inputs.push_back(&res);
 
+  // the storage image can be written in the shader, so it's also an output of the pass
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+
   auto* desc = m_pass->AddInputAttachment<details::StorageImageDesc>();
   desc->m_handler = handler;
   desc->m_baseLayer = baseLayer;
@@ -103,4 +177,58 @@ RenderGraphComputeBuilder::ReadStorageImage(const TextureHandler& handler, int b
   desc->m_levelCount = levelCount;
 }
 
+void
+RenderGraphComputeBuilder::ReadHistoryTexture(const TextureHandler& handler, uintptr_t sampler, int baseLayer,
+                                              int layerCount, int baseLevel, int levelCount) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  if (!res.IsHistory()) {
+    LOG(ERROR) << FORMAT("the texture: {} isn't a history texture, the pass: {} reads its current frame",
+                         res.GetName(), m_pass->GetName());
+    ReadTexture(handler, sampler, baseLayer, layerCount, baseLevel, levelCount);
+    return;
+  }
+
+  m_pass->AddHistoryInput(&res);
+  auto* desc = m_pass->AddInputAttachment<details::CombineImageDesc>();
+  desc->m_sampler = sampler;
+  desc->m_handler = handler;
+  desc->m_baseLayer = baseLayer;
+  desc->m_baseLevel = baseLevel;
+  desc->m_layerCount = layerCount;
+  desc->m_levelCount = levelCount;
+  desc->m_isHistory = true;
+}
+
+void
+RenderGraphComputeBuilder::ReadBuffer(const RenderGraphBufferHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  res.outputs.push_back(m_pass);
+  m_pass->inputs.push_back(&res);
+}
+
+void
+RenderGraphComputeBuilder::WriteBuffer(const RenderGraphBufferHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+}
+
+void
+RenderGraphComputeBuilder::ReadExternalTexture(const TextureHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  LOG_IF(ERROR, !res.IsExternal()) << FORMAT("the texture: {} read by the pass: {} isn't an external texture",
+                                             res.GetName(), m_pass->GetName());
+  res.outputs.push_back(m_pass);
+  m_pass->inputs.push_back(&res);
+}
+
+void
+RenderGraphComputeBuilder::WriteExternalTexture(const TextureHandler& handler) {
+  auto& res = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  LOG_IF(ERROR, !res.IsExternal()) << FORMAT("the texture: {} written by the pass: {} isn't an external texture",
+                                             res.GetName(), m_pass->GetName());
+  res.inputs.push_back(m_pass);
+  m_pass->outputs.push_back(&res);
+}
+
 }  // namespace Marbas
@@ -23,9 +23,20 @@ class RenderGraphGraphicsBuilder final {
   RenderGraphGraphicsBuilder(details::RenderGraphGraphicsPass* pass, RenderGraph* graph);
   virtual ~RenderGraphGraphicsBuilder() = default;
 
+  /**
+   * @brief set the size of the framebuffer, the pass whose render targets are sized relative to the output extent
+   * shouldn't call it, then the framebuffer follows the size of the first render target
+   */
   void
   SetFramebufferSize(uint32_t width, uint32_t height, uint32_t layer);
 
+  /**
+   * @brief the count of the frames in flight, the buffer updated by the pass every frame needs a copy for each frame
+   * in flight, see RenderGraphGraphicsRegistry::GetFrameIndex
+   */
+  uint32_t
+  GetFrameInFlightCount() const;
+
   void
   WriteTexture(const RenderGraphTextureHandler& handler, TextureAttachmentType type = TextureAttachmentType::COLOR,
                int baseLayer = 0, int LayerCount = 1, int baseLevel = 0, int levelCount = 1);
@@ -38,6 +49,44 @@ class RenderGraphGraphicsBuilder final {
   ReadStorageImage(const RenderGraphTextureHandler& handler, int baseLayer = 0, int layerCount = 1, int baseLevel = 0,
                    int levelCount = 1);
 
+  /**
+   * @brief read the content of the previous frame of a texture created by
+   * RenderGraphResourceManager::CreateHistoryTexture. It doesn't wait for the pass writing the texture in the current
+   * frame, so a pass can read the history and write the current frame, e.g. the accumulation of TAA. Use
+   * RenderGraphGraphicsRegistry::IsHistoryValid to find out whether the history can be used.
+   */
+  void
+  ReadHistoryTexture(const RenderGraphTextureHandler& handler, uintptr_t sampler, int baseLayer = 0, int layerCount = 1,
+                     int baseLevel = 0, int levelCount = 1);
+
+  /**
+   * @brief the pass reads the buffer, it gets the buffer by RenderGraphGraphicsRegistry::GetBuffer when executing
+   */
+  void
+  ReadBuffer(const RenderGraphBufferHandler& handler);
+
+  /**
+   * @brief the pass writes the buffer, e.g. updates it or writes it in the shader, so the passes reading the buffer
+   * are executed after this pass
+   */
+  void
+  WriteBuffer(const RenderGraphBufferHandler& handler);
+
+  /**
+   * @brief the pass reads the images imported by RenderGraphResourceManager::AddExternalTexture through its own
+   * descriptor sets, e.g. the images owned by a component. The graph doesn't bind the texture, it only executes the
+   * pass after the passes writing it.
+   */
+  void
+  ReadExternalTexture(const RenderGraphTextureHandler& handler);
+
+  /**
+   * @brief the pass writes the images of the external texture through its own descriptor sets or commands, so the
+   * passes reading the texture are executed after this pass
+   */
+  void
+  WriteExternalTexture(const RenderGraphTextureHandler& handler);
+
   void
   BeginPipeline() {
     m_pipelineCreateInfo = {};
@@ -146,6 +195,9 @@ class RenderGraphComputeBuilder final {
   ~RenderGraphComputeBuilder();
 
  public:
+  uint32_t
+  GetFrameInFlightCount() const;
+
   void
   ReadTexture(const TextureHandler& handler, uintptr_t sampler, int baseLayer = 0, int layerCount = 1,
               int baseLevel = 0, int levelCount = 1);
@@ -154,6 +206,37 @@ class RenderGraphComputeBuilder final {
   ReadStorageImage(const TextureHandler& handler, int baseLayer = 0, int layerCount = 1, int baseLevel = 0,
                    int levelCount = 1);
 
+  /**
+   * @brief see RenderGraphGraphicsBuilder::ReadHistoryTexture
+   */
+  void
+  ReadHistoryTexture(const TextureHandler& handler, uintptr_t sampler, int baseLayer = 0, int layerCount = 1,
+                     int baseLevel = 0, int levelCount = 1);
+
+  /**
+   * @brief see RenderGraphGraphicsBuilder::ReadBuffer
+   */
+  void
+  ReadBuffer(const RenderGraphBufferHandler& handler);
+
+  /**
+   * @brief see RenderGraphGraphicsBuilder::WriteBuffer
+   */
+  void
+  WriteBuffer(const RenderGraphBufferHandler& handler);
+
+  /**
+   * @brief see RenderGraphGraphicsBuilder::ReadExternalTexture
+   */
+  void
+  ReadExternalTexture(const TextureHandler& handler);
+
+  /**
+   * @brief see RenderGraphGraphicsBuilder::WriteExternalTexture
+   */
+  void
+  WriteExternalTexture(const TextureHandler& handler);
+
   void
   AddShaderArgument(const DescriptorSetArgument& argument) {
     m_pipelineCreateInfo.layout.push_back(argument);
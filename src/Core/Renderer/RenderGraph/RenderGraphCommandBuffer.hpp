@@ -0,0 +1,152 @@
+#pragma once
+
+#include <glog/logging.h>
+
+#include "RHIFactory.hpp"
+
+namespace Marbas::details {
+
+/**
+ * @brief The command buffer used by the passes to record the commands.
+ *
+ * The passes submitted in one batch record the commands into the same command buffer, which is began, ended and
+ * submitted by the render graph, so Begin, End and Submit called by the pass are ignored.
+ */
+class RenderGraphGraphicsCommandBuffer final : public GraphicsCommandBuffer {
+ public:
+  void
+  SetCommandBuffer(GraphicsCommandBuffer* commandBuffer) {
+    m_commandBuffer = commandBuffer;
+  }
+
+  void
+  Begin() override {}
+
+  void
+  End() override {}
+
+  void
+  Submit(std::span<Semaphore*> waitSemaphores, std::span<Semaphore*> signalSemaphores, Fence* fence) override {
+    LOG(WARNING) << "the command buffer of the render graph pass is submitted by the render graph";
+  }
+
+  void
+  BeginPipeline(uintptr_t pipeline, FrameBuffer* frameBuffer, const std::vector<ClearValue>& clearValues) override {
+    m_commandBuffer->BeginPipeline(pipeline, frameBuffer, clearValues);
+  }
+
+  void
+  EndPipeline(uintptr_t pipeline) override {
+    m_commandBuffer->EndPipeline(pipeline);
+  }
+
+  void
+  BindDescriptorSet(uintptr_t pipeline, const std::vector<uintptr_t>& descriptorSets) override {
+    m_commandBuffer->BindDescriptorSet(pipeline, descriptorSets);
+  }
+
+  void
+  PushConstant(uintptr_t pipeline, const void* data, uint32_t size, uint32_t offset) override {
+    m_commandBuffer->PushConstant(pipeline, data, size, offset);
+  }
+
+  void
+  SetViewports(std::span<ViewportInfo> viewportInfos) override {
+    m_commandBuffer->SetViewports(viewportInfos);
+  }
+
+  void
+  SetScissors(std::span<ScissorInfo> scissorInfos) override {
+    m_commandBuffer->SetScissors(scissorInfos);
+  }
+
+  void
+  SetCullMode(CullMode cullMode) override {
+    m_commandBuffer->SetCullMode(cullMode);
+  }
+
+  void
+  BindVertexBuffer(Buffer* buffer) override {
+    m_commandBuffer->BindVertexBuffer(buffer);
+  }
+
+  void
+  BindIndexBuffer(Buffer* buffer) override {
+    m_commandBuffer->BindIndexBuffer(buffer);
+  }
+
+  void
+  Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override {
+    m_commandBuffer->Draw(vertexCount, instanceCount, firstVertex, firstInstance);
+  }
+
+  void
+  DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset,
+              uint32_t firstInstance) override {
+    m_commandBuffer->DrawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+  }
+
+  void
+  GenerateMipmap(Image* image, uint32_t mipLevels) override {
+    m_commandBuffer->GenerateMipmap(image, mipLevels);
+  }
+
+  void
+  ClearColor(Image* image, const ClearValue& clearValue, int baseLayer, int layerCount, int baseLevel,
+             int levelCount) override {
+    m_commandBuffer->ClearColor(image, clearValue, baseLayer, layerCount, baseLevel, levelCount);
+  }
+
+ private:
+  GraphicsCommandBuffer* m_commandBuffer = nullptr;
+};
+
+class RenderGraphComputeCommandBuffer final : public ComputeCommandBuffer {
+ public:
+  void
+  SetCommandBuffer(ComputeCommandBuffer* commandBuffer) {
+    m_commandBuffer = commandBuffer;
+  }
+
+  void
+  Begin() override {}
+
+  void
+  End() override {}
+
+  void
+  Submit(std::span<Semaphore*> waitSemaphores, std::span<Semaphore*> signalSemaphores, Fence* fence) override {
+    LOG(WARNING) << "the command buffer of the render graph pass is submitted by the render graph";
+  }
+
+  void
+  BeginPipeline(uintptr_t pipeline) override {
+    m_commandBuffer->BeginPipeline(pipeline);
+  }
+
+  void
+  EndPipeline(uintptr_t pipeline) override {
+    m_commandBuffer->EndPipeline(pipeline);
+  }
+
+  void
+  BindDescriptorSet(uintptr_t pipeline, const std::vector<uintptr_t>& descriptorSets) override {
+    m_commandBuffer->BindDescriptorSet(pipeline, descriptorSets);
+  }
+
+  void
+  ClearColor(Image* image, const ClearValue& clearValue, int baseLayer, int layerCount, int baseLevel,
+             int levelCount) override {
+    m_commandBuffer->ClearColor(image, clearValue, baseLayer, layerCount, baseLevel, levelCount);
+  }
+
+  void
+  Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override {
+    m_commandBuffer->Dispatch(groupCountX, groupCountY, groupCountZ);
+  }
+
+ private:
+  ComputeCommandBuffer* m_commandBuffer = nullptr;
+};
+
+}  // namespace Marbas::details
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Common/Common.hpp"
+
+namespace Marbas {
+
+/**
+ * @brief FNV-1a hash, it doesn't depend on the standard library, so the hash is the same between runs and platforms.
+ * It's used by the keys of the pipeline cache and the input hashes of the passes.
+ */
+class RenderGraphHasher final {
+ public:
+  void
+  AddBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      m_hash = (m_hash ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+
+  /**
+   * @brief add a scalar, the struct may have padding bytes, so add its members one by one or use AddBytes if it
+   * doesn't have padding, e.g. the glm matrices
+   */
+  template <typename T>
+  void
+  Add(const T& value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "only the scalar can be hashed by bytes");
+    AddBytes(&value, sizeof(T));
+  }
+
+  void
+  AddString(StringView str) {
+    Add(str.size());
+    AddBytes(str.data(), str.size());
+  }
+
+  uint64_t
+  GetHash() const {
+    return m_hash;
+  }
+
+ private:
+  uint64_t m_hash = 14695981039346656037ull;
+};
+
+}  // namespace Marbas
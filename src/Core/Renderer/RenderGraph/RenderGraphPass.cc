@@ -2,7 +2,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #include "RenderGraph.hpp"
+#include "RenderGraphHasher.hpp"
 
 namespace Marbas::details {
 
@@ -11,15 +14,21 @@ namespace Marbas::details {
  */
 
 ImageView*
-ImageDesc::GetImageView(RenderGraph* graph) const {
-  auto& res = graph->m_resourceManager->m_graphTexture[m_handler.index];
-  return res.GetImageView(m_baseLayer, m_layerCount, m_baseLevel, m_levelCount);
+ImageDesc::GetImageView(RenderGraph* graph, uint32_t frameIndex) const {
+  auto& res = *graph->m_resourceManager->m_graphTexture[m_handler.index];
+
+  // the history texture selects its copies by the frames writing it, the previous frame is the copy written last
+  if (m_isHistory) {
+    return res.GetCopyImageView(res.GetHistoryCopyIndex(), m_baseLayer, m_layerCount, m_baseLevel, m_levelCount);
+  }
+  return res.GetImageView(m_baseLayer, m_layerCount, m_baseLevel, m_levelCount, frameIndex);
 }
 
 void
-CombineImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint) const {
+CombineImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint,
+                       uint32_t frameIndex) const {
   BindImageInfo bindInfo;
-  auto* imageView = GetImageView(graph);
+  auto* imageView = GetImageView(graph, frameIndex);
   bindInfo.imageView = imageView;
   bindInfo.sampler = m_sampler;
   bindInfo.bindingPoint = bindingPoint;
@@ -28,11 +37,12 @@ CombineImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set,
 }
 
 void
-StorageImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint) const {
+StorageImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint,
+                       uint32_t frameIndex) const {
   BindStorageImageInfo bindInfo;
   bindInfo.descriptorSet = set;
   bindInfo.bindingPoint = bindingPoint;
-  bindInfo.imageView = GetImageView(graph);
+  bindInfo.imageView = GetImageView(graph, frameIndex);
   ctx->BindStorageImage(bindInfo);
   return;
 }
@@ -44,19 +54,144 @@ StorageImageDesc::Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set,
 RenderGraphPass::RenderGraphPass(StringView name, RHIFactory* rhiFactory)
     : RenderGraphNode(name, RenderGraphNodeType::Pass), m_rhiFactory(rhiFactory) {}
 
-RenderGraphPass::~RenderGraphPass() {}
+RenderGraphPass::~RenderGraphPass() { ReleasePipelines(); }
+
+bool
+RenderGraphPass::NeedInitialize() const {
+  if (!m_isInitialized || m_isPipelineDirty) return true;
+  return std::any_of(m_textureVersions.begin(), m_textureVersions.end(),
+                     [](const auto& version) { return version.first->GetVersion() != version.second; });
+}
+
+void
+RenderGraphPass::RecordTextureVersion() {
+  m_textureVersions.clear();
+  auto record = [&](const RenderGraphNode* node) {
+    const auto* texture = dynamic_cast<const RenderGraphTexture*>(node);
+    if (texture == nullptr) return;
+    m_textureVersions.emplace_back(texture, texture->GetVersion());
+  };
+  std::for_each(inputs.begin(), inputs.end(), record);
+  std::for_each(outputs.begin(), outputs.end(), record);
+  std::for_each(m_historyInputs.begin(), m_historyInputs.end(), record);
+  m_isInitialized = true;
+
+  // the outputs may be recreated, so the amortized pass is executed in the next frame
+  m_lastUpdateFrame.reset();
+  m_lastFingerprint.reset();
+}
+
+void
+RenderGraphPass::FindHistoryInputs(RenderGraph* graph, const Vector<std::unique_ptr<InputDesc>>& inputs,
+                                   uint32_t frameCount) {
+  m_historyBindings.clear();
+  for (uint16_t i = 0; i < inputs.size(); i++) {
+    const auto* desc = dynamic_cast<const ImageDesc*>(inputs[i].get());
+    if (desc == nullptr || !graph->m_resourceManager->m_graphTexture[desc->m_handler.index]->IsHistory()) continue;
+    m_historyBindings.push_back({i, desc});
+  }
+
+  // the descriptor sets are just created, so every history input is bound again before it's used
+  m_boundHistoryViews.assign(m_historyBindings.size() * frameCount, nullptr);
+}
+
+void
+RenderGraphPass::BindHistoryInputs(RenderGraph* graph, const Vector<std::unique_ptr<InputDesc>>& inputs,
+                                   uintptr_t descriptorSet) {
+  // the descriptor set of the frame in flight isn't used by the GPU, the frame used it last time is finished
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+  for (size_t i = 0; i < m_historyBindings.size(); i++) {
+    const auto& binding = m_historyBindings[i];
+    auto* imageView = binding.desc->GetImageView(graph, m_frameIndex);
+    auto& boundView = m_boundHistoryViews[m_frameIndex * m_historyBindings.size() + i];
+    if (boundView == imageView) continue;
+    inputs[binding.bindingPoint]->Bind(graph, pipelineCtx, descriptorSet, binding.bindingPoint, m_frameIndex);
+    boundView = imageView;
+  }
+}
+
+uint64_t
+RenderGraphPass::GetFingerprint(uint64_t inputHash) const {
+  // the outputs are included too, the content written by the pass is lost if another pass writes them after it
+  RenderGraphHasher hasher;
+  hasher.Add(inputHash);
+  auto addResource = [&](const RenderGraphNode* node) {
+    const auto* resource = dynamic_cast<const RenderGraphResource*>(node);
+    if (resource == nullptr) return;
+    hasher.Add(resource->GetVersion());
+    hasher.Add(resource->GetContentVersion());
+  };
+  std::for_each(inputs.begin(), inputs.end(), addResource);
+  std::for_each(outputs.begin(), outputs.end(), addResource);
+  std::for_each(m_historyInputs.begin(), m_historyInputs.end(), addResource);
+  return hasher.GetHash();
+}
+
+bool
+RenderGraphPass::IsInputChanged(RenderGraph* graph, void* userData) {
+  m_pendingInputHash = GetInputHash(graph, userData);
+  if (!m_pendingInputHash.has_value()) return true;
+  if (m_lastFingerprint != GetFingerprint(*m_pendingInputHash)) return true;
+
+  m_pendingInputHash.reset();
+  m_skipCount++;
+  return false;
+}
+
+void
+RenderGraphPass::BeginUpdate(uint64_t frame) {
+  m_updateSlice = m_updateCount % m_updatePolicy.sliceCount;
+  m_updateCount++;
+  m_lastUpdateFrame = frame;
+
+  for (auto* node : outputs) {
+    if (auto* resource = dynamic_cast<RenderGraphResource*>(node); resource != nullptr) {
+      resource->IncreaseContentVersion();
+    }
+  }
+
+  // the fingerprint includes the outputs written by this execution, so the pass is skipped in the next frame if no
+  // other pass writes them
+  if (m_pendingInputHash.has_value()) {
+    m_lastFingerprint = GetFingerprint(*m_pendingInputHash);
+    m_pendingInputHash.reset();
+  }
+}
+
+template <typename CreateInfo>
+void
+RenderGraphPass::AcquirePipelines(RenderGraph* graph, const Vector<CreateInfo>& createInfos,
+                                  Vector<uintptr_t>& pipelines) {
+  ReleasePipelines();
+  pipelines.clear();
+  m_pipelineCache = graph->m_resourceManager->m_pipelineCache.get();
+  for (const auto& createInfo : createInfos) {
+    auto key = m_pipelineCache->GetKey(createInfo);
+    pipelines.push_back(m_pipelineCache->AcquirePipeline(key, createInfo));
+    m_pipelineKeys.push_back(key);
+  }
+}
+
+void
+RenderGraphPass::ReleasePipelines() {
+  if (m_pipelineCache == nullptr) return;
+  for (auto key : m_pipelineKeys) {
+    m_pipelineCache->ReleasePipeline(key);
+  }
+  m_pipelineKeys.clear();
+}
 
 RenderGraphGraphicsPass::RenderGraphGraphicsPass(StringView name, RHIFactory* rhiFactory)
     : RenderGraphPass(name, rhiFactory) {}
 
 RenderGraphGraphicsPass::~RenderGraphGraphicsPass() {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  if (m_framebuffer != nullptr) {
-    pipelineCtx->DestroyFrameBuffer(m_framebuffer);
+  for (auto* framebuffer : m_framebuffers) {
+    pipelineCtx->DestroyFrameBuffer(framebuffer);
   }
 
-  for (auto pipeline : m_pipelines) {
-    pipelineCtx->DestroyPipeline(pipeline);
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
   }
 }
 
@@ -84,100 +219,306 @@ RenderGraphGraphicsPass::AddSubResDesc(TextureAttachmentType type, const RenderG
   }
 }
 
+void
+RenderGraphGraphicsPass::InitializePipeline(RenderGraph* graph) {
+  if (!m_isPipelineDirty) return;
+  AcquirePipelines(graph, m_pipelineCreateInfos, m_pipelines);
+  m_isPipelineDirty = false;
+}
+
 void
 RenderGraphGraphicsPass::Initialize(RenderGraph* graph) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
   auto bufCtx = m_rhiFactory->GetBufferContext();
+  const uint32_t frameCount = graph->GetFrameInFlightCount();
 
-  m_commandBuffer = bufCtx->CreateGraphicsCommandBuffer();
-
-  /**
-   * create pipeline
-   */
-  for (int i = 0; i < m_pipelineCreateInfos.size(); i++) {
-    auto pipeline = pipelineCtx->CreatePipeline(m_pipelineCreateInfos[i]);
-    m_pipelines.push_back(pipeline);
+  // the pass may be initialized again after the textures are changed, the command buffers don't depend on them
+  if (m_commandBuffers.empty()) {
+    for (uint32_t i = 0; i < frameCount; i++) {
+      m_commandBuffers.push_back(bufCtx->CreateGraphicsCommandBuffer());
+    }
+    m_recordCommandBuffer.SetCommandBuffer(m_commandBuffers[m_frameIndex]);
   }
 
+  // the pipelines are usually created by the graph before, it does nothing in that case
+  InitializePipeline(graph);
+
   /**
-   * create descriptorSet and bind image view
+   * create descriptorSet and bind image view, the transient texture has a copy for every frame in flight, so every
+   * frame has its own descriptor set
    */
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
+  }
+  m_descriptorSets.clear();
   if (!m_inputAttachment.empty()) {
     DescriptorSetArgument argument;
 
     for (int i = 0; i < m_inputAttachment.size(); i++) {
       m_inputAttachment[i]->SetArgument(argument, i);
     }
-    m_descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
-    for (uint16_t i = 0; i < m_inputAttachment.size(); i++) {
-      m_inputAttachment[i]->Bind(graph, pipelineCtx, m_descriptorSet, i);
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+      auto descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
+      for (uint16_t i = 0; i < m_inputAttachment.size(); i++) {
+        m_inputAttachment[i]->Bind(graph, pipelineCtx, descriptorSet, i, frame);
+      }
+      m_descriptorSets.push_back(descriptorSet);
     }
   }
+  FindHistoryInputs(graph, m_inputAttachment, frameCount);
 
   /**
-   * create framebuffer
+   * create framebuffer, the size follows the first attachment if it isn't set by the pass, so the pass is resized with
+   * its render targets
    */
+  for (auto* framebuffer : m_framebuffers) {
+    pipelineCtx->DestroyFrameBuffer(framebuffer);
+  }
+  m_framebuffers.clear();
+
+  m_extentWidth = m_framebufferWidth;
+  m_extentHeight = m_framebufferHeight;
+  const ImageDesc* firstAttachment = m_colorAttachment.empty() ? m_depthAttachment.get() : m_colorAttachment[0].get();
+  if ((m_extentWidth == 0 || m_extentHeight == 0) && firstAttachment != nullptr) {
+    const auto& texture = *graph->m_resourceManager->m_graphTexture[firstAttachment->m_handler.index];
+    const auto& createInfo = texture.GetCreateInfo();
+    m_extentWidth = std::max(createInfo.width >> firstAttachment->m_baseLevel, 1u);
+    m_extentHeight = std::max(createInfo.height >> firstAttachment->m_baseLevel, 1u);
+  }
+
+  // the external attachment with many images, e.g. the swapchain, and the history attachment select their images
+  // every frame, so there is a framebuffer for each of the images in every frame in flight
+  m_externalAttachment = nullptr;
+  m_externalImageCount = 1;
+  auto findExternal = [&](const ImageDesc* desc) {
+    if (desc == nullptr) return;
+    auto* texture = graph->m_resourceManager->m_graphTexture[desc->m_handler.index].get();
+    if (!(texture->IsExternal() || texture->IsHistory()) || texture->GetCopyCount() <= 1 ||
+        texture == m_externalAttachment) {
+      return;
+    }
+    if (m_externalAttachment != nullptr) {
+      LOG(ERROR) << FORMAT("the pass: {} writes more than one external or history texture with many images, only the "
+                           "image of {} is selected in every frame",
+                           GetName(), m_externalAttachment->GetName());
+      return;
+    }
+    m_externalAttachment = texture;
+    m_externalImageCount = texture->GetCopyCount();
+  };
+  std::for_each(m_colorAttachment.begin(), m_colorAttachment.end(), [&](auto& desc) { findExternal(desc.get()); });
+  std::for_each(m_resolveAttachment.begin(), m_resolveAttachment.end(), [&](auto& desc) { findExternal(desc.get()); });
+  findExternal(m_depthAttachment.get());
+
+  auto getImageView = [&](const ImageDesc& desc, uint32_t frame, uint32_t externalImage) {
+    auto* texture = graph->m_resourceManager->m_graphTexture[desc.m_handler.index].get();
+    if (texture != m_externalAttachment) return desc.GetImageView(graph, frame);
+    return texture->GetCopyImageView(externalImage, desc.m_baseLayer, desc.m_layerCount, desc.m_baseLevel,
+                                     desc.m_levelCount);
+  };
+  for (uint32_t index = 0; index < frameCount * m_externalImageCount; index++) {
+    const uint32_t frame = index / m_externalImageCount;
+    const uint32_t externalImage = index % m_externalImageCount;
+
+    // get attachment image view
+    Vector<ImageView*> colorAttachment;
+    Vector<ImageView*> resolveAttachment;
+    ImageView* depthAttachment = nullptr;
+
+    for (auto& attachment : m_colorAttachment) {
+      colorAttachment.push_back(getImageView(*attachment, frame, externalImage));
+    }
 
-  // get attachment image view
-  Vector<ImageView*> colorAttachment;
-  Vector<ImageView*> resolveAttachment;
-  ImageView* depthAttachment = nullptr;
+    if (m_depthAttachment != nullptr) {
+      depthAttachment = getImageView(*m_depthAttachment, frame, externalImage);
+    }
+
+    for (auto& attachment : m_resolveAttachment) {
+      resolveAttachment.push_back(getImageView(*attachment, frame, externalImage));
+    }
+
+    // create framebuffer
+    FrameBufferCreateInfo framebufferCreateInfo;
+    framebufferCreateInfo.layer = m_framebufferLayer;
+    framebufferCreateInfo.height = m_extentHeight;
+    framebufferCreateInfo.width = m_extentWidth;
+    framebufferCreateInfo.attachments.colorAttachments = colorAttachment;
+    framebufferCreateInfo.attachments.depthAttachment = depthAttachment;
+    framebufferCreateInfo.attachments.resolveAttachments = resolveAttachment;
+    // TODO: change this
+    framebufferCreateInfo.pipeline = m_pipelines[0];
+    m_framebuffers.push_back(pipelineCtx->CreateFrameBuffer(framebufferCreateInfo));
+  }
+
+  RecordTextureVersion();
+}
 
-  for (auto& attachment : m_colorAttachment) {
-    colorAttachment.push_back(attachment->GetImageView(graph));
+FrameBuffer*
+RenderGraphGraphicsPass::GetFrameBuffer() const {
+  const uint32_t externalImage = m_externalAttachment == nullptr ? 0 : m_externalAttachment->GetCopyIndex(m_frameIndex);
+  return m_framebuffers[m_frameIndex * m_externalImageCount + externalImage];
+}
+
+void
+RenderGraphGraphicsPass::UpdateHistoryBinding(RenderGraph* graph) {
+  if (m_descriptorSets.empty()) return;
+  BindHistoryInputs(graph, m_inputAttachment, m_descriptorSets[m_frameIndex]);
+}
+
+void
+RenderGraphGraphicsPass::RecordInto(RenderGraphPass* leader) {
+  auto* leaderPass = dynamic_cast<RenderGraphGraphicsPass*>(leader);
+  if (leaderPass == nullptr) {
+    LOG(ERROR) << FORMAT("can't record the pass: {} into a non graphics pass", GetName());
+    return;
   }
+  m_recordCommandBuffer.SetCommandBuffer(leaderPass->m_commandBuffers[leaderPass->m_frameIndex]);
+}
 
+void
+RenderGraphGraphicsPass::GetTextureAccess(Vector<const ImageDesc*>& reads, Vector<const ImageDesc*>& writes) const {
+  for (const auto& input : m_inputAttachment) {
+    const auto* desc = dynamic_cast<const ImageDesc*>(input.get());
+    if (desc == nullptr) continue;
+    reads.push_back(desc);
+    if (dynamic_cast<const StorageImageDesc*>(input.get()) != nullptr) {
+      writes.push_back(desc);
+    }
+  }
+
+  for (const auto& attachment : m_colorAttachment) {
+    writes.push_back(attachment.get());
+  }
   if (m_depthAttachment != nullptr) {
-    depthAttachment = m_depthAttachment->GetImageView(graph);
+    writes.push_back(m_depthAttachment.get());
+  }
+  for (const auto& attachment : m_resolveAttachment) {
+    writes.push_back(attachment.get());
   }
+}
+
+void
+RenderGraphGraphicsPass::UpdateAttachmentAction(const std::function<bool(const ImageDesc&)>& isLoad,
+                                                const std::function<bool(const ImageDesc&)>& isStore,
+                                                const std::function<bool(const ImageDesc&)>& isExternal) {
+  // the graph may be compiled again with other passes, so always infer the actions from the declared ones
+  if (m_declaredRenderTargets.size() != m_pipelineCreateInfos.size()) {
+    m_declaredRenderTargets.clear();
+    for (const auto& createInfo : m_pipelineCreateInfos) {
+      m_declaredRenderTargets.push_back(createInfo.outputRenderTarget);
+    }
+  }
+
+  bool isChanged = false;
+  auto updateAction = [&](auto& target, const auto& declared, const ImageDesc& desc) {
+    // the old content is undefined if it's not needed, so don't load it from the memory. The external image may be
+    // used in another way after the pass, e.g. presented, so keep the declared actions.
+    auto initAction = isLoad(desc) ? declared.initAction : AttachmentInitAction::CLEAR;
+    auto finalAction = isStore(desc) ? AttachmentFinalAction::READ : AttachmentFinalAction::DISCARD;
+    if (isExternal(desc)) {
+      initAction = declared.initAction;
+      finalAction = declared.finalAction;
+    }
+    isChanged |= target.initAction != initAction || target.finalAction != finalAction;
+    target.initAction = initAction;
+    target.finalAction = finalAction;
+  };
 
-  for (auto& attachment : m_resolveAttachment) {
-    resolveAttachment.push_back(attachment->GetImageView(graph));
+  // all pipelines in the pass share the same framebuffer, so the render targets are the same
+  for (int i = 0; i < m_pipelineCreateInfos.size(); i++) {
+    auto& renderTarget = m_pipelineCreateInfos[i].outputRenderTarget;
+    const auto& declared = m_declaredRenderTargets[i];
+    auto colorCount = std::min(renderTarget.colorAttachments.size(), m_colorAttachment.size());
+    for (int j = 0; j < colorCount; j++) {
+      updateAction(renderTarget.colorAttachments[j], declared.colorAttachments[j], *m_colorAttachment[j]);
+    }
+    if (renderTarget.depthAttachments.has_value() && m_depthAttachment != nullptr) {
+      updateAction(*renderTarget.depthAttachments, *declared.depthAttachments, *m_depthAttachment);
+    }
   }
 
-  // create framebuffer
-  FrameBufferCreateInfo framebufferCreateInfo;
-  framebufferCreateInfo.layer = m_framebufferLayer;
-  framebufferCreateInfo.height = m_framebufferHeight;
-  framebufferCreateInfo.width = m_framebufferWidth;
-  framebufferCreateInfo.attachments.colorAttachments = colorAttachment;
-  framebufferCreateInfo.attachments.depthAttachment = depthAttachment;
-  framebufferCreateInfo.attachments.resolveAttachments = resolveAttachment;
-  // TODO: change this
-  framebufferCreateInfo.pipeline = m_pipelines[0];
-  m_framebuffer = pipelineCtx->CreateFrameBuffer(framebufferCreateInfo);
+  // the render pass of the pipeline depends on the actions
+  if (isChanged) {
+    m_isPipelineDirty = true;
+  }
 }
 
 RenderGraphComputePass::RenderGraphComputePass(std::string_view name, RHIFactory* rhiFactory)
     : RenderGraphPass(name, rhiFactory) {}
 
+void
+RenderGraphComputePass::InitializePipeline(RenderGraph* graph) {
+  if (!m_isPipelineDirty) return;
+  AcquirePipelines(graph, m_pipelineCreateInfos, m_pipelines);
+  m_isPipelineDirty = false;
+}
+
 void
 RenderGraphComputePass::Initialize(RenderGraph* graph) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
   auto bufCtx = m_rhiFactory->GetBufferContext();
+  const uint32_t frameCount = graph->GetFrameInFlightCount();
 
-  m_commandBuffer = bufCtx->CreateComputeCommandBuffer();
-
-  /**
-   * create pipeline
-   */
-  for (int i = 0; i < m_pipelineCreateInfos.size(); i++) {
-    auto pipeline = pipelineCtx->CreatePipeline(m_pipelineCreateInfos[i]);
-    m_pipelines.push_back(pipeline);
+  if (m_commandBuffers.empty()) {
+    for (uint32_t i = 0; i < frameCount; i++) {
+      m_commandBuffers.push_back(bufCtx->CreateComputeCommandBuffer());
+    }
+    m_recordCommandBuffer.SetCommandBuffer(m_commandBuffers[m_frameIndex]);
   }
 
+  // the pipelines are usually created by the graph before, it does nothing in that case
+  InitializePipeline(graph);
+
   /**
-   * create descriptorSet and bind image view
+   * create descriptorSet and bind image view for every frame in flight
    */
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
+  }
+  m_descriptorSets.clear();
   if (!m_inputAttachment.empty()) {
     DescriptorSetArgument argument;
 
     for (int i = 0; i < m_inputAttachment.size(); i++) {
       m_inputAttachment[i]->SetArgument(argument, i);
     }
-    m_descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
-    for (uint16_t i = 0; i < m_inputAttachment.size(); i++) {
-      m_inputAttachment[i]->Bind(graph, pipelineCtx, m_descriptorSet, i);
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+      auto descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
+      for (uint16_t i = 0; i < m_inputAttachment.size(); i++) {
+        m_inputAttachment[i]->Bind(graph, pipelineCtx, descriptorSet, i, frame);
+      }
+      m_descriptorSets.push_back(descriptorSet);
+    }
+  }
+  FindHistoryInputs(graph, m_inputAttachment, frameCount);
+
+  RecordTextureVersion();
+}
+
+void
+RenderGraphComputePass::UpdateHistoryBinding(RenderGraph* graph) {
+  if (m_descriptorSets.empty()) return;
+  BindHistoryInputs(graph, m_inputAttachment, m_descriptorSets[m_frameIndex]);
+}
+
+void
+RenderGraphComputePass::RecordInto(RenderGraphPass* leader) {
+  auto* leaderPass = dynamic_cast<RenderGraphComputePass*>(leader);
+  if (leaderPass == nullptr) {
+    LOG(ERROR) << FORMAT("can't record the pass: {} into a non compute pass", GetName());
+    return;
+  }
+  m_recordCommandBuffer.SetCommandBuffer(leaderPass->m_commandBuffers[leaderPass->m_frameIndex]);
+}
+
+void
+RenderGraphComputePass::GetTextureAccess(Vector<const ImageDesc*>& reads, Vector<const ImageDesc*>& writes) const {
+  for (const auto& input : m_inputAttachment) {
+    const auto* desc = dynamic_cast<const ImageDesc*>(input.get());
+    if (desc == nullptr) continue;
+    reads.push_back(desc);
+    if (dynamic_cast<const StorageImageDesc*>(input.get()) != nullptr) {
+      writes.push_back(desc);
     }
   }
 }
@@ -185,8 +526,8 @@ RenderGraphComputePass::Initialize(RenderGraph* graph) {
 RenderGraphComputePass::~RenderGraphComputePass() {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
 
-  for (auto pipeline : m_pipelines) {
-    pipelineCtx->DestroyPipeline(pipeline);
+  for (auto descriptorSet : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(descriptorSet);
   }
 }
 
@@ -196,7 +537,7 @@ LambdaGraphicsRenderGraphPass::LambdaGraphicsRenderGraphPass(StringView name, RH
 void
 LambdaGraphicsRenderGraphPass::Execute(RenderGraph* graph, void* userData) {
   RenderGraphGraphicsRegistry registry(graph, this, userData);
-  m_command(registry, *m_commandBuffer);
+  m_command(registry, m_recordCommandBuffer);
 }
 
 LambdaComputeRenderGraphPass::LambdaComputeRenderGraphPass(StringView name, RHIFactory* rhiFactory)
@@ -205,7 +546,7 @@ LambdaComputeRenderGraphPass::LambdaComputeRenderGraphPass(StringView name, RHIF
 void
 LambdaComputeRenderGraphPass::Execute(RenderGraph* graph, void* userData) {
   RenderGraphComputeRegistry registry(graph, this, userData);
-  m_command(registry, *m_commandBuffer);
+  m_command(registry, m_recordCommandBuffer);
 }
 
 }  // namespace Marbas::details
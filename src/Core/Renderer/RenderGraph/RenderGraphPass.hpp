@@ -1,10 +1,14 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <optional>
+#include <span>
 #include <type_traits>
 
 #include "Core/Scene/Scene.hpp"
 #include "RenderGraphBuilder.hpp"
+#include "RenderGraphCommandBuffer.hpp"
 #include "RenderGraphNode.hpp"
 #include "RenderGraphRegistry.hpp"
 
@@ -12,15 +16,47 @@ namespace Marbas {
 
 enum class PassType {
   Graphics,
+  Compute,
+};
+
+/**
+ * @brief the CPU time of executing a pass in a frame
+ */
+struct RenderGraphPassTiming {
+  float recordMilliseconds = 0;  // recording the commands, the first and the last pass of a batch also include
+                                 // beginning and ending the command buffer
+  float submitMilliseconds = 0;  // submitting the batch, it's 0 if the pass isn't the leader of its batch
+};
+
+/**
+ * @brief how often a pass is executed, the pass whose inputs change slowly can be executed in fewer frames. The outputs
+ * of the skipped pass keep the content of its last execution.
+ */
+struct RenderGraphUpdatePolicy {
+  uint32_t interval = 1;    // execute the pass at most once every interval frames
+  uint32_t sliceCount = 1;  // the work is split into slices, an execution updates one slice, see GetUpdateSlice
+  bool isBudgeted = false;  // the pass shares the update budget of the graph with the other budgeted passes, see
+                            // RenderGraph::SetUpdateBudget
 };
 
 namespace details {
 
+struct ImageDesc;
+struct InputDesc;
+class RenderGraphPipelineCache;
+
 class RenderGraphPass : public RenderGraphNode {
  public:
   RenderGraphPass(StringView name, RHIFactory* rhiFactory);
   virtual ~RenderGraphPass();
 
+  /**
+   * @brief create the pipelines of the pass if they are invalidated, it's called by Initialize. It only touches the
+   * pass and the pipeline cache, so the pipelines of different passes can be created concurrently.
+   */
+  virtual void
+  InitializePipeline(RenderGraph* graph) = 0;
+
   virtual void
   Initialize(RenderGraph* graph) = 0;
 
@@ -28,20 +64,292 @@ class RenderGraphPass : public RenderGraphNode {
   Execute(RenderGraph* graph, void* userData) = 0;
 
   virtual void
-  Submit(Semaphore* waitSemaphore, Semaphore* signedSemaphore, Fence* fence) = 0;
+  Submit(std::span<Semaphore*> waitSemaphores, std::span<Semaphore*> signalSemaphores, Fence* fence) = 0;
 
   virtual bool
   IsEnable(RenderGraph* graph, void* userData) = 0;
 
+  virtual PassType
+  GetPassType() const = 0;
+
+  /**
+   * @brief record the commands of the pass into the command buffer of the leader pass, the leader must have the same
+   * pass type. The leader begins, ends and submits its command buffer for all passes recorded into it.
+   */
+  virtual void
+  RecordInto(RenderGraphPass* leader) = 0;
+
+  virtual void
+  BeginCommandBuffer() = 0;
+
+  virtual void
+  EndCommandBuffer() = 0;
+
+  /**
+   * @brief get the sub resources of the textures read and written by the pass
+   */
+  virtual void
+  GetTextureAccess(Vector<const ImageDesc*>& reads, Vector<const ImageDesc*>& writes) const = 0;
+
+  /**
+   * @brief the pass reads the previous frame of the history texture, it doesn't order the pass after the writer of the
+   * texture in the current frame
+   */
+  void
+  AddHistoryInput(RenderGraphTexture* texture) {
+    m_historyInputs.push_back(texture);
+  }
+
+  const Vector<RenderGraphTexture*>&
+  GetHistoryInputs() const {
+    return m_historyInputs;
+  }
+
+  /**
+   * @brief select the command buffer, descriptor set and framebuffer of the frame in flight, the resources of the
+   * other frames may be still used by the GPU.
+   */
+  void
+  SetFrameIndex(uint32_t frameIndex) {
+    m_frameIndex = frameIndex;
+  }
+
+  uint32_t
+  GetFrameIndex() const {
+    return m_frameIndex;
+  }
+
+  /**
+   * @brief bind the copies of the history textures used by the current frame to the descriptor set of the frame in
+   * flight, it's called before recording. The history texture selects its copies by the frames writing it instead of
+   * the frame in flight, so they may be different from the copies bound when the descriptor set was used last time.
+   */
+  virtual void
+  UpdateHistoryBinding(RenderGraph* graph) = 0;
+
+  /**
+   * @brief whether the pass must be initialized before executing. It's true if the pass isn't initialized, its
+   * pipelines are invalidated, or the images of the textures used by it are changed after the last initializing.
+   */
+  bool
+  NeedInitialize() const;
+
+  /**
+   * @brief recreate the pipelines on the next initializing, e.g. the shader is changed
+   */
+  void
+  InvalidatePipeline() {
+    m_isPipelineDirty = true;
+  }
+
+  /**
+   * @brief remember the timing of an execution, the oldest one is overwritten if the history is full
+   */
+  void
+  AddTiming(const RenderGraphPassTiming& timing) {
+    m_timingHistory[m_nextTiming] = timing;
+    m_nextTiming = (m_nextTiming + 1) % timingHistorySize;
+    m_timingCount = std::min(m_timingCount + 1, timingHistorySize);
+  }
+
+  /**
+   * @brief get the timings of the last executions, the oldest one is the first
+   */
+  Vector<RenderGraphPassTiming>
+  GetTimingHistory() const {
+    Vector<RenderGraphPassTiming> history;
+    history.reserve(m_timingCount);
+    const uint32_t first = (m_nextTiming + timingHistorySize - m_timingCount) % timingHistorySize;
+    for (uint32_t i = 0; i < m_timingCount; i++) {
+      history.push_back(m_timingHistory[(first + i) % timingHistorySize]);
+    }
+    return history;
+  }
+
+  /**
+   * @brief the average of the timing history, it doesn't allocate memory
+   */
+  RenderGraphPassTiming
+  GetAverageTiming() const {
+    RenderGraphPassTiming average;
+    if (m_timingCount == 0) return average;
+    for (uint32_t i = 0; i < m_timingCount; i++) {
+      average.recordMilliseconds += m_timingHistory[i].recordMilliseconds;
+      average.submitMilliseconds += m_timingHistory[i].submitMilliseconds;
+    }
+    average.recordMilliseconds /= m_timingCount;
+    average.submitMilliseconds /= m_timingCount;
+    return average;
+  }
+
+  void
+  SetUpdatePolicy(const RenderGraphUpdatePolicy& policy) {
+    m_updatePolicy = policy;
+    m_updatePolicy.interval = std::max(policy.interval, 1u);
+    m_updatePolicy.sliceCount = std::max(policy.sliceCount, 1u);
+  }
+
+  const RenderGraphUpdatePolicy&
+  GetUpdatePolicy() const {
+    return m_updatePolicy;
+  }
+
+  /**
+   * @brief whether the pass may be skipped in some frames, so its outputs must be kept between the frames
+   */
+  bool
+  IsAmortized() const {
+    return m_updatePolicy.interval > 1 || m_updatePolicy.sliceCount > 1 || m_updatePolicy.isBudgeted || HasInputHash();
+  }
+
+  /**
+   * @brief the fingerprint of the inputs which aren't tracked by the graph, e.g. the versions of the components and
+   * the camera. The pass providing it is skipped if the fingerprint, the content of its input resources and the images
+   * of its resources aren't changed since its last execution.
+   *
+   * @return nullopt if the pass doesn't provide it, then the pass is executed in every frame
+   */
+  virtual std::optional<uint64_t>
+  GetInputHash(RenderGraph* graph, void* userData) {
+    if (m_inputHashFunc == nullptr) return std::nullopt;
+    return m_inputHashFunc();
+  }
+
+  virtual bool
+  HasInputHash() const {
+    return m_inputHashFunc != nullptr;
+  }
+
+  void
+  SetInputHashFunc(std::function<uint64_t()> func) {
+    m_inputHashFunc = std::move(func);
+  }
+
+  /**
+   * @brief whether the pass must be executed because its inputs are changed, the skipping is counted. It's called in
+   * the execute order, so the content of the inputs written by the passes before it in this frame is already increased
+   * by BeginUpdate.
+   */
+  bool
+  IsInputChanged(RenderGraph* graph, void* userData);
+
+  uint64_t
+  GetSkipCount() const {
+    return m_skipCount;
+  }
+
+  uint64_t
+  GetUpdateCount() const {
+    return m_updateCount;
+  }
+
+  /**
+   * @brief whether the interval of the update policy is passed since the last execution. The pass which isn't
+   * executed since it's initialized is always due, because its outputs may be recreated.
+   */
+  bool
+  IsUpdateDue(uint64_t frame) const {
+    return !m_lastUpdateFrame.has_value() || frame - *m_lastUpdateFrame >= m_updatePolicy.interval;
+  }
+
+  /**
+   * @brief the frame of the last execution, nullopt is less than any frame, so the pass which isn't executed is the
+   * first one to be updated
+   */
+  std::optional<uint64_t>
+  GetLastUpdateFrame() const {
+    return m_lastUpdateFrame;
+  }
+
+  /**
+   * @brief called before the pass is executed in a frame, it selects the next slice, increases the content version of
+   * the outputs and remembers the fingerprint of the inputs
+   */
+  void
+  BeginUpdate(uint64_t frame);
+
+  /**
+   * @brief the slice updated by the current execution, the slices are updated in round robin
+   */
+  uint32_t
+  GetUpdateSlice() const {
+    return m_updateSlice;
+  }
+
+  constexpr static uint32_t timingHistorySize = 64;
+
  protected:
+  /**
+   * @brief remember the versions of the textures used by the pass, it's called at the end of initializing. The
+   * buffers aren't bound by the graph, so the pass isn't initialized again when they are recreated.
+   */
+  void
+  RecordTextureVersion();
+
+  /**
+   * @brief find the inputs using the history textures, they are bound again by BindHistoryInputs when their copies
+   * are changed
+   */
+  void
+  FindHistoryInputs(RenderGraph* graph, const Vector<std::unique_ptr<InputDesc>>& inputs, uint32_t frameCount);
+
+  void
+  BindHistoryInputs(RenderGraph* graph, const Vector<std::unique_ptr<InputDesc>>& inputs, uintptr_t descriptorSet);
+
+  /**
+   * @brief get the pipelines from the pipeline cache of the graph, the pipelines got before are released.
+   */
+  template <typename CreateInfo>
+  void
+  AcquirePipelines(RenderGraph* graph, const Vector<CreateInfo>& createInfos, Vector<uintptr_t>& pipelines);
+
+  void
+  ReleasePipelines();
+
+  /**
+   * @brief combine the input hash with the versions of the resources used by the pass
+   */
+  uint64_t
+  GetFingerprint(uint64_t inputHash) const;
+
   RHIFactory* m_rhiFactory;
+  uint32_t m_frameIndex = 0;
+  bool m_isInitialized = false;
+  bool m_isPipelineDirty = true;
+  Vector<std::pair<const RenderGraphTexture*, uint32_t>> m_textureVersions;
+  Vector<RenderGraphTexture*> m_historyInputs;  // the textures whose previous frame is read by the pass
+
+  struct HistoryBinding {
+    uint16_t bindingPoint;
+    const ImageDesc* desc;
+  };
+  Vector<HistoryBinding> m_historyBindings;  // the inputs using the current or the previous frame of history textures
+  Vector<ImageView*> m_boundHistoryViews;    // the image views bound to them, indexed by the frame in flight first
+
+  RenderGraphPipelineCache* m_pipelineCache = nullptr;  // the pipelines are owned by the cache
+  Vector<uint64_t> m_pipelineKeys;
+
+  // the ring buffer of the timings, it doesn't allocate memory when executing
+  std::array<RenderGraphPassTiming, timingHistorySize> m_timingHistory;
+  uint32_t m_timingCount = 0;
+  uint32_t m_nextTiming = 0;
+
+  RenderGraphUpdatePolicy m_updatePolicy;
+  std::optional<uint64_t> m_lastUpdateFrame;  // it's reset when the pass is initialized
+  uint64_t m_updateCount = 0;
+  uint32_t m_updateSlice = 0;
+
+  std::function<uint64_t()> m_inputHashFunc;
+  std::optional<uint64_t> m_pendingInputHash;  // the input hash of the current frame, it's used by BeginUpdate
+  std::optional<uint64_t> m_lastFingerprint;   // the fingerprint of the last execution, it's reset when initializing
+  uint64_t m_skipCount = 0;
 };
 
 struct InputDesc {
   virtual ~InputDesc() = default;
 
   virtual void
-  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint) const = 0;
+  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint, uint32_t frameIndex) const = 0;
 
   virtual void
   SetArgument(DescriptorSetArgument& argument, uint16_t bindingPoint) const = 0;
@@ -55,9 +363,10 @@ struct ImageDesc {
   uint32_t m_layerCount;
   uint32_t m_baseLevel;
   uint32_t m_levelCount;
+  bool m_isHistory = false;  // read the copy of the previous frame
 
   ImageView*
-  GetImageView(RenderGraph* graph) const;
+  GetImageView(RenderGraph* graph, uint32_t frameIndex) const;
 };
 
 struct CombineImageDesc final : public InputDesc, ImageDesc {
@@ -67,7 +376,8 @@ struct CombineImageDesc final : public InputDesc, ImageDesc {
   ~CombineImageDesc() override = default;
 
   void
-  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint) const override;
+  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint,
+       uint32_t frameIndex) const override;
 
   void
   SetArgument(DescriptorSetArgument& argument, uint16_t bindingPoint) const override {
@@ -80,7 +390,8 @@ struct StorageImageDesc final : public InputDesc, ImageDesc {
   ~StorageImageDesc() override = default;
 
   void
-  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint) const override;
+  Bind(RenderGraph* graph, PipelineContext* ctx, uintptr_t set, uint16_t bindingPoint,
+       uint32_t frameIndex) const override;
 
   void
   SetArgument(DescriptorSetArgument& argument, uint16_t bindingPoint) const override {
@@ -96,6 +407,9 @@ class RenderGraphGraphicsPass : public RenderGraphPass {
   RenderGraphGraphicsPass(StringView name, RHIFactory* rhiFactory);
   virtual ~RenderGraphGraphicsPass();
 
+  void
+  InitializePipeline(RenderGraph* graph) final override;
+
   void
   Initialize(RenderGraph* graph) final override;
 
@@ -113,22 +427,76 @@ class RenderGraphGraphicsPass : public RenderGraphPass {
   }
 
   void
-  Submit(Semaphore* waitSemaphore, Semaphore* signedSemaphore, Fence* fence) override final {
-    m_commandBuffer->Submit({&waitSemaphore, 1}, {&signedSemaphore, 1}, fence);
+  Submit(std::span<Semaphore*> waitSemaphores, std::span<Semaphore*> signalSemaphores, Fence* fence) override final {
+    m_commandBuffers[m_frameIndex]->Submit(waitSemaphores, signalSemaphores, fence);
   }
 
+  PassType
+  GetPassType() const override final {
+    return PassType::Graphics;
+  }
+
+  void
+  RecordInto(RenderGraphPass* leader) override final;
+
+  void
+  BeginCommandBuffer() override final {
+    m_commandBuffers[m_frameIndex]->Begin();
+  }
+
+  void
+  EndCommandBuffer() override final {
+    m_commandBuffers[m_frameIndex]->End();
+  }
+
+  void
+  GetTextureAccess(Vector<const ImageDesc*>& reads, Vector<const ImageDesc*>& writes) const override;
+
+  void
+  UpdateHistoryBinding(RenderGraph* graph) override final;
+
+  /**
+   * @brief update the init and final action of the attachments, it must be called before initializing the pass. The
+   * pipelines are invalidated if any action is changed.
+   *
+   * @param isLoad whether the content of the attachment is needed by the pass
+   * @param isStore whether the content of the attachment is needed after the pass
+   * @param isExternal whether the attachment is imported from outside the graph, it keeps the declared actions
+   */
+  void
+  UpdateAttachmentAction(const std::function<bool(const ImageDesc&)>& isLoad,
+                         const std::function<bool(const ImageDesc&)>& isStore,
+                         const std::function<bool(const ImageDesc&)>& isExternal);
+
+  /**
+   * @brief the framebuffer of the current frame in flight and the selected image of the external attachment
+   */
+  FrameBuffer*
+  GetFrameBuffer() const;
+
  protected:
+  using RenderTargetDesc = decltype(GraphicsPipeLineCreateInfo::outputRenderTarget);
+
   std::vector<uintptr_t> m_pipelines;
   std::vector<GraphicsPipeLineCreateInfo> m_pipelineCreateInfos;
-  GraphicsCommandBuffer* m_commandBuffer;
-
-  FrameBuffer* m_framebuffer;
-  uint32_t m_framebufferWidth;
-  uint32_t m_framebufferHeight;
-  uint32_t m_framebufferLayer;
+  Vector<RenderTargetDesc> m_declaredRenderTargets;        // the render targets before inferring the actions
+  Vector<GraphicsCommandBuffer*> m_commandBuffers;         // one command buffer for each frame in flight
+  RenderGraphGraphicsCommandBuffer m_recordCommandBuffer;  // the command buffer used by the pass to record commands
+
+  Vector<FrameBuffer*> m_framebuffers;  // one framebuffer for each frame in flight and each external image
+  uint32_t m_framebufferWidth = 0;      // 0 means the size follows the first attachment
+  uint32_t m_framebufferHeight = 0;
+  uint32_t m_framebufferLayer = 1;
+  uint32_t m_extentWidth = 0;  // the size of the framebuffers which are created
+  uint32_t m_extentHeight = 0;
+
+  // the external attachment with many images, e.g. the swapchain, or the history attachment, and the count of its
+  // images, it selects its image instead of the frame in flight
+  RenderGraphTexture* m_externalAttachment = nullptr;
+  uint32_t m_externalImageCount = 1;
 
   Vector<std::unique_ptr<InputDesc>> m_inputAttachment;  // the input from the last pass
-  uintptr_t m_descriptorSet;                             // the descriptor set for input attachment
+  Vector<uintptr_t> m_descriptorSets;                    // the descriptor set for input attachment of each frame
 
   Vector<std::unique_ptr<ImageDesc>> m_colorAttachment;
   std::unique_ptr<ImageDesc> m_depthAttachment;
@@ -143,6 +511,9 @@ class RenderGraphComputePass : public RenderGraphPass {
   RenderGraphComputePass(std::string_view name, RHIFactory* rhiFactory);
   ~RenderGraphComputePass() override;
 
+  void
+  InitializePipeline(RenderGraph* graph) final override;
+
   void
   Initialize(RenderGraph* graph) final override;
 
@@ -156,17 +527,42 @@ class RenderGraphComputePass : public RenderGraphPass {
   }
 
   void
-  Submit(Semaphore* waitSemaphore, Semaphore* signedSemaphore, Fence* fence) override final {
-    m_commandBuffer->Submit({&waitSemaphore, 1}, {&signedSemaphore, 1}, fence);
+  Submit(std::span<Semaphore*> waitSemaphores, std::span<Semaphore*> signalSemaphores, Fence* fence) override final {
+    m_commandBuffers[m_frameIndex]->Submit(waitSemaphores, signalSemaphores, fence);
+  }
+
+  PassType
+  GetPassType() const override final {
+    return PassType::Compute;
   }
 
+  void
+  RecordInto(RenderGraphPass* leader) override final;
+
+  void
+  BeginCommandBuffer() override final {
+    m_commandBuffers[m_frameIndex]->Begin();
+  }
+
+  void
+  EndCommandBuffer() override final {
+    m_commandBuffers[m_frameIndex]->End();
+  }
+
+  void
+  GetTextureAccess(Vector<const ImageDesc*>& reads, Vector<const ImageDesc*>& writes) const override;
+
+  void
+  UpdateHistoryBinding(RenderGraph* graph) override final;
+
  protected:
   std::vector<uintptr_t> m_pipelines;
   std::vector<ComputePipelineCreateInfo> m_pipelineCreateInfos;
 
-  ComputeCommandBuffer* m_commandBuffer;
-  Vector<std::unique_ptr<InputDesc>> m_inputAttachment;  // the input from the last pass
-  uintptr_t m_descriptorSet;                             // the descriptor set for input attachment
+  Vector<ComputeCommandBuffer*> m_commandBuffers;         // one command buffer for each frame in flight
+  RenderGraphComputeCommandBuffer m_recordCommandBuffer;  // the command buffer used by the pass to record commands
+  Vector<std::unique_ptr<InputDesc>> m_inputAttachment;   // the input from the last pass
+  Vector<uintptr_t> m_descriptorSets;                     // the descriptor set for input attachment of each frame
 };
 
 template <typename T>
@@ -219,13 +615,11 @@ class LambdaGraphicsRenderGraphPass final : public RenderGraphGraphicsPass {
 
   bool
   IsEnable(RenderGraph* graph, void* userData) override {
-    if (std::holds_alternative<std::monostate>(m_isEnable)) {
-      return true;
-    } else if (std::get_if<0>(&m_isEnable)) {
-      return std::get<0>(m_isEnable)();
-    } else if (std::get_if<1>(&m_isEnable)) {
+    if (auto* func = std::get_if<0>(&m_isEnable)) {
+      return (*func)();
+    } else if (auto* registryFunc = std::get_if<1>(&m_isEnable)) {
       RenderGraphGraphicsRegistry registry(graph, this, userData);
-      return std::get<1>(m_isEnable)(registry);
+      return (*registryFunc)(registry);
     }
     return true;
   }
@@ -238,6 +632,7 @@ class LambdaGraphicsRenderGraphPass final : public RenderGraphGraphicsPass {
 template <details::RenderGraphGraphicsStructPass Pass, typename... Args>
 class StructRenderGraphPass final : public RenderGraphGraphicsPass {
   define_has_member(IsEnable);
+  define_has_member(GetInputHash);
 
  public:
   StructRenderGraphPass(StringView name, RHIFactory* rhiFactory, Args&&... args)
@@ -255,7 +650,7 @@ class StructRenderGraphPass final : public RenderGraphGraphicsPass {
   void
   Execute(RenderGraph* graph, void* userData) override {
     RenderGraphGraphicsRegistry registry(graph, this, userData);
-    m_instance.Execute(registry, *m_commandBuffer);
+    m_instance.Execute(registry, m_recordCommandBuffer);
   }
 
   bool
@@ -271,6 +666,24 @@ class StructRenderGraphPass final : public RenderGraphGraphicsPass {
     return true;
   }
 
+  std::optional<uint64_t>
+  GetInputHash(RenderGraph* graph, void* userData) override {
+    if constexpr (has_member(Pass, GetInputHash)) {
+      if constexpr (std::is_invocable_v<decltype(&Pass::GetInputHash), Pass&>) {
+        return m_instance.GetInputHash();
+      } else if constexpr (std::is_invocable_v<decltype(&Pass::GetInputHash), Pass&, RenderGraphGraphicsRegistry&>) {
+        RenderGraphGraphicsRegistry registry(graph, this, userData);
+        return m_instance.GetInputHash(registry);
+      }
+    }
+    return RenderGraphPass::GetInputHash(graph, userData);
+  }
+
+  bool
+  HasInputHash() const override {
+    return has_member(Pass, GetInputHash) || RenderGraphPass::HasInputHash();
+  }
+
  private:
   Pass m_instance;
 };
@@ -278,6 +691,7 @@ class StructRenderGraphPass final : public RenderGraphGraphicsPass {
 template <details::RenderGraphComputeStructPass Pass, typename... Args>
 class StructRenderGraphComputePass final : public RenderGraphComputePass {
   define_has_member(IsEnable);
+  define_has_member(GetInputHash);
 
  public:
   StructRenderGraphComputePass(std::string_view name, RHIFactory* rhiFactory, Args&&... args)
@@ -294,7 +708,7 @@ class StructRenderGraphComputePass final : public RenderGraphComputePass {
   void
   Execute(RenderGraph* graph, void* userData) override {
     RenderGraphComputeRegistry registry(graph, this, userData);
-    m_instance.Execute(registry, *m_commandBuffer);
+    m_instance.Execute(registry, m_recordCommandBuffer);
   }
 
   bool
@@ -310,6 +724,24 @@ class StructRenderGraphComputePass final : public RenderGraphComputePass {
     return true;
   }
 
+  std::optional<uint64_t>
+  GetInputHash(RenderGraph* graph, void* userData) override {
+    if constexpr (has_member(Pass, GetInputHash)) {
+      if constexpr (std::is_invocable_v<decltype(&Pass::GetInputHash), Pass&>) {
+        return m_instance.GetInputHash();
+      } else if constexpr (std::is_invocable_v<decltype(&Pass::GetInputHash), Pass&, RenderGraphComputeRegistry&>) {
+        RenderGraphComputeRegistry registry(graph, this, userData);
+        return m_instance.GetInputHash(registry);
+      }
+    }
+    return RenderGraphPass::GetInputHash(graph, userData);
+  }
+
+  bool
+  HasInputHash() const override {
+    return has_member(Pass, GetInputHash) || RenderGraphPass::HasInputHash();
+  }
+
  private:
   Pass m_instance;
 };
@@ -340,13 +772,11 @@ class LambdaComputeRenderGraphPass final : public RenderGraphComputePass {
 
   bool
   IsEnable(RenderGraph* graph, void* userData) override {
-    if (std::holds_alternative<std::monostate>(m_isEnable)) {
-      return true;
-    } else if (std::get_if<0>(&m_isEnable)) {
-      return std::get<0>(m_isEnable)();
-    } else if (std::get_if<1>(&m_isEnable)) {
+    if (auto* func = std::get_if<0>(&m_isEnable)) {
+      return (*func)();
+    } else if (auto* registryFunc = std::get_if<1>(&m_isEnable)) {
       RenderGraphComputeRegistry registry(graph, this, userData);
-      return std::get<1>(m_isEnable)(registry);
+      return (*registryFunc)(registry);
     }
     return true;
   }
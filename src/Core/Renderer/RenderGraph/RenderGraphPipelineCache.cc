@@ -0,0 +1,207 @@
+#include "RenderGraphPipelineCache.hpp"
+
+#include <glog/logging.h>
+
+#include <fstream>
+#include <iterator>
+
+#include "RenderGraphHasher.hpp"
+
+namespace Marbas::details {
+
+static void
+HashShaderStage(RenderGraphHasher& hasher, const ShaderStageCreateInfo& stage, uint64_t shaderHash) {
+  hasher.AddString(stage.shaderPath.generic_string());
+  hasher.Add(stage.stage);
+  hasher.AddString(stage.interName);
+  hasher.Add(shaderHash);
+}
+
+RenderGraphPipelineCache::~RenderGraphPipelineCache() {
+  auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
+  for (auto& [key, entry] : m_pipelines) {
+    DLOG_IF(WARNING, entry.refCount != 0) << FORMAT("the pipeline {} is still used when the cache is destroyed", key);
+    pipelineCtx->DestroyPipeline(entry.pipeline.get());
+  }
+}
+
+uint64_t
+RenderGraphPipelineCache::GetShaderHash(const std::filesystem::path& path) {
+  std::error_code errorCode;
+  auto writeTime = std::filesystem::last_write_time(path, errorCode);
+  if (errorCode) {
+    LOG(WARNING) << FORMAT("can't read the shader {}, only its path is used as the pipeline key", path.string());
+    return 0;
+  }
+
+  auto pathStr = path.generic_string();
+  {
+    std::lock_guard lock(m_mutex);
+    auto iter = m_shaderHashes.find(pathStr);
+    if (iter != m_shaderHashes.end() && iter->second.writeTime == writeTime) {
+      return iter->second.hash;
+    }
+  }
+
+  // the same file may be hashed by two threads at the first time, they get the same result
+  std::ifstream file(path, std::ios::binary);
+  Vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  RenderGraphHasher hasher;
+  hasher.AddBytes(content.data(), content.size());
+
+  std::lock_guard lock(m_mutex);
+  m_shaderHashes[pathStr] = ShaderHash{writeTime, hasher.GetHash()};
+  return hasher.GetHash();
+}
+
+uint64_t
+RenderGraphPipelineCache::GetKey(const GraphicsPipeLineCreateInfo& createInfo) {
+  RenderGraphHasher hasher;
+  hasher.AddString("graphics");
+
+  const auto& depthStencil = createInfo.depthStencilInfo;
+  hasher.Add(depthStencil.depthTestEnable);
+  hasher.Add(depthStencil.depthWriteEnable);
+  hasher.Add(depthStencil.depthCompareOp);
+
+  const auto& rasterization = createInfo.rasterizationInfo;
+  hasher.Add(rasterization.polygonMode);
+  hasher.Add(rasterization.cullMode);
+  hasher.Add(rasterization.frontFace);
+  hasher.Add(createInfo.inputAssemblyState.topology);
+
+  // the bindings of the descriptor set arguments are declared by the shaders, so only the count is added
+  hasher.Add(createInfo.layout.size());
+  hasher.Add(createInfo.shaderStageCreateInfo.size());
+  for (const auto& stage : createInfo.shaderStageCreateInfo) {
+    HashShaderStage(hasher, stage, GetShaderHash(stage.shaderPath));
+  }
+
+  const auto& renderTarget = createInfo.outputRenderTarget;
+  hasher.Add(renderTarget.colorAttachments.size());
+  for (const auto& target : renderTarget.colorAttachments) {
+    hasher.Add(target.initAction);
+    hasher.Add(target.finalAction);
+    hasher.Add(target.usage);
+    hasher.Add(target.sampleCount);
+    hasher.Add(target.format);
+  }
+  hasher.Add(renderTarget.depthAttachments.has_value());
+  if (renderTarget.depthAttachments.has_value()) {
+    hasher.Add(renderTarget.depthAttachments->initAction);
+    hasher.Add(renderTarget.depthAttachments->finalAction);
+    hasher.Add(renderTarget.depthAttachments->usage);
+    hasher.Add(renderTarget.depthAttachments->sampleCount);
+  }
+  hasher.Add(renderTarget.resolveAttachments.size());
+  for (const auto& target : renderTarget.resolveAttachments) {
+    hasher.Add(target.initAction);
+    hasher.Add(target.finalAction);
+    hasher.Add(target.usage);
+    hasher.Add(target.format);
+  }
+
+  for (auto constant : createInfo.blendInfo.constances) {
+    hasher.Add(constant);
+  }
+  hasher.Add(createInfo.blendInfo.attachments.size());
+  for (const auto& attachment : createInfo.blendInfo.attachments) {
+    hasher.Add(attachment.blendEnable);
+    hasher.Add(attachment.srcColorBlendFactor);
+    hasher.Add(attachment.dstColorBlendFactor);
+    hasher.Add(attachment.srcAlphaBlendFactor);
+    hasher.Add(attachment.dstAlphaBlendFactor);
+  }
+
+  hasher.Add(createInfo.vertexInputLayout.elementDesc.size());
+  for (const auto& [binding, format, location, offset, instanceStepRate] : createInfo.vertexInputLayout.elementDesc) {
+    hasher.Add(binding);
+    hasher.Add(format);
+    hasher.Add(location);
+    hasher.Add(offset);
+    hasher.Add(instanceStepRate);
+  }
+  hasher.Add(createInfo.vertexInputLayout.viewDesc.size());
+  for (const auto& view : createInfo.vertexInputLayout.viewDesc) {
+    hasher.Add(view.binding);
+    hasher.Add(view.stride);
+    hasher.Add(view.inputClass);
+  }
+
+  hasher.Add(createInfo.pushConstantSize);
+  return hasher.GetHash();
+}
+
+uint64_t
+RenderGraphPipelineCache::GetKey(const ComputePipelineCreateInfo& createInfo) {
+  RenderGraphHasher hasher;
+  hasher.AddString("compute");
+  hasher.Add(createInfo.layout.size());
+  hasher.Add(createInfo.pushConstantSize);
+  const auto& stage = createInfo.computeShaderStage;
+  HashShaderStage(hasher, stage, GetShaderHash(stage.shaderPath));
+  return hasher.GetHash();
+}
+
+template <typename CreateInfo>
+uintptr_t
+RenderGraphPipelineCache::Acquire(uint64_t key, const CreateInfo& createInfo) {
+  std::promise<uintptr_t> promise;
+  std::shared_future<uintptr_t> pipeline;
+  bool isInsert = false;
+  {
+    std::lock_guard lock(m_mutex);
+    auto [iter, inserted] = m_pipelines.try_emplace(key);
+    isInsert = inserted;
+    if (isInsert) {
+      iter->second.pipeline = promise.get_future().share();
+    }
+    iter->second.refCount++;
+    pipeline = iter->second.pipeline;
+  }
+
+  // create the pipeline without holding the lock, so the other pipelines can be created at the same time
+  if (isInsert) {
+    promise.set_value(m_rhiFactory->GetPipelineContext()->CreatePipeline(createInfo));
+  } else {
+    DLOG(INFO) << FORMAT("reuse the pipeline {} from the cache", key);
+  }
+  return pipeline.get();
+}
+
+uintptr_t
+RenderGraphPipelineCache::AcquirePipeline(uint64_t key, const GraphicsPipeLineCreateInfo& createInfo) {
+  return Acquire(key, createInfo);
+}
+
+uintptr_t
+RenderGraphPipelineCache::AcquirePipeline(uint64_t key, const ComputePipelineCreateInfo& createInfo) {
+  return Acquire(key, createInfo);
+}
+
+void
+RenderGraphPipelineCache::ReleasePipeline(uint64_t key) {
+  std::lock_guard lock(m_mutex);
+  auto iter = m_pipelines.find(key);
+  if (iter == m_pipelines.end() || iter->second.refCount == 0) {
+    LOG(ERROR) << FORMAT("can't release the pipeline {}, it isn't acquired", key);
+    return;
+  }
+  iter->second.refCount--;
+}
+
+void
+RenderGraphPipelineCache::ClearUnused() {
+  auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
+  std::lock_guard lock(m_mutex);
+  for (auto iter = m_pipelines.begin(); iter != m_pipelines.end();) {
+    if (iter->second.refCount == 0) {
+      pipelineCtx->DestroyPipeline(iter->second.pipeline.get());
+      iter = m_pipelines.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+}  // namespace Marbas::details
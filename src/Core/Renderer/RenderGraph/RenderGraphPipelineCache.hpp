@@ -0,0 +1,87 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <mutex>
+
+#include "Common/Common.hpp"
+#include "RHIFactory.hpp"
+
+namespace Marbas::details {
+
+/**
+ * @brief share the pipelines between the passes and between the compilings of the render graphs.
+ *
+ * The pipeline is keyed by a stable hash of its create info and the content of its SPIR-V files, so the identical
+ * pipelines of different passes are created only once. The pipeline which isn't used by any pass is kept until the
+ * cache is destroyed or cleared, so recompiling the graph doesn't create it again. A SPIR-V file which is changed on
+ * the disk changes the key, so the pipeline is created again after the shader is recompiled.
+ *
+ * The cache can be used by many threads, the different pipelines are created concurrently, and the thread acquiring a
+ * pipeline being created by another thread waits for it.
+ */
+class RenderGraphPipelineCache final {
+ public:
+  explicit RenderGraphPipelineCache(RHIFactory* rhiFactory) : m_rhiFactory(rhiFactory) {}
+  ~RenderGraphPipelineCache();
+
+ public:
+  uint64_t
+  GetKey(const GraphicsPipeLineCreateInfo& createInfo);
+
+  uint64_t
+  GetKey(const ComputePipelineCreateInfo& createInfo);
+
+  /**
+   * @brief get the pipeline of the key, it's created by the create info if it isn't in the cache. Every acquiring must
+   * be paired with a releasing.
+   *
+   * @param key the key got by GetKey from the same create info
+   */
+  uintptr_t
+  AcquirePipeline(uint64_t key, const GraphicsPipeLineCreateInfo& createInfo);
+
+  uintptr_t
+  AcquirePipeline(uint64_t key, const ComputePipelineCreateInfo& createInfo);
+
+  void
+  ReleasePipeline(uint64_t key);
+
+  /**
+   * @brief destroy the pipelines which aren't used by any pass
+   */
+  void
+  ClearUnused();
+
+  size_t
+  GetPipelineCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_pipelines.size();
+  }
+
+ private:
+  template <typename CreateInfo>
+  uintptr_t
+  Acquire(uint64_t key, const CreateInfo& createInfo);
+
+  uint64_t
+  GetShaderHash(const std::filesystem::path& path);
+
+ private:
+  struct Entry {
+    std::shared_future<uintptr_t> pipeline;
+    uint32_t refCount = 0;
+  };
+
+  struct ShaderHash {
+    std::filesystem::file_time_type writeTime;
+    uint64_t hash = 0;
+  };
+
+  RHIFactory* m_rhiFactory = nullptr;
+  mutable std::mutex m_mutex;
+  HashMap<uint64_t, Entry> m_pipelines;
+  HashMap<String, ShaderHash> m_shaderHashes;  // the hash of the SPIR-V content, it's updated if the file is changed
+};
+
+}  // namespace Marbas::details
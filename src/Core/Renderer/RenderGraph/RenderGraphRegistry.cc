@@ -9,7 +9,7 @@ RenderGraphGraphicsRegistry::RenderGraphGraphicsRegistry(RenderGraph* graph, Pas
 
 uintptr_t
 RenderGraphGraphicsRegistry::GetInputDescriptorSet() {
-  return m_pass->m_descriptorSet;
+  return m_pass->m_descriptorSets.empty() ? 0 : m_pass->m_descriptorSets[m_pass->m_frameIndex];
 }
 
 uintptr_t
@@ -19,13 +19,44 @@ RenderGraphGraphicsRegistry::GetPipeline(size_t index) {
 
 FrameBuffer*
 RenderGraphGraphicsRegistry::GetFrameBuffer() {
-  return m_pass->m_framebuffer;
+  return m_pass->GetFrameBuffer();
+}
+
+uint32_t
+RenderGraphGraphicsRegistry::GetFramebufferWidth() const {
+  return m_pass->m_extentWidth;
+}
+
+uint32_t
+RenderGraphGraphicsRegistry::GetFramebufferHeight() const {
+  return m_pass->m_extentHeight;
 }
 
 Image*
 RenderGraphGraphicsRegistry::GetImage(RenderGraphTextureHandler handler) {
-  auto& texture = m_graph->m_resourceManager->m_graphTexture[handler.index];
-  return texture.GetImage();
+  auto& texture = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  return texture.GetImage(m_pass->m_frameIndex);
+}
+
+bool
+RenderGraphGraphicsRegistry::IsHistoryValid(RenderGraphTextureHandler handler) const {
+  return m_graph->m_resourceManager->m_graphTexture[handler.index]->IsHistoryValid();
+}
+
+Buffer*
+RenderGraphGraphicsRegistry::GetBuffer(RenderGraphBufferHandler handler) {
+  auto& buffer = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  return buffer.GetBuffer(m_pass->m_frameIndex);
+}
+
+uint32_t
+RenderGraphGraphicsRegistry::GetFrameIndex() const {
+  return m_pass->m_frameIndex;
+}
+
+uint32_t
+RenderGraphGraphicsRegistry::GetUpdateSlice() const {
+  return m_pass->GetUpdateSlice();
 }
 
 // compute
@@ -40,13 +71,34 @@ RenderGraphComputeRegistry::GetPipeline(size_t index) {
 
 uintptr_t
 RenderGraphComputeRegistry::GetInputDescriptorSet() {
-  return m_pass->m_descriptorSet;
+  return m_pass->m_descriptorSets.empty() ? 0 : m_pass->m_descriptorSets[m_pass->m_frameIndex];
 }
 
 Image*
 RenderGraphComputeRegistry::GetImage(RenderGraphTextureHandler handler) {
-  auto& texture = m_graph->m_resourceManager->m_graphTexture[handler.index];
-  return texture.GetImage();
+  auto& texture = *m_graph->m_resourceManager->m_graphTexture[handler.index];
+  return texture.GetImage(m_pass->m_frameIndex);
+}
+
+bool
+RenderGraphComputeRegistry::IsHistoryValid(RenderGraphTextureHandler handler) const {
+  return m_graph->m_resourceManager->m_graphTexture[handler.index]->IsHistoryValid();
+}
+
+Buffer*
+RenderGraphComputeRegistry::GetBuffer(RenderGraphBufferHandler handler) {
+  auto& buffer = *m_graph->m_resourceManager->m_graphBuffer[handler.index];
+  return buffer.GetBuffer(m_pass->m_frameIndex);
+}
+
+uint32_t
+RenderGraphComputeRegistry::GetFrameIndex() const {
+  return m_pass->m_frameIndex;
+}
+
+uint32_t
+RenderGraphComputeRegistry::GetUpdateSlice() const {
+  return m_pass->GetUpdateSlice();
 }
 
 }  // namespace Marbas
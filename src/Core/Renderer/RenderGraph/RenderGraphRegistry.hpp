@@ -33,9 +33,48 @@ class RenderGraphGraphicsRegistry final {
   FrameBuffer*
   GetFrameBuffer();
 
+  /**
+   * @brief the size of the framebuffer, the pass should use it as the viewport because the framebuffer follows the
+   * size of its render targets if RenderGraphGraphicsBuilder::SetFramebufferSize isn't called
+   */
+  uint32_t
+  GetFramebufferWidth() const;
+
+  uint32_t
+  GetFramebufferHeight() const;
+
   Image*
   GetImage(RenderGraphTextureHandler handler);
 
+  /**
+   * @brief whether the previous frame of the history texture has been written, it's false in the first frame after the
+   * texture is created or resized, then the pass shouldn't use the history read by
+   * RenderGraphGraphicsBuilder::ReadHistoryTexture
+   */
+  bool
+  IsHistoryValid(RenderGraphTextureHandler handler) const;
+
+  /**
+   * @brief get the copy of the buffer used by the frame which is recording, the buffer must be declared by
+   * RenderGraphGraphicsBuilder::ReadBuffer or WriteBuffer
+   */
+  Buffer*
+  GetBuffer(RenderGraphBufferHandler handler);
+
+  /**
+   * @brief the index of the frame in flight which is recording, the pass selects the copy of its per-frame buffers by
+   * it, see RenderGraphGraphicsBuilder::GetFrameInFlightCount
+   */
+  uint32_t
+  GetFrameIndex() const;
+
+  /**
+   * @brief the slice of the work updated by the current execution, e.g. a cascade or a probe. It's in
+   * [0, RenderGraphUpdatePolicy::sliceCount) and the slices are updated in round robin.
+   */
+  uint32_t
+  GetUpdateSlice() const;
+
  private:
   RenderGraph* m_graph;
   void* m_userData;
@@ -62,6 +101,18 @@ class RenderGraphComputeRegistry final {
   Image*
   GetImage(RenderGraphTextureHandler handler);
 
+  bool
+  IsHistoryValid(RenderGraphTextureHandler handler) const;
+
+  Buffer*
+  GetBuffer(RenderGraphBufferHandler handler);
+
+  uint32_t
+  GetFrameIndex() const;
+
+  uint32_t
+  GetUpdateSlice() const;
+
  private:
   RenderGraph* m_graph;
   void* m_userData = nullptr;
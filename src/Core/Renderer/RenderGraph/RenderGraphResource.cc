@@ -1,42 +1,171 @@
 #include "RenderGraphResource.hpp"
 
+#include <glog/logging.h>
+
+#include <algorithm>
 #include <variant>
 
 namespace Marbas::details {
 
-RenderGraphTexture::RenderGraphTexture(std::string_view name, RHIFactory* rhiFactory, const ImageCreateInfo& createInfo)
-    : RenderGraphResource(name, rhiFactory), m_imageCreateInfo(createInfo) {}
+static uint32_t
+GetFormatByteSize(ImageFormat format) {
+  switch (format) {
+    case ImageFormat::RGBA16F:
+      return 8;
+    case ImageFormat::RGBA32F:
+      return 16;
+    default:
+      return 4;
+  }
+}
+
+static uint32_t
+GetLayerCount(const ImageCreateInfo& createInfo) {
+  // clang-format off
+  return std::visit([](auto&& imageDesc) -> uint32_t {
+    using T = std::decay_t<decltype(imageDesc)>;
+    if constexpr (std::is_same_v<T, Image2DArrayDesc>) {
+      return imageDesc.arraySize;
+    } else if constexpr (std::is_same_v<T, CubeMapImageDesc>) {
+      return 6;
+    } else if constexpr (std::is_same_v<T, CubeMapArrayImageDesc>) {
+      return 6 * imageDesc.arraySize;
+    } else if constexpr (std::is_same_v<T, Image3DDesc>) {
+      return imageDesc.depth;
+    }
+    return 1;
+  }, createInfo.imageDesc);
+  // clang-format on
+}
+
+RenderGraphTexture::RenderGraphTexture(std::string_view name, RHIFactory* rhiFactory, const ImageCreateInfo& createInfo,
+                                       bool isTransient)
+    : RenderGraphResource(name, rhiFactory, isTransient), m_imageCreateInfo(createInfo) {}
+
+RenderGraphTexture::~RenderGraphTexture() { Release(); }
 
-RenderGraphTexture::~RenderGraphTexture() {
+void
+RenderGraphTexture::Create(uint32_t copyCount) {
+  if (m_isCreate) return;
+  if (m_isExternal) {
+    LOG(ERROR) << FORMAT("can't create the external texture: {}, its images must be imported", GetName());
+    return;
+  }
+  auto bufTex = m_rhiFactory->GetBufferContext();
+  for (uint32_t i = 0; i < std::max(copyCount, 1u); i++) {
+    m_images.push_back(bufTex->CreateImage(m_imageCreateInfo));
+  }
+  m_imageViews.resize(m_images.size());
+  m_historyFrameCount = 0;
+  m_writtenFrameCount = 0;
+  m_currentCopyIndex = 0;
+  m_historyCopyIndex = 0;
+  m_isCreate = true;
+  m_isDirty = false;
+  m_version++;
+}
+
+void
+RenderGraphTexture::Release() {
+  if (!m_isCreate) return;
   auto bufCtx = m_rhiFactory->GetBufferContext();
-  for (auto& [desc, imageView] : m_imageViews) {
-    bufCtx->DestroyImageView(imageView);
-    imageView = nullptr;
+  for (auto& imageViews : m_imageViews) {
+    for (auto& [desc, imageView] : imageViews) {
+      bufCtx->DestroyImageView(imageView);
+    }
   }
-  bufCtx->DestroyImage(m_image);
+  if (!m_isAlias && !m_isExternal) {
+    for (auto* image : m_images) {
+      bufCtx->DestroyImage(image);
+    }
+  }
+  m_imageViews.clear();
+  m_images.clear();
+  m_isAlias = false;
+  m_isCreate = false;
+  m_version++;
 }
 
 void
-RenderGraphTexture::Create() {
+RenderGraphTexture::AliasWith(const RenderGraphResource& owner) {
   if (m_isCreate) return;
-  auto bufTex = m_rhiFactory->GetBufferContext();
-  m_image = bufTex->CreateImage(m_imageCreateInfo);
+  const auto* texture = dynamic_cast<const RenderGraphTexture*>(&owner);
+  if (texture == nullptr) {
+    LOG(ERROR) << FORMAT("the texture: {} can't alias with the resource: {}", GetName(), owner.GetName());
+    return;
+  }
+  m_images = texture->m_images;
+  m_imageViews.resize(m_images.size());
+  m_isAlias = true;
   m_isCreate = true;
+  m_isDirty = false;
+  m_version++;
+}
+
+void
+RenderGraphTexture::Import(const ImageCreateInfo& createInfo, const Vector<Image*>& images) {
+  if (m_isCreate && !m_isExternal) {
+    LOG(ERROR) << FORMAT("can't import the images to the texture: {}, it's created by the render graph", GetName());
+    return;
+  }
+  Release();
+  m_imageCreateInfo = createInfo;
+  m_images = images;
+  m_imageViews.resize(m_images.size());
+  m_externalImageIndex = 0;
+  m_isExternal = true;
+  m_isCreate = true;
+  m_isDirty = false;
+  m_version++;
+}
+
+uint64_t
+RenderGraphTexture::GetByteSize() const {
+  uint64_t width = m_imageCreateInfo.width;
+  uint64_t height = m_imageCreateInfo.height;
+  uint64_t levelSize = width * height * GetFormatByteSize(m_imageCreateInfo.format);
+
+  uint64_t size = 0;
+  for (uint32_t i = 0; i < std::max<uint32_t>(m_imageCreateInfo.mipMapLevel, 1); i++) {
+    size += std::max<uint64_t>(levelSize >> (2 * i), 1);
+  }
+  return size * GetLayerCount(m_imageCreateInfo);
+}
+
+bool
+RenderGraphTexture::IsAliasCompatible(const RenderGraphResource& another) const {
+  const auto* texture = dynamic_cast<const RenderGraphTexture*>(&another);
+  if (texture == nullptr) return false;
+
+  const auto& info = m_imageCreateInfo;
+  const auto& anotherInfo = texture->m_imageCreateInfo;
+  return info.width == anotherInfo.width && info.height == anotherInfo.height && info.format == anotherInfo.format &&
+         info.usage == anotherInfo.usage && info.mipMapLevel == anotherInfo.mipMapLevel &&
+         info.sampleCount == anotherInfo.sampleCount && info.imageDesc.index() == anotherInfo.imageDesc.index() &&
+         GetLayerCount(info) == GetLayerCount(anotherInfo);
 }
 
 ImageView*
-RenderGraphTexture::GetImageView(uint32_t layerBase, uint32_t layerCount, uint32_t levelBase, uint32_t levelCount) {
+RenderGraphTexture::GetCopyImageView(uint32_t copyIndex, uint32_t layerBase, uint32_t layerCount, uint32_t levelBase,
+                                     uint32_t levelCount) {
+  if (m_images.empty()) {
+    LOG(ERROR) << FORMAT("can't get the image view of the texture: {}, because it's not created", GetName());
+    return nullptr;
+  }
+  copyIndex %= m_images.size();
+  auto& imageViews = m_imageViews[copyIndex];
+
   SubresourceDesc desc;
   desc.levelCount = levelCount;
   desc.levelBase = levelBase;
   desc.layerBase = layerBase;
   desc.layerCount = layerCount;
 
-  if (m_imageViews.find(desc) == m_imageViews.end()) {
+  if (imageViews.find(desc) == imageViews.end()) {
     ImageViewCreateInfo createInfo;
     createInfo.layerCount = layerCount;
     createInfo.levelCount = levelCount;
-    createInfo.image = m_image;
+    createInfo.image = m_images[copyIndex];
     createInfo.baseLevel = levelBase;
     createInfo.baseArrayLayer = layerBase;
 
@@ -58,10 +187,66 @@ RenderGraphTexture::GetImageView(uint32_t layerBase, uint32_t layerCount, uint32
     // clang-format on
 
     auto imageView = m_rhiFactory->GetBufferContext()->CreateImageView(createInfo);
-    m_imageViews.insert({desc, imageView});
+    imageViews.insert({desc, imageView});
   }
 
-  return m_imageViews.at(desc);
+  return imageViews.at(desc);
+}
+
+RenderGraphBuffer::RenderGraphBuffer(std::string_view name, RHIFactory* rhiFactory, BufferType type, uint32_t size,
+                                     bool isTransient)
+    : RenderGraphResource(name, rhiFactory, isTransient), m_type(type), m_size(size) {}
+
+RenderGraphBuffer::~RenderGraphBuffer() { Release(); }
+
+void
+RenderGraphBuffer::Create(uint32_t copyCount) {
+  if (m_isCreate) return;
+  auto bufCtx = m_rhiFactory->GetBufferContext();
+  Vector<uint8_t> data(m_size, 0);
+  for (uint32_t i = 0; i < std::max(copyCount, 1u); i++) {
+    m_buffers.push_back(bufCtx->CreateBuffer(m_type, data.data(), m_size, false));
+  }
+  m_isCreate = true;
+  m_isDirty = false;
+  m_version++;
+}
+
+void
+RenderGraphBuffer::Release() {
+  if (!m_isCreate) return;
+  if (!m_isAlias) {
+    auto bufCtx = m_rhiFactory->GetBufferContext();
+    for (auto* buffer : m_buffers) {
+      bufCtx->DestroyBuffer(buffer);
+    }
+  }
+  m_buffers.clear();
+  m_isAlias = false;
+  m_isCreate = false;
+  m_version++;
+}
+
+void
+RenderGraphBuffer::AliasWith(const RenderGraphResource& owner) {
+  if (m_isCreate) return;
+  const auto* buffer = dynamic_cast<const RenderGraphBuffer*>(&owner);
+  if (buffer == nullptr) {
+    LOG(ERROR) << FORMAT("the buffer: {} can't alias with the resource: {}", GetName(), owner.GetName());
+    return;
+  }
+  m_buffers = buffer->m_buffers;
+  m_isAlias = true;
+  m_isCreate = true;
+  m_isDirty = false;
+  m_version++;
+}
+
+bool
+RenderGraphBuffer::IsAliasCompatible(const RenderGraphResource& another) const {
+  const auto* buffer = dynamic_cast<const RenderGraphBuffer*>(&another);
+  if (buffer == nullptr) return false;
+  return m_type != BufferType::UNIFORM_BUFFER && m_type == buffer->m_type && m_size >= buffer->m_size;
 }
 
 }  // namespace Marbas::details
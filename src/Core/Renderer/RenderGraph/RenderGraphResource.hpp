@@ -2,26 +2,136 @@
 
 #include <stdint.h>
 
+#include <optional>
+
 #include "RHIFactory.hpp"
 #include "RenderGraphNode.hpp"
 
 namespace Marbas {
 
+/**
+ * @brief the size of a texture relative to the output extent of the render graph, e.g. the size of the editor viewport
+ */
+struct RenderGraphRelativeSize {
+  float widthScale = 1.0f;
+  float heightScale = 1.0f;
+};
+
 namespace details {
 
 class RenderGraphResource : public RenderGraphNode {
  public:
-  RenderGraphResource(std::string_view name, RHIFactory* rhiFactory)
-      : RenderGraphNode(name, RenderGraphNodeType::Resource), m_rhiFactory(rhiFactory) {}
+  RenderGraphResource(std::string_view name, RHIFactory* rhiFactory, bool isTransient)
+      : RenderGraphNode(name, RenderGraphNodeType::Resource), m_rhiFactory(rhiFactory), m_isTransient(isTransient) {}
 
+  void
+  Create() {
+    Create(1);
+  }
+
+  /**
+   * @brief create the GPU resource, the transient resource used in several frames in flight needs a copy for every
+   * frame, so the frames don't overwrite the content of each other.
+   *
+   * @param copyCount the count of the copies
+   */
   virtual void
-  Create() = 0;
+  Create(uint32_t copyCount) = 0;
 
+  /**
+   * @brief destroy the GPU resource owned by this resource, it can be created again later
+   */
+  virtual void
+  Release() = 0;
+
+  /**
+   * @brief share the GPU resource of another resource instead of creating a new one, the owner must be created first
+   * and must outlive this resource
+   */
+  virtual void
+  AliasWith(const RenderGraphResource& owner) = 0;
+
+  /**
+   * @brief whether another resource can share the GPU resource of this resource
+   */
   virtual bool
-  IsCreate() = 0;
+  IsAliasCompatible(const RenderGraphResource& another) const = 0;
+
+  /**
+   * @brief the estimated GPU memory size of a copy
+   */
+  virtual uint64_t
+  GetByteSize() const = 0;
+
+  bool
+  IsCreate() const {
+    return m_isCreate;
+  }
+
+  bool
+  IsTransient() const {
+    return m_isTransient;
+  }
+
+  /**
+   * @brief whether the GPU resource is imported from outside the graph, the graph tracks its dependencies but never
+   * creates, aliases or destroys it
+   */
+  bool
+  IsExternal() const {
+    return m_isExternal;
+  }
+
+  /**
+   * @brief whether the content of the previous frame is kept for the temporal techniques, the resource has one more
+   * copy than the frames in flight, the copy written last is read as the history while the next copy is written
+   */
+  bool
+  IsHistory() const {
+    return m_isHistory;
+  }
+
+  /**
+   * @brief whether the create info is changed after the GPU resource is created
+   */
+  bool
+  IsDirty() const {
+    return m_isDirty;
+  }
+
+  /**
+   * @brief the version is increased every time the GPU resource is changed, the pass compares it to find out whether
+   * its framebuffers and descriptor sets are outdated
+   */
+  uint32_t
+  GetVersion() const {
+    return m_version;
+  }
+
+  /**
+   * @brief the content version is increased every time a pass writing the resource is executed, the pass compares it
+   * to find out whether its inputs are changed
+   */
+  uint64_t
+  GetContentVersion() const {
+    return m_contentVersion;
+  }
+
+  void
+  IncreaseContentVersion() {
+    m_contentVersion++;
+  }
 
  protected:
   RHIFactory* m_rhiFactory;
+  bool m_isCreate = false;
+  bool m_isTransient = false;
+  bool m_isAlias = false;
+  bool m_isExternal = false;
+  bool m_isHistory = false;
+  bool m_isDirty = false;
+  uint32_t m_version = 0;
+  uint64_t m_contentVersion = 0;
 };
 
 class RenderGraphTexture final : public RenderGraphResource {
@@ -47,31 +157,231 @@ class RenderGraphTexture final : public RenderGraphResource {
   };
 
  public:
-  RenderGraphTexture(std::string_view name, RHIFactory* rhiFactory, const ImageCreateInfo& createInfo);
+  RenderGraphTexture(std::string_view name, RHIFactory* rhiFactory, const ImageCreateInfo& createInfo,
+                     bool isTransient = false);
+
+  ~RenderGraphTexture() override;
+
+  using RenderGraphResource::Create;
+
+  void
+  Create(uint32_t copyCount) override;
+
+  void
+  Release() override;
+
+  void
+  AliasWith(const RenderGraphResource& owner) override;
+
+  /**
+   * @brief use the images created outside the graph, e.g. the swapchain images, the history images or the textures of
+   * the assets. The images imported before are replaced, e.g. the swapchain is recreated.
+   *
+   * @param createInfo the description of the images, the passes use it to create their render targets
+   * @param images the images, the caller selects the one used in a frame by SetExternalImageIndex
+   */
+  void
+  Import(const ImageCreateInfo& createInfo, const Vector<Image*>& images);
+
+  /**
+   * @brief select the image of the external texture used by the next executions, e.g. the acquired swapchain image
+   */
+  void
+  SetExternalImageIndex(uint32_t index) {
+    m_externalImageIndex = m_images.empty() ? 0 : index % m_images.size();
+  }
+
+  uint32_t
+  GetExternalImageIndex() const {
+    return m_externalImageIndex;
+  }
+
+  /**
+   * @brief keep the content of the previous frame, see RenderGraphResource::IsHistory
+   */
+  void
+  SetHistory() {
+    m_isHistory = true;
+  }
 
-  ~RenderGraphTexture();
+  /**
+   * @brief whether the history copy holds a frame written since the images are created, the history is invalid after
+   * the texture is created or resized
+   */
+  bool
+  IsHistoryValid() const {
+    return m_historyFrameCount > 0;
+  }
 
+  /**
+   * @brief select the copies used by the current frame, it's called before the frame is recorded. The texture moves to
+   * the next copy only if a pass writes it in the frame, so the history is the last written frame even if the writer
+   * is skipped, and the copies used by the other frames in flight aren't overwritten.
+   */
   void
-  Create() override;
+  AdvanceHistory(bool isWritten) {
+    if (m_images.empty()) return;
+    m_historyFrameCount = m_writtenFrameCount;
+    m_historyCopyIndex = m_currentCopyIndex;
+    if (!isWritten) return;
+    m_currentCopyIndex = (m_currentCopyIndex + 1) % m_images.size();
+    m_writtenFrameCount++;
+  }
+
+  uint32_t
+  GetHistoryCopyIndex() const {
+    return m_historyCopyIndex;
+  }
+
+  const ImageCreateInfo&
+  GetCreateInfo() const {
+    return m_imageCreateInfo;
+  }
+
+  /**
+   * @brief change the create info, e.g. resize the texture. The images aren't changed immediately, the render graph
+   * which creates the texture recreates them on the next compiling.
+   */
+  void
+  SetCreateInfo(const ImageCreateInfo& createInfo) {
+    m_imageCreateInfo = createInfo;
+    m_isDirty = true;
+  }
+
+  /**
+   * @brief the estimated GPU memory size of the whole image, include all layers and mipmap levels, the alignment and
+   * multisample are ignored
+   */
+  uint64_t
+  GetByteSize() const override;
 
   bool
-  IsCreate() override {
-    return m_image == nullptr;
+  IsAliasCompatible(const RenderGraphResource& another) const override;
+
+  uint32_t
+  GetCopyCount() const {
+    return static_cast<uint32_t>(m_images.size());
   }
 
+  /**
+   * @brief get the image view of the sub resource
+   *
+   * @param frameIndex the index of the frame in flight, it's ignored if the texture has only one copy
+   */
   ImageView*
-  GetImageView(uint32_t layer = 0, uint32_t layerCount = 1, uint32_t levelBase = 0, uint32_t levelCount = 1);
+  GetImageView(uint32_t layer = 0, uint32_t layerCount = 1, uint32_t levelBase = 0, uint32_t levelCount = 1,
+               uint32_t frameIndex = 0) {
+    return GetCopyImageView(GetCopyIndex(frameIndex), layer, layerCount, levelBase, levelCount);
+  }
+
+  /**
+   * @brief get the image view of a copy, or of an image of the external texture
+   */
+  ImageView*
+  GetCopyImageView(uint32_t copyIndex, uint32_t layer = 0, uint32_t layerCount = 1, uint32_t levelBase = 0,
+                   uint32_t levelCount = 1);
 
   Image*
-  GetImage() {
-    return m_image;
+  GetImage(uint32_t frameIndex = 0) {
+    return m_images.empty() ? nullptr : m_images[GetCopyIndex(frameIndex)];
+  }
+
+  /**
+   * @brief the copy used by the frame in flight, the external texture uses the selected image and the history texture
+   * uses the copy written by the current frame in all frames
+   */
+  uint32_t
+  GetCopyIndex(uint32_t frameIndex) const {
+    if (m_images.empty()) return 0;
+    if (m_isExternal) return m_externalImageIndex;
+    return m_isHistory ? m_currentCopyIndex : frameIndex % m_images.size();
+  }
+
+  const std::optional<RenderGraphRelativeSize>&
+  GetRelativeSize() const {
+    return m_relativeSize;
+  }
+
+  void
+  SetRelativeSize(const std::optional<RenderGraphRelativeSize>& relativeSize) {
+    m_relativeSize = relativeSize;
   }
 
  private:
-  bool m_isCreate = false;
-  Image* m_image = nullptr;
+  using ImageViewMap = HashMap<SubresourceDesc, ImageView*, SubresourceDesc_Hash>;
+
+  Vector<Image*> m_images;
   ImageCreateInfo m_imageCreateInfo;
-  HashMap<SubresourceDesc, ImageView*, SubresourceDesc_Hash> m_imageViews;
+  Vector<ImageViewMap> m_imageViews;  // the image views of each copy
+  std::optional<RenderGraphRelativeSize> m_relativeSize;  // the size follows the output extent if it has value
+  uint32_t m_externalImageIndex = 0;
+  uint32_t m_historyFrameCount = 0;  // the count of the frames written before the current frame
+  uint32_t m_writtenFrameCount = 0;  // the count of the frames written since the images are created
+  uint32_t m_currentCopyIndex = 0;   // the copy written by the current frame
+  uint32_t m_historyCopyIndex = 0;   // the copy written last before the current frame
+};
+
+class RenderGraphBuffer final : public RenderGraphResource {
+ public:
+  RenderGraphBuffer(std::string_view name, RHIFactory* rhiFactory, BufferType type, uint32_t size,
+                    bool isTransient = false);
+
+  ~RenderGraphBuffer() override;
+
+  using RenderGraphResource::Create;
+
+  void
+  Create(uint32_t copyCount) override;
+
+  void
+  Release() override;
+
+  void
+  AliasWith(const RenderGraphResource& owner) override;
+
+  /**
+   * @brief the uniform buffer is updated by the CPU when recording, so all of them must be alive in the whole frame
+   * and can't share the memory. Other buffers can share a large enough buffer of the same type.
+   */
+  bool
+  IsAliasCompatible(const RenderGraphResource& another) const override;
+
+  uint64_t
+  GetByteSize() const override {
+    return m_size;
+  }
+
+  BufferType
+  GetBufferType() const {
+    return m_type;
+  }
+
+  /**
+   * @brief change the size of the buffer, the render graph which creates the buffer recreates it on the next compiling
+   */
+  void
+  SetSize(uint32_t size) {
+    m_size = size;
+    m_isDirty = true;
+  }
+
+  uint32_t
+  GetCopyCount() const {
+    return static_cast<uint32_t>(m_buffers.size());
+  }
+
+  /**
+   * @param frameIndex the index of the frame in flight, it's ignored if the buffer has only one copy
+   */
+  Buffer*
+  GetBuffer(uint32_t frameIndex = 0) {
+    return m_buffers.empty() ? nullptr : m_buffers[frameIndex % m_buffers.size()];
+  }
+
+ private:
+  BufferType m_type;
+  uint32_t m_size;
+  Vector<Buffer*> m_buffers;
 };
 
 };  // namespace details
@@ -82,5 +392,6 @@ struct ResourceHandlerBase {
 };
 
 using RenderGraphTextureHandler = ResourceHandlerBase<details::RenderGraphTexture>;
+using RenderGraphBufferHandler = ResourceHandlerBase<details::RenderGraphBuffer>;
 
 }  // namespace Marbas
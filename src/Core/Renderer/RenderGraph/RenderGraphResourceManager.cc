@@ -3,22 +3,105 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace Marbas {
 
 RenderGraphTextureHandler
-RenderGraphResourceManager::CreateTexture(std::string_view name, const ImageCreateInfo& createInfo) {
+RenderGraphResourceManager::CreateTexture(std::string_view name, const ImageCreateInfo& createInfo, bool isTransient) {
   if (m_textureResLUT.find(std::string(name)) != m_textureResLUT.end()) {
     DLOG(WARNING) << "no need to create the texture resource, beacuse it's existed";
     return m_textureResLUT.at(std::string(name));
   }
-  m_graphTexture.push_back(details::RenderGraphTexture(name, m_rhiFactory, createInfo));
+  m_graphTexture.push_back(std::make_unique<details::RenderGraphTexture>(name, m_rhiFactory, createInfo, isTransient));
   RenderGraphTextureHandler handler;
   handler.index = m_graphTexture.size() - 1;
   m_textureResLUT.insert({std::string(name), handler});
   return handler;
 }
 
+RenderGraphTextureHandler
+RenderGraphResourceManager::AddExternalTexture(std::string_view name, const ImageCreateInfo& createInfo,
+                                               const Vector<Image*>& images) {
+  RenderGraphTextureHandler handler;
+  if (auto iter = m_textureResLUT.find(std::string(name)); iter != m_textureResLUT.end()) {
+    handler = iter->second;
+  } else {
+    m_graphTexture.push_back(std::make_unique<details::RenderGraphTexture>(name, m_rhiFactory, createInfo));
+    handler.index = m_graphTexture.size() - 1;
+    m_textureResLUT.insert({std::string(name), handler});
+  }
+  m_graphTexture[handler.index]->Import(createInfo, images);
+  return handler;
+}
+
+static uint32_t
+GetRelativeExtent(uint32_t outputExtent, float scale) {
+  return std::max(static_cast<uint32_t>(std::lround(outputExtent * scale)), 1u);
+}
+
+RenderGraphTextureHandler
+RenderGraphResourceManager::CreateTexture(std::string_view name, const ImageCreateInfo& createInfo,
+                                          const RenderGraphRelativeSize& relativeSize, bool isTransient) {
+  auto relativeCreateInfo = createInfo;
+  relativeCreateInfo.width = GetRelativeExtent(m_outputWidth, relativeSize.widthScale);
+  relativeCreateInfo.height = GetRelativeExtent(m_outputHeight, relativeSize.heightScale);
+  auto handler = CreateTexture(name, relativeCreateInfo, isTransient);
+  m_graphTexture[handler.index]->SetRelativeSize(relativeSize);
+  return handler;
+}
+
+RenderGraphTextureHandler
+RenderGraphResourceManager::CreateHistoryTexture(std::string_view name, const ImageCreateInfo& createInfo) {
+  auto handler = CreateTexture(name, createInfo);
+  m_graphTexture[handler.index]->SetHistory();
+  return handler;
+}
+
+RenderGraphTextureHandler
+RenderGraphResourceManager::CreateHistoryTexture(std::string_view name, const ImageCreateInfo& createInfo,
+                                                 const RenderGraphRelativeSize& relativeSize) {
+  auto handler = CreateTexture(name, createInfo, relativeSize);
+  m_graphTexture[handler.index]->SetHistory();
+  return handler;
+}
+
+void
+RenderGraphResourceManager::SetOutputExtent(uint32_t width, uint32_t height) {
+  if (width == 0 || height == 0) return;
+  if (width == m_outputWidth && height == m_outputHeight) return;
+  m_outputWidth = width;
+  m_outputHeight = height;
+
+  // only the texture whose size is really changed is recreated
+  for (auto& texture : m_graphTexture) {
+    const auto& relativeSize = texture->GetRelativeSize();
+    if (!relativeSize.has_value()) continue;
+
+    auto createInfo = texture->GetCreateInfo();
+    auto newWidth = GetRelativeExtent(width, relativeSize->widthScale);
+    auto newHeight = GetRelativeExtent(height, relativeSize->heightScale);
+    if (createInfo.width == newWidth && createInfo.height == newHeight) continue;
+    createInfo.width = newWidth;
+    createInfo.height = newHeight;
+    texture->SetCreateInfo(createInfo);
+  }
+  DLOG(INFO) << FORMAT("set the output extent of the render graph to {}x{}", width, height);
+}
+
+RenderGraphBufferHandler
+RenderGraphResourceManager::CreateBuffer(std::string_view name, BufferType type, uint32_t size, bool isTransient) {
+  if (m_bufferResLUT.find(std::string(name)) != m_bufferResLUT.end()) {
+    DLOG(WARNING) << "no need to create the buffer resource, because it's existed";
+    return m_bufferResLUT.at(std::string(name));
+  }
+  m_graphBuffer.push_back(std::make_unique<details::RenderGraphBuffer>(name, m_rhiFactory, type, size, isTransient));
+  RenderGraphBufferHandler handler;
+  handler.index = m_graphBuffer.size() - 1;
+  m_bufferResLUT.insert({std::string(name), handler});
+  return handler;
+}
+
 ImageView*
 RenderGraphResourceManager::GetImageView(std::string_view name, uint32_t baseLayer, uint32_t layerCount,
                                          uint32_t baseLevel, uint32_t levelCount) {
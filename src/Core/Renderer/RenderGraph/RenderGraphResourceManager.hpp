@@ -2,23 +2,88 @@
 
 #include "Common/Common.hpp"
 #include "RHIFactory.hpp"
+#include "RenderGraphPipelineCache.hpp"
 #include "RenderGraphResource.hpp"
 
 namespace Marbas {
 
 class RenderGraphResourceManager final {
  public:
-  RenderGraphResourceManager(RHIFactory* rhiFactory) : m_rhiFactory(rhiFactory) {}
+  RenderGraphResourceManager(RHIFactory* rhiFactory)
+      : m_rhiFactory(rhiFactory), m_pipelineCache(std::make_unique<details::RenderGraphPipelineCache>(rhiFactory)) {}
   ~RenderGraphResourceManager() = default;
 
  public:
+  /**
+   * @brief create a texture resource, the GPU image is created when the render graph compiles.
+   *
+   * @param name the unique name of the texture
+   * @param createInfo image create info
+   * @param isTransient the content of a transient texture is only valid between its first write and its last read in
+   *        a frame, so it may share the image with other transient textures whose lifetimes don't overlap. It must be
+   *        cleared on its first write and can't be used outside the graph.
+   */
   RenderGraphTextureHandler
-  CreateTexture(std::string_view name, const ImageCreateInfo& createInfo);
+  CreateTexture(std::string_view name, const ImageCreateInfo& createInfo, bool isTransient = false);
+
+  /**
+   * @brief create a texture whose size is relative to the output extent, the width and height of the create info are
+   * ignored. The texture is resized when the output extent is changed.
+   *
+   * @param relativeSize the scale of the output extent
+   */
+  RenderGraphTextureHandler
+  CreateTexture(std::string_view name, const ImageCreateInfo& createInfo, const RenderGraphRelativeSize& relativeSize,
+                bool isTransient = false);
+
+  /**
+   * @brief create a texture which keeps the content of the previous frame, e.g. the accumulation of TAA. The pass
+   * writes the current frame by RenderGraphGraphicsBuilder::WriteTexture and reads the previous frame by
+   * ReadHistoryTexture, the render graph swaps them in every frame the texture is written. It has one more copy than
+   * the frames in flight, so the history isn't overwritten by the frames in flight.
+   */
+  RenderGraphTextureHandler
+  CreateHistoryTexture(std::string_view name, const ImageCreateInfo& createInfo);
+
+  RenderGraphTextureHandler
+  CreateHistoryTexture(std::string_view name, const ImageCreateInfo& createInfo,
+                       const RenderGraphRelativeSize& relativeSize);
+
+  /**
+   * @brief set the extent of the final output, e.g. the size of the viewport. The textures created with a relative
+   * size are resized, and their images are recreated when the render graph compiles again.
+   *
+   * @note it's the same as UpdateTexture, the GPU must not use the textures when the render graph compiles
+   */
+  void
+  SetOutputExtent(uint32_t width, uint32_t height);
+
+  uint32_t
+  GetOutputWidth() const {
+    return m_outputWidth;
+  }
+
+  uint32_t
+  GetOutputHeight() const {
+    return m_outputHeight;
+  }
+
+  /**
+   * @brief change the create info of a texture, e.g. resize it. The image is recreated when the render graph compiles
+   * again, and only the passes using the texture recreate their framebuffers and descriptor sets.
+   *
+   * @note the GPU must not use the texture when the render graph compiles, and all graphs using the texture must be
+   * compiled again
+   */
+  void
+  UpdateTexture(RenderGraphTextureHandler handler, const ImageCreateInfo& createInfo) {
+    m_graphTexture[handler.index]->SetCreateInfo(createInfo);
+  }
 
   ImageView*
   GetImageView(RenderGraphTextureHandler handler, uint32_t baseLayer = 0, uint32_t layerCount = 1,
                uint32_t baseLevel = 0, uint32_t levelCount = 1) {
-    return m_graphTexture[handler.index].GetImageView(baseLayer, layerCount, baseLevel, levelCount);
+    return m_graphTexture[handler.index]->GetImageView(baseLayer, layerCount, baseLevel, levelCount);
   }
 
   ImageView*
@@ -30,14 +95,68 @@ class RenderGraphResourceManager final {
     return m_textureResLUT.at(std::string(name));
   }
 
+  /**
+   * @brief import the images created outside the render graph as a texture, so the passes using them are ordered by
+   * the graph like other textures. The graph never creates, aliases or destroys the images, and the passes keep their
+   * declared attachment actions for them. If the texture exists, its images are replaced, e.g. the swapchain is
+   * recreated.
+   *
+   * @param createInfo the description of the images
+   * @param images the images, e.g. all images of the swapchain, the one used in a frame is selected by
+   *        SetExternalImageIndex. Every graphics pass writing the texture has a framebuffer for each of them. It can
+   *        be empty if the passes only access the images by ReadExternalTexture and WriteExternalTexture, e.g. the
+   *        images are owned by the components and bound by the passes themselves.
+   */
   RenderGraphTextureHandler
-  AddExternalTexture(std::string_view name, Image* image);
+  AddExternalTexture(std::string_view name, const ImageCreateInfo& createInfo, const Vector<Image*>& images);
+
+  /**
+   * @brief select the image of the external texture used by the next executions, e.g. the image acquired from the
+   * swapchain. It doesn't need to compile the render graph again.
+   */
+  void
+  SetExternalImageIndex(RenderGraphTextureHandler handler, uint32_t index) {
+    m_graphTexture[handler.index]->SetExternalImageIndex(index);
+  }
+
+  /**
+   * @brief create a buffer resource, the GPU buffer is created when the render graph compiles. The passes declare the
+   * access by RenderGraphGraphicsBuilder::ReadBuffer and WriteBuffer, and get the buffer from the registry.
+   *
+   * @param name the unique name of the buffer
+   * @param type buffer type
+   * @param size the byte size of the buffer
+   * @param isTransient the content of a transient buffer is only valid in a frame, so every frame in flight has its
+   *        own copy, and it may share the memory with other transient buffers whose lifetimes don't overlap.
+   */
+  RenderGraphBufferHandler
+  CreateBuffer(std::string_view name, BufferType type, uint32_t size, bool isTransient = false);
+
+  RenderGraphBufferHandler
+  GetBufferHandler(std::string_view name) {
+    return m_bufferResLUT.at(std::string(name));
+  }
+
+  /**
+   * @brief change the size of a buffer, it's recreated when the render graph compiles again
+   */
+  void
+  ResizeBuffer(RenderGraphBufferHandler handler, uint32_t size) {
+    m_graphBuffer[handler.index]->SetSize(size);
+  }
 
  public:
   RHIFactory* m_rhiFactory = nullptr;
-  Vector<details::RenderGraphTexture> m_graphTexture;
+  Vector<std::unique_ptr<details::RenderGraphTexture>> m_graphTexture;
+  Vector<std::unique_ptr<details::RenderGraphBuffer>> m_graphBuffer;
 
   std::unordered_map<std::string, RenderGraphTextureHandler> m_textureResLUT;
+  std::unordered_map<std::string, RenderGraphBufferHandler> m_bufferResLUT;
+
+  uint32_t m_outputWidth = 1;
+  uint32_t m_outputHeight = 1;
+
+  std::unique_ptr<details::RenderGraphPipelineCache> m_pipelineCache;
 };
 
 }  // namespace Marbas
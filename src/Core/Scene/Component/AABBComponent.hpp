@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AssetManager/ModelAsset.hpp"
+#include "Common/BoundingBox.hpp"
 #include "Common/Frustum.hpp"
 #include "Common/MathCommon.hpp"
 
@@ -39,6 +40,14 @@ struct AABBComponent final {
     return m_halfExtent + m_halfExtent;
   }
 
+  /**
+   * @brief the bounding box in the model space
+   */
+  BoundingBox
+  GetBoundingBox() const {
+    return {m_center - m_halfExtent, m_center + m_halfExtent};
+  }
+
   bool
   IsOnFrustum(const Frustum& frustum, const glm::mat4& tranMatrix) const;
 
@@ -4,36 +4,45 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <mutex>
 
 #include "Core/Scene/Component/SerializeComponent/LightComponent.hpp"
 
 namespace Marbas {
 
-LightRenderComponent::LightRenderComponent(RHIFactory* rhiFactory) : m_rhiFactory(rhiFactory) {
+LightRenderComponent::LightRenderComponent(RHIFactory* rhiFactory, uint32_t frameInFlightCount)
+    : m_rhiFactory(rhiFactory) {
   auto bufCtx = rhiFactory->GetBufferContext();
   auto pipelineCtx = rhiFactory->GetPipelineContext();
   auto bufferSize = sizeof(DirectionLightInfoList);
   auto bufferData = &m_directionalLightInfos;
-  m_directionalLightBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, bufferData, bufferSize, false);
-
-  m_lightSet = pipelineCtx->CreateDescriptorSet(GetDescriptorSetArgument());
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_lightSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_directionalLightBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
+  for (uint32_t i = 0; i < frameInFlightCount; i++) {
+    auto* buffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, bufferData, bufferSize, false);
+    auto set = pipelineCtx->CreateDescriptorSet(GetDescriptorSetArgument());
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = buffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_directionalLightBuffers.push_back(buffer);
+    m_lightSets.push_back(set);
+  }
 }
 
 LightRenderComponent::~LightRenderComponent() {
   auto bufCtx = m_rhiFactory->GetBufferContext();
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
 
-  pipelineCtx->DestroyDescriptorSet(m_lightSet);
-  bufCtx->DestroyBuffer(m_directionalLightBuffer);
+  for (auto set : m_lightSets) {
+    pipelineCtx->DestroyDescriptorSet(set);
+  }
+  for (auto* buffer : m_directionalLightBuffers) {
+    bufCtx->DestroyBuffer(buffer);
+  }
 }
 
 const DescriptorSetArgument&
@@ -81,8 +90,6 @@ LightRenderComponent::UpdateLight(const DirectionLightComponent& light) {
   auto& lightInfo = m_directionalLightInfos.directionalLightInfo[*light.lightIndex];
   lightInfo.directionShadow = glm::vec4(light.m_direction, 0);
   lightInfo.colorEnergy = glm::vec4(light.m_color, light.m_energy);
-
-  UpdateGPUBuffer(light);
 }
 
 void
@@ -101,24 +108,16 @@ LightRenderComponent::UpdateLight(const DirectionLightComponent& light, const Di
   for (int i = 0; i < shadow.m_cascadePlane.size(); i++) {
     lightInfo.cascadePlaneDistances[i].x = shadow.m_cascadePlane[i];
   }
-
-  UpdateGPUBuffer(light);
 }
 
 void
-LightRenderComponent::UpdateGPUBuffer(const DirectionLightComponent& light) {
+LightRenderComponent::UpdateGPUBuffer(uint32_t frameIndex) {
   auto bufferContext = m_rhiFactory->GetBufferContext();
 
-  // update index
-  size_t size = offsetof(DirectionLightInfoList, directionalLightInfo[0]);
-  bufferContext->UpdateBuffer(m_directionalLightBuffer, &m_directionalLightInfos, size, 0);
-
-  // update details info
-  auto index = *light.lightIndex;
-  auto& lightInfo = m_directionalLightInfos.directionalLightInfo[index];
-  uintptr_t offset = offsetof(DirectionLightInfoList, directionalLightInfo[0]) + index * size;
-  size = sizeof(DirectionLightInfo);
-  bufferContext->UpdateBuffer(m_directionalLightBuffer, &lightInfo, size, offset);
+  // the copy of a frame in flight isn't updated in the other frames, so write the count and all lights in use
+  const auto lightCount = std::min(m_directionalLightInfos.lightCount, MAX_DIRECTION_LIGHT_COUNT);
+  const auto size = offsetof(DirectionLightInfoList, directionalLightInfo[0]) + lightCount * sizeof(DirectionLightInfo);
+  bufferContext->UpdateBuffer(m_directionalLightBuffers[frameIndex], &m_directionalLightInfos, size, 0);
 }
 
 bool
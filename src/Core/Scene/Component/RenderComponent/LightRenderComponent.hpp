@@ -26,11 +26,12 @@ struct LightRenderComponent {
     alignas(16) DirectionLightInfo directionalLightInfo[MAX_DIRECTION_LIGHT_COUNT];
   };
 
-  uintptr_t m_lightSet;
-  Buffer* m_directionalLightBuffer;
+  // the light buffer is updated by the CPU every frame, so every frame in flight has its own copy and descriptor set
+  std::vector<uintptr_t> m_lightSets;
+  std::vector<Buffer*> m_directionalLightBuffers;
 
  public:
-  LightRenderComponent(RHIFactory* rhiFactory);
+  LightRenderComponent(RHIFactory* rhiFactory, uint32_t frameInFlightCount = 1);
   ~LightRenderComponent();
 
   static const DescriptorSetArgument&
@@ -48,9 +49,13 @@ struct LightRenderComponent {
   void
   UpdateLight(const DirectionLightComponent& light, const DirectionShadowComponent& shadow);
 
- private:
+  /**
+   * @brief write the lights to the buffer of a frame in flight, it's called after all lights are updated
+   */
   void
-  UpdateGPUBuffer(const DirectionLightComponent& light);
+  UpdateGPUBuffer(uint32_t frameIndex);
+
+ private:
 
   bool
   CheckLight(const DirectionLightComponent& light);
@@ -2,14 +2,29 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace Marbas {
 
-MeshRenderComponent::MeshRenderComponent(RHIFactory* rhiFactory, uintptr_t sampler, ImageView* emptyImageView)
-    : m_rhiFactory(rhiFactory), m_externSampler(sampler), m_externEmptyImageView(emptyImageView) {}
+MeshRenderComponent::MeshRenderComponent(RHIFactory* rhiFactory, uintptr_t sampler, ImageView* emptyImageView,
+                                         uint32_t frameInFlightCount)
+    : m_isMaterialInfoDirty(frameInFlightCount, false),
+      m_isMaterialImageDirty(frameInFlightCount, false),
+      m_rhiFactory(rhiFactory),
+      m_externSampler(sampler),
+      m_externEmptyImageView(emptyImageView) {
+  m_materialImageViews.fill(emptyImageView);
+}
 
 MeshRenderComponent::~MeshRenderComponent() {
   auto bufCtx = m_rhiFactory->GetBufferContext();
-  bufCtx->DestroyBuffer(m_materialInfoBuffer);
+  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+  for (auto* buffer : m_materialInfoBuffers) {
+    bufCtx->DestroyBuffer(buffer);
+  }
+  for (auto set : m_descriptorSets) {
+    pipelineCtx->DestroyDescriptorSet(set);
+  }
 }
 
 void
@@ -20,16 +35,14 @@ MeshRenderComponent::Init(Mesh& mesh) {
 }
 
 void
-MeshRenderComponent::Update(Mesh& mesh) {
+MeshRenderComponent::Update(Mesh& mesh, uint32_t frameIndex) {
   if (mesh.m_materialTexChanged) {
     UpdateMaterial(mesh);
     UpdateMaterialInfo(mesh);
-    return;
   } else if (mesh.m_materialValueChanged) {
     UpdateMaterialInfo(mesh);
-    return;
   }
-  return;
+  UpdateGPUData(frameIndex);
 }
 
 const DescriptorSetArgument&
@@ -51,16 +64,18 @@ void
 MeshRenderComponent::CreateMeshDescriptorSet(const Mesh& mesh) {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
   const auto& argument = GetDescriptorSetArgument();
-  m_descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
-
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_descriptorSet,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 0,
-      .buffer = m_materialInfoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
+  for (auto* materialBuffer : m_materialInfoBuffers) {
+    auto descriptorSet = pipelineCtx->CreateDescriptorSet(argument);
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = descriptorSet,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 0,
+        .buffer = materialBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_descriptorSets.push_back(descriptorSet);
+  }
 }
 
 void
@@ -85,8 +100,10 @@ MeshRenderComponent::CreateMaterialBuffer(Mesh& mesh) {
 
   constexpr auto materialSize = sizeof(MeshRenderComponent::MaterialInfo);
   auto& materialInfo = m_materialInfo;
-  auto* materialBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &materialInfo, materialSize, false);
-  m_materialInfoBuffer = materialBuffer;
+  for (size_t i = 0; i < m_isMaterialInfoDirty.size(); i++) {
+    auto* materialBuffer = bufCtx->CreateBuffer(BufferType::UNIFORM_BUFFER, &materialInfo, materialSize, false);
+    m_materialInfoBuffers.push_back(materialBuffer);
+  }
 }
 
 void
@@ -101,15 +118,12 @@ MeshRenderComponent::UpdateMaterialInfo(const Mesh& mesh) {
   m_materialInfo.metallicValue = mesh.m_material.m_metalnessValue;
   m_materialInfo.roughnessValue = mesh.m_material.m_roughnessValue;
 
-  auto bufCtx = m_rhiFactory->GetBufferContext();
-  auto bufferSize = sizeof(MeshRenderComponent::MaterialInfo);
-  bufCtx->UpdateBuffer(m_materialInfoBuffer, &m_materialInfo, bufferSize, false);
+  // the buffers may be still used by the other frames in flight, so they are written when their frames are updated
+  std::fill(m_isMaterialInfoDirty.begin(), m_isMaterialInfoDirty.end(), true);
 }
 
 void
 MeshRenderComponent::UpdateMaterial(Mesh& mesh) {
-  auto bufCtx = m_rhiFactory->GetBufferContext();
-  auto pipelineCtx = m_rhiFactory->GetPipelineContext();
   auto textureManager = AssetManager<TextureAsset>::GetInstance();
   auto textureGPUManager = TextureGPUDataManager::GetInstance();
 
@@ -124,23 +138,13 @@ MeshRenderComponent::UpdateMaterial(Mesh& mesh) {
     return textureGPUManager->TryGet(asset);
   };
 
+  // the sets may be still used by the other frames in flight, so the images are bound when their frames are updated
   auto bindImage = [&](auto& textureAsset, uint16_t bindingPoint) {
-    auto imageView = textureAsset->GetImageView();
-    pipelineCtx->BindImage(BindImageInfo{
-        .descriptorSet = m_descriptorSet,
-        .bindingPoint = bindingPoint,
-        .imageView = imageView,
-        .sampler = m_externSampler,
-    });
+    m_materialImageViews[bindingPoint - 1] = textureAsset->GetImageView();
   };
 
   auto bindEmptyImage = [&](uint16_t bindingPoint) {
-    pipelineCtx->BindImage(BindImageInfo{
-        .descriptorSet = m_descriptorSet,
-        .bindingPoint = bindingPoint,
-        .imageView = m_externEmptyImageView,
-        .sampler = m_externSampler,
-    });
+    m_materialImageViews[bindingPoint - 1] = m_externEmptyImageView;
   };
 
   // update descriptor set binding
@@ -207,6 +211,30 @@ MeshRenderComponent::UpdateMaterial(Mesh& mesh) {
   } else {
     bindEmptyImage(bindingPoint);
   }
+  std::fill(m_isMaterialImageDirty.begin(), m_isMaterialImageDirty.end(), true);
+}
+
+void
+MeshRenderComponent::UpdateGPUData(uint32_t frameIndex) {
+  if (m_isMaterialImageDirty[frameIndex]) {
+    auto pipelineCtx = m_rhiFactory->GetPipelineContext();
+    for (size_t i = 0; i < m_materialImageViews.size(); i++) {
+      pipelineCtx->BindImage(BindImageInfo{
+          .descriptorSet = m_descriptorSets[frameIndex],
+          .bindingPoint = static_cast<uint16_t>(i + 1),
+          .imageView = m_materialImageViews[i],
+          .sampler = m_externSampler,
+      });
+    }
+    m_isMaterialImageDirty[frameIndex] = false;
+  }
+
+  if (m_isMaterialInfoDirty[frameIndex]) {
+    auto bufCtx = m_rhiFactory->GetBufferContext();
+    auto bufferSize = sizeof(MeshRenderComponent::MaterialInfo);
+    bufCtx->UpdateBuffer(m_materialInfoBuffers[frameIndex], &m_materialInfo, bufferSize, 0);
+    m_isMaterialInfoDirty[frameIndex] = false;
+  }
 }
 
 }  // namespace Marbas
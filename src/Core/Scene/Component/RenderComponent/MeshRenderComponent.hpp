@@ -11,18 +11,23 @@ struct MeshRenderComponent {
   Buffer* m_vertexBuffer = nullptr;
   Buffer* m_indexBuffer = nullptr;
   size_t m_indexCount = 0;
-  uintptr_t m_descriptorSet;
+  std::vector<uintptr_t> m_descriptorSets;  // the material set of each frame in flight
 
  public:
-  MeshRenderComponent(RHIFactory* rhiFactory, uintptr_t sampler, ImageView* emptyImageView);
+  MeshRenderComponent(RHIFactory* rhiFactory, uintptr_t sampler, ImageView* emptyImageView,
+                      uint32_t frameInFlightCount = 1);
   ~MeshRenderComponent();
 
  public:
   void
   Init(Mesh& mesh);
 
+  /**
+   * @brief update the material if it's changed, and write it to the buffer and the set of a frame in flight. The
+   * other frames in flight are updated when they are rendered again.
+   */
   void
-  Update(Mesh& mesh);
+  Update(Mesh& mesh, uint32_t frameIndex);
 
   static const DescriptorSetArgument&
   GetDescriptorSetArgument();
@@ -43,6 +48,9 @@ struct MeshRenderComponent {
   void
   UpdateMaterial(Mesh& mesh);
 
+  void
+  UpdateGPUData(uint32_t frameIndex);
+
  private:
   struct MaterialInfo {
     glm::ivec4 texInfo = glm::vec4(0);
@@ -50,7 +58,10 @@ struct MeshRenderComponent {
     glm::float32 metallicValue;
     glm::float32 roughnessValue;
   } m_materialInfo;
-  Buffer* m_materialInfoBuffer = nullptr;
+  std::array<ImageView*, 4> m_materialImageViews;  // the diffuse, normal, roughness and metallic textures
+  std::vector<Buffer*> m_materialInfoBuffers;
+  std::vector<bool> m_isMaterialInfoDirty;  // indexed by the frame in flight
+  std::vector<bool> m_isMaterialImageDirty;
   RHIFactory* m_rhiFactory = nullptr;
 
   uintptr_t m_externSampler;
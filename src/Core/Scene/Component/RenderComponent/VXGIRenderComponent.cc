@@ -7,31 +7,39 @@
 
 namespace Marbas {
 
-VXGIGlobalComponent::VXGIGlobalComponent(RHIFactory* rhiFactory) : m_rhiFactory(rhiFactory) {
+VXGIGlobalComponent::VXGIGlobalComponent(RHIFactory* rhiFactory, uint32_t frameInFlightCount)
+    : m_rhiFactory(rhiFactory), m_boundRadianceViews(frameInFlightCount, {nullptr}) {
   using enum BufferType;
 
   auto* bufCtx = rhiFactory->GetBufferContext();
   auto* pipelineCtx = rhiFactory->GetPipelineContext();
 
-  m_infoBuffer = bufCtx->CreateBuffer(UNIFORM_BUFFER, &m_voxelsInfo, sizeof(VoxelInfo), false);
-  m_set = pipelineCtx->CreateDescriptorSet(GetDescriptorSetArgument());
-
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_set,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 1,
-      .buffer = m_infoBuffer,
-      .offset = 0,
-      .arrayElement = 0,
-  });
+  for (uint32_t i = 0; i < frameInFlightCount; i++) {
+    auto* infoBuffer = bufCtx->CreateBuffer(UNIFORM_BUFFER, &m_voxelsInfo, sizeof(VoxelInfo), false);
+    auto set = pipelineCtx->CreateDescriptorSet(GetDescriptorSetArgument());
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = set,
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 1,
+        .buffer = infoBuffer,
+        .offset = 0,
+        .arrayElement = 0,
+    });
+    m_infoBuffers.push_back(infoBuffer);
+    m_sets.push_back(set);
+  }
 }
 
 VXGIGlobalComponent::~VXGIGlobalComponent() {
   auto* bufCtx = m_rhiFactory->GetBufferContext();
   auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
 
-  bufCtx->DestroyBuffer(m_infoBuffer);
-  pipelineCtx->DestroyDescriptorSet(m_set);
+  for (auto* infoBuffer : m_infoBuffers) {
+    bufCtx->DestroyBuffer(infoBuffer);
+  }
+  for (auto set : m_sets) {
+    pipelineCtx->DestroyDescriptorSet(set);
+  }
 }
 
 const DescriptorSetArgument&
@@ -49,30 +57,39 @@ VXGIGlobalComponent::BindVoxelProbe(const VoxelRenderComponent& component, uint3
   m_voxelsInfo.m_voxelInfo[index].pos = component.m_voxelInfo.pos;
   m_voxelsInfo.m_voxelInfo[index].voxelSizeResolution = component.m_voxelInfo.voxelSizeResolution;
 
-  auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
-  auto* bufCtx = m_rhiFactory->GetBufferContext();
-
   m_voxelRadiances[index] = component.m_voxelRadiance;
-  pipelineCtx->BindImage(BindImageInfo{
-      .descriptorSet = m_set,
-      .bindingPoint = static_cast<uint16_t>(index),
-      .imageView = component.m_voxelRadianceView,
-      .sampler = component.m_radianceSampler,
-  });
-  bufCtx->UpdateBuffer(m_infoBuffer, &m_voxelsInfo, sizeof(VoxelInfo), 0);
+  m_voxelRadianceViews[index] = component.m_voxelRadianceView;
+  m_radianceSamplers[index] = component.m_radianceSampler;
 }
 
 void
 VXGIGlobalComponent::UpdateVoxelProbe(const VoxelRenderComponent& component, uint32_t index) {
   m_voxelsInfo.m_voxelInfo[index].pos = component.m_voxelInfo.pos;
   m_voxelsInfo.m_voxelInfo[index].voxelSizeResolution = component.m_voxelInfo.voxelSizeResolution;
+}
 
+void
+VXGIGlobalComponent::UpdateGPUData(uint32_t frameIndex) {
   auto* pipelineCtx = m_rhiFactory->GetPipelineContext();
   auto* bufCtx = m_rhiFactory->GetBufferContext();
-  bufCtx->UpdateBuffer(m_infoBuffer, &m_voxelsInfo, sizeof(VoxelInfo), 0);
+
+  // the set may be still used by the other frames in flight, so only the set of this frame is bound again
+  auto& boundViews = m_boundRadianceViews[frameIndex];
+  for (uint32_t i = 0; i < maxProbeCount; i++) {
+    if (m_voxelRadianceViews[i] == nullptr || boundViews[i] == m_voxelRadianceViews[i]) continue;
+    pipelineCtx->BindImage(BindImageInfo{
+        .descriptorSet = m_sets[frameIndex],
+        .bindingPoint = static_cast<uint16_t>(i),
+        .imageView = m_voxelRadianceViews[i],
+        .sampler = m_radianceSamplers[i],
+    });
+    boundViews[i] = m_voxelRadianceViews[i];
+  }
+  bufCtx->UpdateBuffer(m_infoBuffers[frameIndex], &m_voxelsInfo, sizeof(VoxelInfo), 0);
 }
 
-VoxelRenderComponent::VoxelRenderComponent(RHIFactory* rhiFactory, const glm::vec3& size, uint32_t resolution)
+VoxelRenderComponent::VoxelRenderComponent(RHIFactory* rhiFactory, const glm::vec3& size, uint32_t frameInFlightCount,
+                                           uint32_t resolution)
     : m_rhiFactory(rhiFactory), m_resolution(resolution) {
   using enum BufferType;
 
@@ -97,11 +114,12 @@ VoxelRenderComponent::VoxelRenderComponent(RHIFactory* rhiFactory, const glm::ve
   m_voxelRadiance = bufCtx->CreateImage(createInfo);
 
   m_voxelInfo.voxelSizeResolution.w = resolution;
-  m_giInfo = bufCtx->CreateBuffer(UNIFORM_BUFFER, &m_voxelInfo, sizeof(VoxelInfo), false);
-
-  m_setForVoxelization = pipelineCtx->CreateDescriptorSet(GetVoxelizationDescriptorArgument());
+  for (uint32_t i = 0; i < frameInFlightCount; i++) {
+    m_giInfos.push_back(bufCtx->CreateBuffer(UNIFORM_BUFFER, &m_voxelInfo, sizeof(VoxelInfo), false));
+    m_setsForVoxelization.push_back(pipelineCtx->CreateDescriptorSet(GetVoxelizationDescriptorArgument()));
+    m_setsForLightInject.push_back(pipelineCtx->CreateDescriptorSet(GetLightInjectDescriptorArgument()));
+  }
   // m_setForStaticVoxelization = pipelineCtx->CreateDescriptorSet(GetVoxelizationDescriptorArgument());
-  m_setForLightInject = pipelineCtx->CreateDescriptorSet(GetLightInjectDescriptorArgument());
 
   // create image view
   m_voxelDiffuseView = bufCtx->CreateImageView(ImageViewCreateInfo{
@@ -206,6 +224,16 @@ VoxelRenderComponent::~VoxelRenderComponent() {
 
   pipelineCtx->DestroySampler(m_sampler);
   pipelineCtx->DestroySampler(m_radianceSampler);
+
+  for (auto* giInfo : m_giInfos) {
+    bufCtx->DestroyBuffer(giInfo);
+  }
+  for (auto set : m_setsForVoxelization) {
+    pipelineCtx->DestroyDescriptorSet(set);
+  }
+  for (auto set : m_setsForLightInject) {
+    pipelineCtx->DestroyDescriptorSet(set);
+  }
 }
 
 DescriptorSetArgument&
@@ -232,24 +260,26 @@ VoxelRenderComponent::GetLightInjectDescriptorArgument() {
 void
 VoxelRenderComponent::BindVoxelizationSet() {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  pipelineCtx->BindStorageImage(BindStorageImageInfo{
-      .descriptorSet = m_setForVoxelization,
-      .bindingPoint = 0,
-      .imageView = m_diffuseVoxelizationView,
-  });
-  pipelineCtx->BindStorageImage(BindStorageImageInfo{
-      .descriptorSet = m_setForVoxelization,
-      .bindingPoint = 1,
-      .imageView = m_normalVoxelizationView,
-  });
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_setForVoxelization,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 2,
-      .buffer = m_giInfo,
-      .offset = 0,
-      .arrayElement = 0,
-  });
+  for (size_t i = 0; i < m_setsForVoxelization.size(); i++) {
+    pipelineCtx->BindStorageImage(BindStorageImageInfo{
+        .descriptorSet = m_setsForVoxelization[i],
+        .bindingPoint = 0,
+        .imageView = m_diffuseVoxelizationView,
+    });
+    pipelineCtx->BindStorageImage(BindStorageImageInfo{
+        .descriptorSet = m_setsForVoxelization[i],
+        .bindingPoint = 1,
+        .imageView = m_normalVoxelizationView,
+    });
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = m_setsForVoxelization[i],
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 2,
+        .buffer = m_giInfos[i],
+        .offset = 0,
+        .arrayElement = 0,
+    });
+  }
 }
 
 void
@@ -278,35 +308,37 @@ VoxelRenderComponent::BindStaticVoxelizationSet() {
 void
 VoxelRenderComponent::BindLightInjectSet() {
   auto pipelineCtx = m_rhiFactory->GetPipelineContext();
-  pipelineCtx->BindImage(BindImageInfo{
-      .descriptorSet = m_setForLightInject,
-      .bindingPoint = 0,
-      .imageView = m_voxelDiffuseView,
-      .sampler = m_sampler,
-  });
-  pipelineCtx->BindImage(BindImageInfo{
-      .descriptorSet = m_setForLightInject,
-      .bindingPoint = 1,
-      .imageView = m_voxelNormalView,
-      .sampler = m_sampler,
-  });
-  pipelineCtx->BindStorageImage(BindStorageImageInfo{
-      .descriptorSet = m_setForLightInject,
-      .bindingPoint = 2,
-      .imageView = m_voxelRadianceView,
-  });
-  pipelineCtx->BindBuffer(BindBufferInfo{
-      .descriptorSet = m_setForLightInject,
-      .descriptorType = DescriptorType::UNIFORM_BUFFER,
-      .bindingPoint = 3,
-      .buffer = m_giInfo,
-      .offset = 0,
-      .arrayElement = 0,
-  });
+  for (size_t i = 0; i < m_setsForLightInject.size(); i++) {
+    pipelineCtx->BindImage(BindImageInfo{
+        .descriptorSet = m_setsForLightInject[i],
+        .bindingPoint = 0,
+        .imageView = m_voxelDiffuseView,
+        .sampler = m_sampler,
+    });
+    pipelineCtx->BindImage(BindImageInfo{
+        .descriptorSet = m_setsForLightInject[i],
+        .bindingPoint = 1,
+        .imageView = m_voxelNormalView,
+        .sampler = m_sampler,
+    });
+    pipelineCtx->BindStorageImage(BindStorageImageInfo{
+        .descriptorSet = m_setsForLightInject[i],
+        .bindingPoint = 2,
+        .imageView = m_voxelRadianceView,
+    });
+    pipelineCtx->BindBuffer(BindBufferInfo{
+        .descriptorSet = m_setsForLightInject[i],
+        .descriptorType = DescriptorType::UNIFORM_BUFFER,
+        .bindingPoint = 3,
+        .buffer = m_giInfos[i],
+        .offset = 0,
+        .arrayElement = 0,
+    });
+  }
 }
 
 void
-VoxelRenderComponent::UpdateVoxelInfo(const glm::vec3& size, const glm::vec3& pos) {
+VoxelRenderComponent::UpdateVoxelInfo(uint32_t frameIndex, const glm::vec3& size, const glm::vec3& pos) {
   m_voxelInfo.voxelSizeResolution.x = size.x / m_voxelInfo.voxelSizeResolution.w;
   m_voxelInfo.voxelSizeResolution.y = size.y / m_voxelInfo.voxelSizeResolution.w;
   m_voxelInfo.voxelSizeResolution.z = size.z / m_voxelInfo.voxelSizeResolution.w;
@@ -326,6 +358,6 @@ VoxelRenderComponent::UpdateVoxelInfo(const glm::vec3& size, const glm::vec3& po
   m_voxelInfo.projZ = projectMatrixZ * viewZ;
 
   auto bufCtx = m_rhiFactory->GetBufferContext();
-  bufCtx->UpdateBuffer(m_giInfo, &m_voxelInfo, sizeof(VoxelInfo), 0);
+  bufCtx->UpdateBuffer(m_giInfos[frameIndex], &m_voxelInfo, sizeof(VoxelInfo), 0);
 }
 };  // namespace Marbas
@@ -24,8 +24,13 @@ struct VXGIGlobalComponent {
   } m_voxelsInfo;
   RHIFactory* m_rhiFactory;
 
+  // the radiance of the probes is bound to the set of a frame in flight when the frame is updated
+  std::array<ImageView*, maxProbeCount> m_voxelRadianceViews = {nullptr};
+  std::array<uintptr_t, maxProbeCount> m_radianceSamplers = {0};
+  std::vector<std::array<ImageView*, maxProbeCount>> m_boundRadianceViews;
+
  public:
-  VXGIGlobalComponent(RHIFactory* rhiFactory);
+  VXGIGlobalComponent(RHIFactory* rhiFactory, uint32_t frameInFlightCount = 1);
   ~VXGIGlobalComponent();
 
   void
@@ -34,14 +39,22 @@ struct VXGIGlobalComponent {
   void
   UpdateVoxelProbe(const VoxelRenderComponent& component, uint32_t index = 0);
 
+  /**
+   * @brief write the probes bound and updated in this frame to the buffer and the set of a frame in flight
+   */
+  void
+  UpdateGPUData(uint32_t frameIndex);
+
  public:
   static const DescriptorSetArgument&
   GetDescriptorSetArgument();
 
  public:
   std::array<Image*, maxProbeCount> m_voxelRadiances;
-  Buffer* m_infoBuffer;
-  uintptr_t m_set;
+
+  // the probes are updated by the CPU every frame, so every frame in flight has its own buffer and descriptor set
+  std::vector<Buffer*> m_infoBuffers;
+  std::vector<uintptr_t> m_sets;
 };
 
 struct VoxelRenderComponent {
@@ -71,19 +84,22 @@ struct VoxelRenderComponent {
   Image* m_voxelDiffuse = nullptr;
   Image* m_voxelNormal = nullptr;
   Image* m_voxelRadiance = nullptr;
-  Buffer* m_giInfo = nullptr;
+
+  // the voxel info is updated by the CPU every frame, so every frame in flight has its own buffer and descriptor sets
+  std::vector<Buffer*> m_giInfos;
   // uintptr_t m_setForStaticVoxelization;
-  uintptr_t m_setForVoxelization;  // 用于体素化场景的descriptor set
-  uintptr_t m_setForLightInject;   // 用于光线注入的descriptor set
+  std::vector<uintptr_t> m_setsForVoxelization;  // 用于体素化场景的descriptor set
+  std::vector<uintptr_t> m_setsForLightInject;   // 用于光线注入的descriptor set
   uint32_t m_resolution;
 
  public:
-  VoxelRenderComponent(RHIFactory* rhiFactory, const glm::vec3& size, uint32_t resolution = 256);
+  VoxelRenderComponent(RHIFactory* rhiFactory, const glm::vec3& size, uint32_t frameInFlightCount = 1,
+                       uint32_t resolution = 256);
   ~VoxelRenderComponent();
 
  public:
   void
-  UpdateVoxelInfo(const glm::vec3& size, const glm::vec3& pos = glm::vec3(0, 0, 0));
+  UpdateVoxelInfo(uint32_t frameIndex, const glm::vec3& size, const glm::vec3& pos = glm::vec3(0, 0, 0));
 
  public:
   static DescriptorSetArgument&
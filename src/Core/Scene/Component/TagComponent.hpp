@@ -6,12 +6,6 @@ namespace Marbas {
  * tag for renderable
  */
 
-/**
- * @class Renderable
- * @brief a tag means the node can be rendered
- */
-struct RenderableTag {};
-
 /**
  * @class RenderPreparedTag
  * @brief the node has prepared all the data which is needed by renderer
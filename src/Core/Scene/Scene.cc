@@ -128,4 +128,66 @@ Scene::GetChildrenCount(entt::entity node) const {
   return hierarchyComponent.children.size();
 }
 
+void
+Scene::UpdateBounds(entt::entity entity, const BoundingBox& box) {
+  auto iter = m_boundsSlots.find(entity);
+  if (iter == m_boundsSlots.end()) {
+    auto proxy = m_bvh.Insert(box, entt::to_integral(entity));
+    m_boundsSlots[entity] = {proxy, static_cast<uint32_t>(m_boundsEntities.size())};
+    m_boundsEntities.push_back(entity);
+    m_worldBounds.Push(box);
+  } else {
+    m_bvh.Move(iter->second.proxy, box);
+    m_worldBounds.Set(iter->second.index, box);
+  }
+}
+
+void
+Scene::RemoveBounds(entt::entity entity) {
+  auto iter = m_boundsSlots.find(entity);
+  if (iter == m_boundsSlots.end()) return;
+  auto [proxy, index] = iter->second;
+  m_boundsSlots.erase(iter);
+  m_bvh.Remove(proxy);
+
+  // the last bounding box is moved to the removed one
+  m_worldBounds.RemoveSwapBack(index);
+  m_boundsEntities[index] = m_boundsEntities.back();
+  m_boundsEntities.pop_back();
+  if (index < m_boundsEntities.size()) {
+    m_boundsSlots[m_boundsEntities[index]].index = index;
+  }
+}
+
+void
+Scene::RemoveStaleBounds() {
+  for (auto i = static_cast<int64_t>(m_boundsEntities.size()) - 1; i >= 0; i--) {
+    auto entity = m_boundsEntities[i];
+    if (!m_world.valid(entity) || !m_world.all_of<AABBComponent>(entity)) {
+      RemoveBounds(entity);
+    }
+  }
+}
+
+void
+Scene::CullFrustum(const Frustum& frustum, Vector<entt::entity>& visible) const {
+  Vector<uint32_t> indices;
+  m_worldBounds.CullFrustum(frustum, indices);
+  for (auto index : indices) {
+    visible.push_back(m_boundsEntities[index]);
+  }
+}
+
+entt::entity
+Scene::Pick(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const {
+  entt::entity result = entt::null;
+  QueryRay(origin, direction, maxDistance, [&](entt::entity entity, float distance) {
+    if (distance < maxDistance) {
+      maxDistance = distance;
+      result = entity;
+    }
+  });
+  return result;
+}
+
 }  // namespace Marbas
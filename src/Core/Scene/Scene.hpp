@@ -4,6 +4,8 @@
 #include <entt/entity/observer.hpp>
 #include <entt/entt.hpp>
 
+#include "Common/AABBTree.hpp"
+#include "Common/BoundingBoxArray.hpp"
 #include "Common/Common.hpp"
 #include "Common/EditorCamera.hpp"
 #include "Component/Component.hpp"
@@ -74,12 +76,30 @@ class Scene {
     }
   }
 
+  /**
+   * @brief emit the update signal of the component without changing it
+   */
+  template <typename Component>
+  void
+  Patch(const entt::entity entity) {
+    m_world.patch<Component>(entity);
+  }
+
   template <typename Component>
   void
   Remove(const entt::entity entity) {
     m_world.remove<Component>(entity);
   }
 
+  /**
+   * @brief sort the storage of the component, so the component is iterated in the order of the compare function
+   */
+  template <typename Component, typename Compare>
+  void
+  Sort(Compare&& compare) {
+    m_world.sort<Component>(std::forward<Compare>(compare));
+  }
+
   template <typename... Components>
   bool
   AnyOf(const entt::entity& entity) const {
@@ -92,6 +112,22 @@ class Scene {
     observer.connect(m_world, std::forward<Collector>(collector));
   }
 
+  /**
+   * @brief call the member function of the instance when the component is removed from an entity or the entity is
+   * destroyed, the function is called with the world and the entity before the component is removed
+   */
+  template <typename Component, auto Candidate, typename Type>
+  void
+  ConnectDestroy(Type& instance) {
+    m_world.on_destroy<Component>().template connect<Candidate>(instance);
+  }
+
+  template <typename Component, typename Type>
+  void
+  DisconnectDestroy(Type& instance) {
+    m_world.on_destroy<Component>().disconnect(instance);
+  }
+
   entt::entity
   GetRootNode() const {
     return m_rootEntity;
@@ -109,6 +145,82 @@ class Scene {
   size_t
   GetChildrenCount(entt::entity node) const;
 
+  /**
+   * @brief insert or move the world space bounding box of the entity in the bounding volume hierarchy, it's called by
+   * the scene system when the AABBComponent or the TransformComp of the entity is changed
+   */
+  void
+  UpdateBounds(entt::entity entity, const BoundingBox& box);
+
+  void
+  RemoveBounds(entt::entity entity);
+
+  /**
+   * @brief remove the bounding boxes of the destroyed entities and the entities without AABBComponent
+   */
+  void
+  RemoveStaleBounds();
+
+  size_t
+  GetBoundsCount() const {
+    return m_boundsSlots.size();
+  }
+
+  /**
+   * @brief append the entities whose bounding box is on the frustum to the visible. All the cached bounding boxes are
+   * tested by the SIMD kernel of BoundingBoxArray, it's faster than QueryFrustum when the frustum contains a large part
+   * of the scene, like the frustum of the camera.
+   */
+  void
+  CullFrustum(const Frustum& frustum, Vector<entt::entity>& visible) const;
+
+  /**
+   * @brief call func(entity) for every entity whose bounding box is on the frustum
+   */
+  template <typename Func>
+  void
+  QueryFrustum(const Frustum& frustum, Func&& func) const {
+    m_bvh.QueryFrustum(frustum, [&](uint32_t userData) { func(static_cast<entt::entity>(userData)); });
+  }
+
+  /**
+   * @brief call func(entity) for every entity whose bounding box overlaps the box
+   */
+  template <typename Func>
+  void
+  QueryBox(const BoundingBox& box, Func&& func) const {
+    m_bvh.QueryBox(box, [&](uint32_t userData) { func(static_cast<entt::entity>(userData)); });
+  }
+
+  /**
+   * @brief call func(entity) for every entity whose bounding box overlaps the sphere
+   */
+  template <typename Func>
+  void
+  QuerySphere(const glm::vec3& center, float radius, Func&& func) const {
+    m_bvh.QuerySphere(center, radius, [&](uint32_t userData) { func(static_cast<entt::entity>(userData)); });
+  }
+
+  /**
+   * @brief call func(entity, distance) for every entity whose bounding box is hit by the ray
+   *
+   * @param direction the normalized direction of the ray
+   */
+  template <typename Func>
+  void
+  QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Func&& func) const {
+    m_bvh.QueryRay(origin, direction, maxDistance, [&](uint32_t userData, float distance) {
+      func(static_cast<entt::entity>(userData), distance);
+    });
+  }
+
+  /**
+   * @brief the entity whose bounding box is hit by the ray first, or entt::null
+   */
+  entt::entity
+  Pick(const glm::vec3& origin, const glm::vec3& direction,
+       float maxDistance = std::numeric_limits<float>::max()) const;
+
   std::shared_ptr<EditorCamera>
   GetEditorCamrea() const {
     return m_editorCamera;
@@ -124,6 +236,15 @@ class Scene {
   entt::registry m_world;
   entt::entity m_rootEntity = entt::null;
   std::shared_ptr<EditorCamera> m_editorCamera = nullptr;
+  struct BoundsSlot {
+    int32_t proxy;   // the proxy in m_bvh
+    uint32_t index;  // the index in m_worldBounds
+  };
+
+  AABBTree m_bvh;
+  BoundingBoxArray m_worldBounds;
+  Vector<entt::entity> m_boundsEntities;  // the entities of m_worldBounds
+  HashMap<entt::entity, BoundsSlot> m_boundsSlots;
 };
 
 }  // namespace Marbas
@@ -31,7 +31,7 @@ std::shared_ptr<RenderGraph> RenderSystem::s_precomputeRenderGraph;
 static std::optional<ImageView*> s_lastResultImageView;
 
 void
-RenderSystem::Initialize(RHIFactory* rhiFactory) {
+RenderSystem::Initialize(RHIFactory* rhiFactory, int frameInFlightCount) {
   uint32_t width = 800;
   uint32_t height = 600;
 
@@ -39,8 +39,15 @@ RenderSystem::Initialize(RHIFactory* rhiFactory) {
    * create all resource
    */
   s_resourceManager = std::make_shared<RenderGraphResourceManager>(rhiFactory);
-  s_renderGraph = std::make_unique<RenderGraph>(rhiFactory, s_resourceManager);
+  s_resourceManager->SetOutputExtent(width, height);
+  s_renderGraph = std::make_unique<RenderGraph>(rhiFactory, s_resourceManager, frameInFlightCount);
   s_precomputeRenderGraph = std::make_unique<RenderGraph>(rhiFactory, s_resourceManager);
+
+  // the pipelines of both graphs are created in parallel when they are compiled
+  auto compileThreadPool = std::make_shared<ThreadPool>();
+  s_renderGraph->SetCompileThreadPool(compileThreadPool);
+  s_precomputeRenderGraph->SetCompileThreadPool(compileThreadPool);
+
   s_renderSystem =
       std::make_shared<Job::RenderSystem>(rhiFactory, s_renderGraph, s_precomputeRenderGraph, s_resourceManager);
   s_renderSystem->Init();
@@ -18,8 +18,13 @@ struct RenderInfo final {
 };
 
 struct RenderSystem final {
+  /**
+   * @brief create the render graphs and the resources
+   *
+   * @param frameInFlightCount the count of frames the CPU can record before the GPU finishes the oldest one
+   */
   static void
-  Initialize(RHIFactory* rhiFactory);
+  Initialize(RHIFactory* rhiFactory, int frameInFlightCount = 1);
 
   static void
   Update(const RenderInfo& renderInfo);
@@ -27,6 +32,15 @@ struct RenderSystem final {
   static void
   Destroy(RHIFactory* rhiFactory);
 
+  /**
+   * @brief set the size of the final image, e.g. the size of the viewport. The screen sized textures are resized
+   * lazily before the next frame is rendered.
+   */
+  static void
+  SetOutputExtent(uint32_t width, uint32_t height) {
+    s_resourceManager->SetOutputExtent(width, height);
+  }
+
   static void
   RerunPreComputePass(const StringView& passName, RHIFactory* rhiFactory);
 
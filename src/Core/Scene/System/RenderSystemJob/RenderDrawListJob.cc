@@ -0,0 +1,43 @@
+#include "RenderDrawListJob.hpp"
+
+#include "RenderSystem.hpp"
+
+namespace Marbas::Job {
+
+void
+RenderDrawListJob::update(DeltaTime deltaTime, void* data) {
+  static const glm::mat4 s_identity(1.0);
+
+  auto* renderInfo = reinterpret_cast<RenderInfo*>(data);
+  auto* userData = renderInfo->userData;
+  auto& world = userData->scene->GetWorld();
+  auto& view = *userData->view;
+
+  // the draw list of the last frame is consumed by the render graph, so its memory can be reused
+  view.arena.Reset();
+
+  size_t drawCount = 0;
+  for (auto model : view.visibleModels) {
+    for (auto mesh : world.get<ModelSceneNode>(model).m_meshEntities) {
+      if (world.any_of<MeshRenderComponent>(mesh)) drawCount++;
+    }
+  }
+
+  auto drawItems = view.arena.Allocate<DrawItem>(drawCount);
+  size_t drawIndex = 0;
+  for (uint32_t modelIndex = 0; modelIndex < view.visibleModels.size(); modelIndex++) {
+    auto model = view.visibleModels[modelIndex];
+    const auto* transform = &s_identity;
+    if (world.any_of<TransformComp>(model)) {
+      transform = &world.get<TransformComp>(model).GetGlobalTransform();
+    }
+
+    for (auto mesh : world.get<ModelSceneNode>(model).m_meshEntities) {
+      if (!world.any_of<MeshRenderComponent>(mesh)) continue;
+      drawItems[drawIndex++] = {modelIndex, transform, &world.get<MeshRenderComponent>(mesh)};
+    }
+  }
+  view.drawItems = drawItems;
+}
+
+}  // namespace Marbas::Job
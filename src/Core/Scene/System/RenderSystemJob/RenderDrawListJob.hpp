@@ -0,0 +1,20 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+namespace Marbas::Job {
+
+/**
+ * @class RenderDrawListJob
+ * @brief build the draw list of the visible models after their mesh data is uploaded
+ *
+ */
+class RenderDrawListJob : public entt::process<RenderDrawListJob, uint32_t> {
+  using DeltaTime = uint32_t;
+
+ public:
+  void
+  update(DeltaTime deltaTime, void* data);
+};
+
+}  // namespace Marbas::Job
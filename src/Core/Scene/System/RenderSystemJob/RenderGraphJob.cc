@@ -5,6 +5,7 @@
 #include "Core/Renderer/GI/VXGI/VoxelVisualizatonPass.hpp"
 #include "Core/Renderer/GI/VXGI/VoxelizationPass.hpp"
 #include "Core/Renderer/Pass/AtmospherePass.hpp"
+#include "Core/Renderer/Pass/CameraBuffer.hpp"
 #include "Core/Renderer/Pass/DirectLightPass.hpp"
 #include "Core/Renderer/Pass/DirectionLightShadowMapPass.hpp"
 #include "Core/Renderer/Pass/ForwardPass/GridPass.hpp"
@@ -26,8 +27,12 @@
 #define GBUFFER_DIRECT_LIGHT "direct light"
 #define GBUFFER_VOXEL_VALIZATION "voxelValizationTexture"
 #define GBUFFER_VOXEL_DEPTH "voxel depth"
+#define GBUFFER_VOXEL_DIFFUSE "voxel diffuse"
+#define GBUFFER_VOXEL_NORMAL "voxel normal"
+#define GBUFFER_VOXEL_RADIANCE "voxel radiance"
 #define GBUFFER_VXGT_COLOR "vxgi color"
 #define GBUFFER_VXGT_REFLECT_COLOR "vxgi reflect color"
+#define BUFFER_CAMERA "camera"
 
 namespace Marbas::Job {
 
@@ -45,6 +50,8 @@ RenderGraphJob::RenderGraphJob(RHIFactory* rhiFactory, std::shared_ptr<RenderGra
 
   m_precomputeRenderGraph->Compile();
   m_renderGraph->Compile();
+  m_outputWidth = m_resMgr->GetOutputWidth();
+  m_outputHeight = m_resMgr->GetOutputHeight();
 
   /**
    * precompute all pass
@@ -68,44 +75,50 @@ RenderGraphJob::update(DeltaTime deltaTime, void* data) {
   auto* waitSemaphore = renderInfo->waitSemaphore;
   auto* signalSemaphore = renderInfo->signalSemaphore;
   auto* fence = renderInfo->fence;
+
+  // the output extent may be changed many times in a frame when the viewport is dragged, so the textures are only
+  // recreated once before the graph is executed. The images in use can't be destroyed, so wait for the GPU.
+  if (m_outputWidth != m_resMgr->GetOutputWidth() || m_outputHeight != m_resMgr->GetOutputHeight()) {
+    m_rhiFactory->WaitIdle();
+    m_renderGraph->Compile();
+    m_outputWidth = m_resMgr->GetOutputWidth();
+    m_outputHeight = m_resMgr->GetOutputHeight();
+    LOG(INFO) << FORMAT("resize the render graph to {}x{}", m_outputWidth, m_outputHeight);
+  }
+
   m_renderGraph->Execute(waitSemaphore, signalSemaphore, fence, userData);
 }
 
 void
 RenderGraphJob::CreateRenderGraphResource() {
-  // TODO: how to change it dynamically
-  uint32_t width = 1920;
-  uint32_t height = 1080;
+  // the screen sized textures follow the output extent, they are resized with the viewport
+  const RenderGraphRelativeSize screenSize;
 
   ImageCreateInfo createInfo;
 
-  // geometry pass
+  // geometry pass, the gbuffer is only used in a frame, so it can share the memory with other transient textures
   createInfo.sampleCount = SampleCount::BIT1;
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
-  createInfo.width = width;
-  createInfo.height = height;
   createInfo.format = ImageFormat::RGBA32F;
   createInfo.imageDesc = Image2DDesc();
   createInfo.mipMapLevel = 1;
-  m_resMgr->CreateTexture(GBUFFER_NORMAL, createInfo);
-  m_resMgr->CreateTexture(GBUFFER_POSITION, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_NORMAL, createInfo, screenSize, true);
+  m_resMgr->CreateTexture(GBUFFER_POSITION, createInfo, screenSize, true);
 
   createInfo.format = ImageFormat::RGBA;
-  m_resMgr->CreateTexture(GBUFFER_DIFFUSE, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_DIFFUSE, createInfo, screenSize, true);
 
   createInfo.format = ImageFormat::DEPTH;
   createInfo.usage = ImageUsageFlags::DEPTH_STENCIL | ImageUsageFlags::SHADER_READ;
-  m_resMgr->CreateTexture(GBUFFER_DEPTH, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_DEPTH, createInfo, screenSize, true);
 
   // ssao pass
   createInfo.sampleCount = SampleCount::BIT1;
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
-  createInfo.width = width;
-  createInfo.height = height;
   createInfo.format = ImageFormat::R32F;
   createInfo.imageDesc = Image2DDesc();
   createInfo.mipMapLevel = 1;
-  m_resMgr->CreateTexture(GBUFFER_SSAO, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_SSAO, createInfo, screenSize);
 
   // directional light shadow map pass
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::DEPTH_STENCIL;
@@ -144,47 +157,50 @@ RenderGraphJob::CreateRenderGraphResource() {
   createInfo.format = ImageFormat::RGBA32F;
   createInfo.imageDesc = Image2DDesc();
   createInfo.mipMapLevel = 1;
-  m_resMgr->CreateTexture(GBUFFER_ATMOSPHERE, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_ATMOSPHERE, createInfo, true);
 
   // direct light pass
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
   createInfo.format = ImageFormat::RGBA;
   createInfo.mipMapLevel = 1;
   createInfo.imageDesc = Image2DDesc{};
-  createInfo.width = width;
-  createInfo.height = height;
-  m_resMgr->CreateTexture(GBUFFER_DIRECT_LIGHT, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_DIRECT_LIGHT, createInfo, screenSize);
 
   // voxel visualization
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
   createInfo.format = ImageFormat::RGBA32F;
   createInfo.mipMapLevel = 1;
   createInfo.imageDesc = Image2DDesc{};
-  createInfo.width = width;
-  createInfo.height = height;
-  m_resMgr->CreateTexture(GBUFFER_VOXEL_VALIZATION, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_VOXEL_VALIZATION, createInfo, screenSize);
 
   createInfo.format = ImageFormat::DEPTH;
   createInfo.usage = ImageUsageFlags::DEPTH_STENCIL | ImageUsageFlags::SHADER_READ;
-  m_resMgr->CreateTexture(GBUFFER_VOXEL_DEPTH, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_VOXEL_DEPTH, createInfo, screenSize);
 
   // voxel color
   createInfo.sampleCount = SampleCount::BIT1;
   createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
-  createInfo.width = width;
-  createInfo.height = height;
   createInfo.format = ImageFormat::RGBA32F;
   createInfo.imageDesc = Image2DDesc();
   createInfo.mipMapLevel = 1;
-  m_resMgr->CreateTexture(GBUFFER_VXGT_COLOR, createInfo);
-  m_resMgr->CreateTexture(GBUFFER_VXGT_REFLECT_COLOR, createInfo);
+  m_resMgr->CreateTexture(GBUFFER_VXGT_COLOR, createInfo, screenSize);
+  m_resMgr->CreateTexture(GBUFFER_VXGT_REFLECT_COLOR, createInfo, screenSize, true);
+
+  // the voxels are owned by the VoxelRenderComponent of every probe and bound by the voxel passes themselves, so the
+  // textures have no image, they only order the voxelization, the light injection and the cone tracing
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::STORAGE;
+  createInfo.format = ImageFormat::RGBA;
+  createInfo.imageDesc = Image3DDesc();
+  m_resMgr->AddExternalTexture(GBUFFER_VOXEL_DIFFUSE, createInfo, {});
+  m_resMgr->AddExternalTexture(GBUFFER_VOXEL_NORMAL, createInfo, {});
+  m_resMgr->AddExternalTexture(GBUFFER_VOXEL_RADIANCE, createInfo, {});
+
+  // the camera buffer is written by the geometry pass every frame and shared by the passes after it
+  m_resMgr->CreateBuffer(BUFFER_CAMERA, BufferType::UNIFORM_BUFFER, sizeof(CameraBufferInfo), true);
 }
 
 void
 RenderGraphJob::CreateRenderGraphPass() {
-  uint32_t width = 1920;
-  uint32_t height = 1080;
-
   // precompute render pass
   TransmittanceLUTPassCreateInfo transmittanceLUTCreateInfo;
   transmittanceLUTCreateInfo.width = 256;
@@ -201,15 +217,18 @@ RenderGraphJob::CreateRenderGraphPass() {
   multiScatterLUTCreateInfo.multiScatterLUT = m_resMgr->GetHandler(GBUFFER_MULTISCATTER_LUT);
   m_precomputeRenderGraph->AddPass<MultiScatterLUT>("MultiScatterLUTPass", multiScatterLUTCreateInfo);
 
+  // the luts are used by the main render graph
+  m_precomputeRenderGraph->AddGraphOutput(m_resMgr->GetHandler(GBUFFER_TRANSMITTANCE_LUT));
+  m_precomputeRenderGraph->AddGraphOutput(m_resMgr->GetHandler(GBUFFER_MULTISCATTER_LUT));
+
   // render pass
   GeometryPassCreateInfo geometryPassCreateInfo;
-  geometryPassCreateInfo.height = height;
-  geometryPassCreateInfo.width = width;
   geometryPassCreateInfo.rhiFactory = m_rhiFactory;
   geometryPassCreateInfo.normalMetallicTexture = m_resMgr->GetHandler(GBUFFER_NORMAL);
   geometryPassCreateInfo.positionRoughnessTexture = m_resMgr->GetHandler(GBUFFER_POSITION);
   geometryPassCreateInfo.colorTexture = m_resMgr->GetHandler(GBUFFER_DIFFUSE);
   geometryPassCreateInfo.depthTexture = m_resMgr->GetHandler(GBUFFER_DEPTH);
+  geometryPassCreateInfo.cameraBuffer = m_resMgr->GetBufferHandler(BUFFER_CAMERA);
   m_renderGraph->AddPass<GeometryPass>("GeometryPass", geometryPassCreateInfo);
 
   DirectionShadowMapPassCreateInfo directShadowMapCreateInfo;
@@ -221,27 +240,32 @@ RenderGraphJob::CreateRenderGraphPass() {
   voxelizationCreateInfo.rhiFactory = m_rhiFactory;
   // voxelizationCreateInfo.voxelScene = m_resMgr->GetHandler(GBUFFER_VOXEL_SCENE);
   voxelizationCreateInfo.shadowMap = m_resMgr->GetHandler(GBUFFER_DIRECTION_SHADOWMAP);
-  m_renderGraph->AddPass<GI::VoxelizationPass>("VXGIPass", voxelizationCreateInfo);
+  voxelizationCreateInfo.voxelDiffuse = m_resMgr->GetHandler(GBUFFER_VOXEL_DIFFUSE);
+  voxelizationCreateInfo.voxelNormal = m_resMgr->GetHandler(GBUFFER_VOXEL_NORMAL);
+  m_renderGraph->AddPass<GI::VoxelizationPass>("VoxelizationPass", voxelizationCreateInfo);
 
   GI::LightInjectPassCreateInfo lightInjectCreateInfo;
   lightInjectCreateInfo.rhiFactory = m_rhiFactory;
+  lightInjectCreateInfo.voxelDiffuse = m_resMgr->GetHandler(GBUFFER_VOXEL_DIFFUSE);
+  lightInjectCreateInfo.voxelNormal = m_resMgr->GetHandler(GBUFFER_VOXEL_NORMAL);
+  lightInjectCreateInfo.voxelRadiance = m_resMgr->GetHandler(GBUFFER_VOXEL_RADIANCE);
   m_renderGraph->AddPass<GI::LightInjectPass>("lightInjectPass", lightInjectCreateInfo);
 
+  // the radiance of the voxels changes slowly, so trade one frame of GI latency for the cost of injecting
+  m_renderGraph->SetPassUpdatePolicy("lightInjectPass", {.interval = 2});
+
   GI::VXGIPassCreateInfo vxgiCreateInfo;
   vxgiCreateInfo.m_rhiFactory = m_rhiFactory;
-  vxgiCreateInfo.m_widht = width;
-  vxgiCreateInfo.m_height = height;
   vxgiCreateInfo.m_positionRoughnessTexture = m_resMgr->GetHandler(GBUFFER_POSITION);
   vxgiCreateInfo.m_diffuseTexture = m_resMgr->GetHandler(GBUFFER_DIFFUSE);
   vxgiCreateInfo.m_normalMetallicTexture = m_resMgr->GetHandler(GBUFFER_NORMAL);
   vxgiCreateInfo.m_finalTexture = m_resMgr->GetHandler(GBUFFER_VXGT_COLOR);
   vxgiCreateInfo.m_reflectTexture = m_resMgr->GetHandler(GBUFFER_VXGT_REFLECT_COLOR);
+  vxgiCreateInfo.m_voxelRadiance = m_resMgr->GetHandler(GBUFFER_VOXEL_RADIANCE);
   m_renderGraph->AddPass<GI::VXGIPass>("VXGIPass", vxgiCreateInfo);
 
   DirectLightPassCreateInfo directLightPassCreateInfo;
   directLightPassCreateInfo.rhiFactory = m_rhiFactory;
-  directLightPassCreateInfo.width = width;
-  directLightPassCreateInfo.height = height;
   directLightPassCreateInfo.aoTeture = m_resMgr->GetHandler(GBUFFER_SSAO);
   directLightPassCreateInfo.normalTeture = m_resMgr->GetHandler(GBUFFER_NORMAL);
   directLightPassCreateInfo.positionTeture = m_resMgr->GetHandler(GBUFFER_POSITION);
@@ -260,11 +284,10 @@ RenderGraphJob::CreateRenderGraphPass() {
   atmosphereCreateInfo.multiscatterLUT = m_resMgr->GetHandler(GBUFFER_MULTISCATTER_LUT);
   atmosphereCreateInfo.transmittanceLUT = m_resMgr->GetHandler(GBUFFER_TRANSMITTANCE_LUT);
   m_renderGraph->AddPass<AtmospherePass>("AtmospherePass", atmosphereCreateInfo);
+  m_renderGraph->SetPassUpdatePolicy("AtmospherePass", {.interval = 2});
 
   SkyImagePassCreateInfo skyImageCreateInfo;
   skyImageCreateInfo.rhiFactory = m_rhiFactory;
-  skyImageCreateInfo.width = width;
-  skyImageCreateInfo.height = height;
   skyImageCreateInfo.finalColorTexture = m_resMgr->GetHandler(GBUFFER_DIRECT_LIGHT);
   skyImageCreateInfo.finalDepthTexture = m_resMgr->GetHandler(GBUFFER_DEPTH);
   skyImageCreateInfo.atmosphereTexture = m_resMgr->GetHandler(GBUFFER_ATMOSPHERE);
@@ -272,11 +295,14 @@ RenderGraphJob::CreateRenderGraphPass() {
 
   GridRenderPassCreateInfo gridRenderPassCreateInfo;
   gridRenderPassCreateInfo.rhiFactory = m_rhiFactory;
-  gridRenderPassCreateInfo.height = height;
-  gridRenderPassCreateInfo.width = width;
   gridRenderPassCreateInfo.finalDepthTexture = m_resMgr->GetHandler(GBUFFER_DEPTH);
   gridRenderPassCreateInfo.finalColorTexture = m_resMgr->GetHandler(GBUFFER_DIRECT_LIGHT);
+  gridRenderPassCreateInfo.cameraBuffer = m_resMgr->GetBufferHandler(BUFFER_CAMERA);
   m_renderGraph->AddPass<GridRenderPass>("gridPass", gridRenderPassCreateInfo);
+
+  // the textures shown in the editor, the pass which doesn't contribute to them will be culled
+  m_renderGraph->AddGraphOutput(m_resMgr->GetHandler(GBUFFER_DIRECT_LIGHT));
+  m_renderGraph->AddGraphOutput(m_resMgr->GetHandler(GBUFFER_VXGT_COLOR));
 }
 
 };  // namespace Marbas::Job
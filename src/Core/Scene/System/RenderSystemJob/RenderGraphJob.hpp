@@ -37,6 +37,8 @@ class RenderGraphJob final : public entt::process<RenderGraphJob, uint32_t> {
   std::shared_ptr<RenderGraphResourceManager> m_resMgr = nullptr;
   std::shared_ptr<RenderGraph> m_renderGraph;
   std::shared_ptr<RenderGraph> m_precomputeRenderGraph;
+  uint32_t m_outputWidth = 0;  // the output extent when the render graph is compiled
+  uint32_t m_outputHeight = 0;
 };
 
 }  // namespace Marbas::Job
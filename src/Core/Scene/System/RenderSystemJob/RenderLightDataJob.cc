@@ -8,13 +8,14 @@ namespace Marbas::Job {
 void
 RenderLightDataJob::update(DeltaTime deltaTime, void* data) {
   auto* renderInfo = reinterpret_cast<RenderInfo*>(data);
-  auto* scene = reinterpret_cast<Job::RenderUserData*>(renderInfo->userData)->scene;
+  auto* userData = reinterpret_cast<Job::RenderUserData*>(renderInfo->userData);
+  auto* scene = userData->scene;
   auto& world = scene->GetWorld();
   auto rootEntity = scene->GetRootNode();
 
   LOG_IF(WARNING, world.view<LightRenderComponent>().size() > 1) << "";
   if (!world.any_of<LightRenderComponent>(rootEntity)) {
-    scene->Emplace<LightRenderComponent>(rootEntity, m_rhiFactory);
+    scene->Emplace<LightRenderComponent>(rootEntity, m_rhiFactory, userData->frameInFlightCount);
   }
 
   // TODO: remove other light render component
@@ -44,6 +45,9 @@ RenderLightDataJob::update(DeltaTime deltaTime, void* data) {
       }
       component.UpdateLight(light);
     }
+
+    // the buffer of the frame in flight used by the render graph in this frame
+    component.UpdateGPUBuffer(userData->frameIndex);
     return true;
   });
 }
@@ -54,14 +54,13 @@ void
 RenderMeshDataJob::update(DeltaTime deltaTime, void* data) {
   auto* renderInfo = reinterpret_cast<RenderInfo*>(data);
   auto* userData = renderInfo->userData;
-  auto* scene = reinterpret_cast<Job::RenderUserData*>(userData)->scene;
+  auto* scene = userData->scene;
   auto& world = scene->GetWorld();
   auto modelAssetMgr = AssetManager<ModelAsset>::GetInstance();
 
-  // find all renderable model, and update the gpu mesh data
-  auto modelNodeView = world.view<ModelSceneNode, RenderableTag>();
-  for (auto&& [model, node] : modelNodeView.each()) {
-    for (auto meshEntity : node.m_meshEntities) {
+  // update the gpu mesh data of the visible models
+  for (auto model : userData->view->visibleModels) {
+    for (auto meshEntity : world.get<ModelSceneNode>(model).m_meshEntities) {
       if (!world.any_of<MeshComponent>(meshEntity)) continue;
 
       auto& meshComponent = world.get<MeshComponent>(meshEntity);
@@ -69,7 +68,8 @@ RenderMeshDataJob::update(DeltaTime deltaTime, void* data) {
       auto& mesh = meshComponent.m_modelAsset->GetMesh(index);
 
       if (!world.any_of<MeshRenderComponent>(meshEntity)) {
-        scene->Emplace<MeshRenderComponent>(meshEntity, m_rhiFactory, m_sampler, m_emptyImageView);
+        scene->Emplace<MeshRenderComponent>(meshEntity, m_rhiFactory, m_sampler, m_emptyImageView,
+                                            userData->frameInFlightCount);
         scene->Update<MeshRenderComponent>(meshEntity, [&](auto& component) {
           component.Init(mesh);
           return false;  // No Need to emit an update signal
@@ -77,7 +77,7 @@ RenderMeshDataJob::update(DeltaTime deltaTime, void* data) {
       }
 
       scene->Update<MeshRenderComponent>(meshEntity, [&](auto&& component) {
-        component.Update(mesh);
+        component.Update(mesh, userData->frameIndex);
         return true;
       });
 
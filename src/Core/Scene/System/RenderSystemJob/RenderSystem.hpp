@@ -5,10 +5,12 @@
 #include "Core/Renderer/RenderGraph/RenderGraphResourceManager.hpp"
 #include "Core/Scene/Scene.hpp"
 #include "RHIFactory.hpp"
+#include "RenderDrawListJob.hpp"
 #include "RenderGraphJob.hpp"
 #include "RenderLightDataJob.hpp"
 #include "RenderMeshDataJob.hpp"
 #include "RenderVXGIJob.hpp"
+#include "RenderView.hpp"
 #include "RenderViewClipJob.hpp"
 
 namespace Marbas::Job {
@@ -16,6 +18,9 @@ namespace Marbas::Job {
 struct RenderUserData {
   Scene* scene = nullptr;
   bool changeScene = false;
+  RenderView* view = nullptr;
+  uint32_t frameIndex = 0;  // the frame in flight used by the render graph in this frame
+  uint32_t frameInFlightCount = 1;
 };
 
 struct RenderInfo {
@@ -38,20 +43,29 @@ class RenderSystem {
  public:
   void
   Init() {
-    m_scheduler.attach<RenderGraphJob>(m_rhiFactory, m_renderGraph, m_precomputeGraph, m_renderGraphResMgr);
-    m_scheduler.attach<RenderLightDataJob>(m_rhiFactory);
-    m_scheduler.attach<RenderMeshDataJob>(m_rhiFactory);
+    // the view is culled and its draw list is built before the render graph is executed in the same frame, because
+    // the draw items point to the components which may be moved when the components are emplaced in the next frame
     m_scheduler.attach<RenderViewClipJob>();
+    m_scheduler.attach<RenderMeshDataJob>(m_rhiFactory);
+    m_scheduler.attach<RenderLightDataJob>(m_rhiFactory);
     m_scheduler.attach<RenderVXGIJob>(m_rhiFactory);
+    m_scheduler.attach<RenderDrawListJob>();
+    m_scheduler.attach<RenderGraphJob>(m_rhiFactory, m_renderGraph, m_precomputeGraph, m_renderGraphResMgr);
   }
 
   void
   Update(uint32_t deltaTime, RenderInfo& renderinfo) {
+    // the render data written by the CPU has a copy for each frame in flight like the render graph, so the copy of the
+    // next execution is updated
+    renderinfo.userData->view = &m_mainView;
+    renderinfo.userData->frameIndex = m_renderGraph->GetFrameIndex();
+    renderinfo.userData->frameInFlightCount = m_renderGraph->GetFrameInFlightCount();
     m_scheduler.update(deltaTime, &renderinfo);
   }
 
  private:
   entt::scheduler m_scheduler;
+  RenderView m_mainView;
   RHIFactory* m_rhiFactory;
   std::shared_ptr<RenderGraph> m_renderGraph;
   std::shared_ptr<RenderGraph> m_precomputeGraph;
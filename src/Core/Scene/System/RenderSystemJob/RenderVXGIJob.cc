@@ -15,6 +15,8 @@ RenderVXGIJob::update(DeltaTime deltaTime, void* data) {
   auto* renderInfo = reinterpret_cast<RenderInfo*>(data);
   auto* userData = renderInfo->userData;
   auto* scene = reinterpret_cast<Job::RenderUserData*>(userData)->scene;
+  const auto frameIndex = userData->frameIndex;
+  const auto frameInFlightCount = userData->frameInFlightCount;
   auto& world = scene->GetWorld();
   auto rootEntity = scene->GetRootNode();
 
@@ -32,14 +34,16 @@ RenderVXGIJob::update(DeltaTime deltaTime, void* data) {
     AABBComponent _tempCom(pos - sceneGIProbe.size / 2.f, pos + sceneGIProbe.size / 2.f);
     if (_tempCom.IsOnFrustum(frustum, transform.GetGlobalTransform())) {
       if (!world.any_of<VoxelRenderComponent>(entity)) {
-        scene->Emplace<VoxelRenderComponent>(entity, m_rhiFactory, sceneGIProbe.size);
+        scene->Emplace<VoxelRenderComponent>(entity, m_rhiFactory, sceneGIProbe.size, frameInFlightCount);
       }
       scene->Update<VoxelRenderComponent>(entity, [&](auto& component) {
-        component.UpdateVoxelInfo(sceneGIProbe.size, pos);
+        component.UpdateVoxelInfo(frameIndex, sceneGIProbe.size, pos);
         return true;
       });
-    } else {
+    } else if (world.any_of<VoxelRenderComponent>(entity)) {
+      // the voxels may be still used by the other frames in flight, so wait for the GPU before destroying them
       // TODO: maybe need a cache
+      if (frameInFlightCount > 1) m_rhiFactory->WaitIdle();
       scene->Remove<VoxelRenderComponent>(entity);
     }
   }
@@ -49,7 +53,7 @@ RenderVXGIJob::update(DeltaTime deltaTime, void* data) {
     if (sceneGIProbeView.size_hint() == 0) {
       return;
     }
-    scene->Emplace<VXGIGlobalComponent>(rootEntity, m_rhiFactory);
+    scene->Emplace<VXGIGlobalComponent>(rootEntity, m_rhiFactory, frameInFlightCount);
   }
 
   scene->Update<VXGIGlobalComponent>(rootEntity, [&](auto& component) {
@@ -81,6 +85,8 @@ RenderVXGIJob::update(DeltaTime deltaTime, void* data) {
       }
       j++;
     }
+
+    component.UpdateGPUData(frameIndex);
     return true;
   });
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <span>
+
+#include "Common/Common.hpp"
+#include "Common/FrameArena.hpp"
+#include "Common/MathCommon.hpp"
+#include "Core/Scene/Component/RenderComponent/MeshRenderComponent.hpp"
+
+namespace Marbas::Job {
+
+/**
+ * @brief a mesh which is drawn in this frame, the draw items of a model are adjacent in the draw list
+ */
+struct DrawItem {
+  uint32_t modelIndex;  // the index of the model in RenderView::visibleModels
+  const glm::mat4* transform;
+  const MeshRenderComponent* mesh;
+};
+
+/**
+ * @brief the models and the meshes visible from a view in this frame.
+ *
+ * The draw items point to the components in the world and are allocated from the frame arena, so they are only valid
+ * in the frame they are built.
+ */
+struct RenderView {
+  Vector<entt::entity> visibleModels;  // sorted by the entity
+  std::span<const DrawItem> drawItems;
+  FrameArena arena;
+};
+
+}  // namespace Marbas::Job
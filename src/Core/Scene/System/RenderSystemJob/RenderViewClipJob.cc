@@ -1,5 +1,7 @@
 #include "RenderViewClipJob.hpp"
 
+#include <algorithm>
+
 #include "Core/Scene/System/RenderSystemJob/RenderSystem.hpp"
 
 namespace Marbas::Job {
@@ -8,25 +10,20 @@ void
 RenderViewClipJob::update(DeltaTime deltaTime, void* data) {
   auto* renderInfo = reinterpret_cast<RenderInfo*>(data);
   auto* userData = renderInfo->userData;
-  auto* scene = reinterpret_cast<Job::RenderUserData*>(userData)->scene;
+  auto* scene = userData->scene;
   auto& world = scene->GetWorld();
+  auto& visibleModels = userData->view->visibleModels;
 
   auto camera = scene->GetEditorCamrea();
   auto& frustum = camera->GetFrustum();
 
-  auto modelView = world.view<ModelSceneNode, AABBComponent, TransformComp>();
-
-  for (auto&& [entity, node, aabb, tran] : modelView.each()) {
-    if (!aabb.IsOnFrustum(frustum, tran.GetGlobalTransform())) {
-      if (world.any_of<RenderableTag>(entity)) {
-        scene->Remove<RenderableTag>(entity);
-      }
-    } else {
-      if (!world.any_of<RenderableTag>(entity)) {
-        scene->Emplace<RenderableTag>(entity);
-      }
-    }
-  }
+  // the view frustum contains a large part of the scene, so the cached world space bounding boxes are tested by the
+  // SIMD kernel instead of walking the bounding volume hierarchy. The result is written to the visible list of the
+  // view rather than tagging the entities, so the storage of the world isn't changed by moving the camera
+  visibleModels.clear();
+  scene->CullFrustum(frustum, visibleModels);
+  std::erase_if(visibleModels, [&](entt::entity entity) { return !world.any_of<ModelSceneNode>(entity); });
+  std::sort(visibleModels.begin(), visibleModels.end());
 
   return;
 }
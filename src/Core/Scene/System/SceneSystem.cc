@@ -25,10 +25,12 @@ SceneSystem::CreateAssetCache(Scene* scene) {
 }
 
 Job::SceneSystem SceneSystem::s_sceneSystem;
+std::shared_ptr<ThreadPool> SceneSystem::s_threadPool = nullptr;
 
 void
 SceneSystem::Initialize() {
   s_sceneSystem.Init();
+  s_threadPool = std::make_shared<ThreadPool>();
 }
 
 Task<void>
@@ -39,6 +41,7 @@ SceneSystem::Update(Scene* scene) {
   static Scene* s_lastScene = nullptr;
   Job::SceneUserData userData;
   userData.m_scene = scene;
+  userData.m_threadPool = s_threadPool.get();
   if (scene != s_lastScene) {
     userData.m_sceneChange = true;
     s_lastScene = scene;
@@ -2,6 +2,7 @@
 #include <entt/entt.hpp>
 
 #include "AssetManager/AssetManager.hpp"
+#include "Common/ThreadPool.hpp"
 #include "Core/Scene/System/SceneSystemJob/SceneSystem.hpp"
 #include "RHIFactory.hpp"
 
@@ -32,6 +33,7 @@ struct SceneSystem {
   CreateAssetCache(Scene* scene);
 
   static Job::SceneSystem s_sceneSystem;
+  static std::shared_ptr<ThreadPool> s_threadPool;  // the pool used by the jobs to update the big scene in parallel
 };
 
 }  // namespace Marbas
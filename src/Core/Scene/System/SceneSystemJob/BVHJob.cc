@@ -0,0 +1,72 @@
+#include "BVHJob.hpp"
+
+#include "Core/Scene/Component/AABBComponent.hpp"
+#include "Core/Scene/Component/SerializeComponent/TransformComp.hpp"
+#include "Core/Scene/System/SceneSystemJob/SceneSystem.hpp"
+
+namespace Marbas::Job {
+
+static void
+UpdateBounds(Scene* scene, entt::entity entity) {
+  if (!scene->AnyOf<AABBComponent>(entity) || !scene->AnyOf<TransformComp>(entity)) return;
+  const auto& aabb = scene->Get<AABBComponent>(entity);
+  const auto& transform = scene->Get<TransformComp>(entity).GetGlobalTransform();
+  scene->UpdateBounds(entity, aabb.GetBoundingBox().Transform(transform));
+}
+
+BVHJob::~BVHJob() { Disconnect(); }
+
+void
+BVHJob::OnDestroy(entt::registry& world, entt::entity entity) {
+  m_removedEntities.push_back(entity);
+}
+
+void
+BVHJob::Disconnect() {
+  if (m_scene == nullptr) return;
+  m_scene->DisconnectDestroy<AABBComponent>(*this);
+  m_scene->DisconnectDestroy<TransformComp>(*this);
+  m_scene = nullptr;
+}
+
+void
+BVHJob::update(uint32_t deltaTime, void* data) {
+  auto* sceneUserData = reinterpret_cast<SceneUserData*>(data);
+  auto* scene = sceneUserData->m_scene;
+  if (scene == nullptr) return;
+
+  if (sceneUserData->m_sceneChange) {
+    constexpr auto collector = entt::collector.group<AABBComponent, TransformComp>()
+                                   .update<AABBComponent>()
+                                   .where<TransformComp>()
+                                   .update<TransformComp>()
+                                   .where<AABBComponent>();
+    scene->ConnectObserve(m_observer, collector);
+
+    // the removal is only tracked while the scene is connected, so the bounding boxes of the entities removed before
+    // are found by checking the whole scene
+    Disconnect();
+    m_scene = scene;
+    m_scene->ConnectDestroy<AABBComponent, &BVHJob::OnDestroy>(*this);
+    m_scene->ConnectDestroy<TransformComp, &BVHJob::OnDestroy>(*this);
+    m_removedEntities.clear();
+    scene->RemoveStaleBounds();
+
+    // the observer only collects the later changes
+    for (auto entity : scene->View<AABBComponent>()) {
+      UpdateBounds(scene, entity);
+    }
+  } else {
+    // remove the bounding boxes first, the entity may get the component again after it's removed
+    for (auto entity : m_removedEntities) {
+      scene->RemoveBounds(entity);
+    }
+    for (auto entity : m_observer) {
+      UpdateBounds(scene, entity);
+    }
+  }
+  m_observer.clear();
+  m_removedEntities.clear();
+}
+
+}  // namespace Marbas::Job
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <entt/entt.hpp>
+
+#include "Core/Scene/Scene.hpp"
+
+namespace Marbas::Job {
+
+/**
+ * @brief keep the bounding volume hierarchy of the scene in sync with the world space bounding boxes of the entities.
+ *
+ * The bounding box is moved only when the AABBComponent or the TransformComp of the entity is changed, and it's removed
+ * when one of them is removed or the entity is destroyed. The TransformJob patches the descendants of the moved node,
+ * so it must run before this job.
+ */
+class BVHJob final : public entt::process<BVHJob, uint32_t> {
+ public:
+  ~BVHJob();
+
+  void
+  update(uint32_t deltaTime, void* data);
+
+ private:
+  void
+  OnDestroy(entt::registry& world, entt::entity entity);
+
+  void
+  Disconnect();
+
+ private:
+  entt::observer m_observer;
+  Scene* m_scene = nullptr;                // the scene whose destroy signals are connected
+  Vector<entt::entity> m_removedEntities;  // the entities losing the bounding box since the last update
+};
+
+}  // namespace Marbas::Job
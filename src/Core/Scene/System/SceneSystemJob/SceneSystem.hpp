@@ -1,6 +1,7 @@
 #pragma once
 
 #include "AABBJob.hpp"
+#include "BVHJob.hpp"
 #include "Core/Scene/Scene.hpp"
 #include "LoadMeshJob.hpp"
 #include "TransformJob.hpp"
@@ -10,6 +11,7 @@ namespace Marbas::Job {
 struct SceneUserData {
   Scene* m_scene = nullptr;
   bool m_sceneChange = false;
+  ThreadPool* m_threadPool = nullptr;  // the pool used by the jobs to update in parallel, nullptr means serially
 };
 
 class SceneSystem final {
@@ -18,6 +20,7 @@ class SceneSystem final {
   Init() {
     m_scheduler.attach<TransformJob>();
     m_scheduler.attach<AABBJob>();
+    m_scheduler.attach<BVHJob>();
     m_scheduler.attach<LoadMeshJob>();
   }
 
@@ -1,5 +1,9 @@
 #include "TransformJob.hpp"
 
+#include <glog/logging.h>
+
+#include <algorithm>
+
 #include "Core/Scene/Component/SerializeComponent/TransformComp.hpp"
 #include "Core/Scene/Scene.hpp"
 #include "Core/Scene/System/SceneSystemJob/SceneSystem.hpp"
@@ -9,47 +13,166 @@ namespace Marbas::Job {
 void
 TransformJob::update(uint32_t deltaTime, void* data) {
   auto* sceneUserData = reinterpret_cast<SceneUserData*>(data);
-  if (sceneUserData->m_sceneChange && sceneUserData->m_scene != nullptr) {
-    auto collector = entt::collector.update<TransformComp>();
-    sceneUserData->m_scene->ConnectObserve(m_observer, collector);
+  auto* scene = sceneUserData->m_scene;
+  if (sceneUserData->m_sceneChange && scene != nullptr) {
+    // the transform component emplaced after the hierarchy is built is updated too
+    constexpr auto collector = entt::collector.update<TransformComp>().group<TransformComp>();
+    constexpr auto hierarchyCollector = entt::collector.update<HierarchyComponent>().group<HierarchyComponent>();
+    scene->ConnectObserve(m_observer, collector);
+    scene->ConnectObserve(m_hierarchyObserver, hierarchyCollector);
+    m_nodes.clear();
+  }
+  if (scene == nullptr) return;
+
+  // the new node is observed, but the removed node isn't, so the count of the nodes is checked too
+  m_updateCount = 0;
+  const bool isHierarchyChange = m_nodes.empty() || !m_hierarchyObserver.empty() ||
+                                 scene->View<HierarchyComponent>().size() != m_nodes.size();
+  if (isHierarchyChange) {
+    BuildHierarchy(scene);
+    m_ranges.clear();
+    for (uint32_t root = 0; root < m_nodes.size(); root = m_nodes[root].subtreeEnd) {
+      m_ranges.emplace_back(root, m_nodes[root].subtreeEnd);
+    }
+    UpdateSubtrees(scene, sceneUserData->m_threadPool);
+    m_hierarchyObserver.clear();
+    m_observer.clear();
     return;
   }
+  if (m_observer.empty()) return;
 
-  if (!sceneUserData->m_sceneChange && m_observer.empty()) return;
+  m_dirtyNodes.clear();
+  for (auto entity : m_observer) {
+    auto id = entt::to_entity(entity);
+    if (id < m_nodeIndices.size() && m_nodeIndices[id] != invalidIndex) {
+      m_dirtyNodes.push_back(m_nodeIndices[id]);
+    }
+  }
 
-  auto rootEntity = sceneUserData->m_scene->GetRootNode();
-  UpdateTransformRecursion(sceneUserData->m_scene, rootEntity);
+  // the dirty node in the subtree of another dirty node is updated with that subtree
+  std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+  m_ranges.clear();
+  for (auto index : m_dirtyNodes) {
+    if (!m_ranges.empty() && index < m_ranges.back().second) continue;
+    m_ranges.emplace_back(index, m_nodes[index].subtreeEnd);
+  }
+  UpdateSubtrees(scene, sceneUserData->m_threadPool);
 
   m_observer.clear();
 }
 
 void
-TransformJob::UpdateTransformRecursion(Scene* scene, entt::entity entity) {
-  if (!scene->AnyOf<HierarchyComponent>(entity)) return;
+TransformJob::BuildHierarchy(Scene* scene) {
+  m_nodes.clear();
+  std::fill(m_nodeIndices.begin(), m_nodeIndices.end(), invalidIndex);
 
-  const auto& hierarchy = scene->Get<HierarchyComponent>(entity);
-  if (hierarchy.parent == entt::null) {
-    scene->Update<TransformComp>(entity, [&](auto& component) {
-      if (!component.IsDirty()) return false;
+  // visit the nodes in depth first order by a stack, so the deep hierarchy of the imported model doesn't overflow the
+  // call stack. The children are pushed in reverse order to keep their order.
+  Vector<std::pair<entt::entity, uint32_t>> stack;  // the entity and the index of its parent
+  for (auto&& [entity, hierarchy] : scene->View<HierarchyComponent>().each()) {
+    if (hierarchy.parent == entt::null) stack.emplace_back(entity, invalidIndex);
+  }
+  while (!stack.empty()) {
+    auto [entity, parent] = stack.back();
+    stack.pop_back();
 
-      auto& localTrans = component.GetLocalTransform();
-      component.SetLocalTransform(localTrans, glm::mat4(1.0));
-      return false;  // not emit an update signal
-    });
-  } else {
-    auto& parentEntity = hierarchy.parent;
-    auto& parentTrans = scene->Get<TransformComp>(parentEntity);
-    auto& parentGlobalTrans = parentTrans.GetGlobalTransform();
-    scene->Update<TransformComp>(entity, [&](auto& component) {
-      // if (!component.IsDirty()) return false;  // this componet has set global transform
-      auto& localTrans = component.GetLocalTransform();
-      component.SetLocalTransform(localTrans, parentGlobalTrans);
-      return false;  // not emit an update signal
-    });
+    auto id = entt::to_entity(entity);
+    if (id >= m_nodeIndices.size()) {
+      m_nodeIndices.resize(id + 1, invalidIndex);
+    }
+    if (m_nodeIndices[id] != invalidIndex) {
+      LOG(ERROR) << FORMAT("the entity {} is in the hierarchy more than once", entt::to_integral(entity));
+      continue;
+    }
+
+    auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodeIndices[id] = index;
+    m_nodes.push_back({entity, parent, index + 1});
+
+    const auto& children = scene->Get<HierarchyComponent>(entity).children;
+    for (auto iter = children.rbegin(); iter != children.rend(); iter++) {
+      stack.emplace_back(*iter, index);
+    }
   }
 
-  for (auto child : hierarchy.children) {
-    UpdateTransformRecursion(scene, child);
+  // the subtree ends after the last node of the subtree of its last child
+  for (auto i = static_cast<int64_t>(m_nodes.size()) - 1; i >= 0; i--) {
+    auto parent = m_nodes[i].parent;
+    if (parent == invalidIndex) continue;
+    m_nodes[parent].subtreeEnd = std::max(m_nodes[parent].subtreeEnd, m_nodes[i].subtreeEnd);
+  }
+  m_globalTransforms.resize(m_nodes.size());
+
+  // sort the transform components in the same order, so the sweep reads them linearly
+  scene->Sort<TransformComp>([&](entt::entity lhs, entt::entity rhs) {
+    auto getIndex = [&](entt::entity entity) {
+      auto id = entt::to_entity(entity);
+      return id < m_nodeIndices.size() ? m_nodeIndices[id] : invalidIndex;
+    };
+    return getIndex(lhs) < getIndex(rhs);
+  });
+}
+
+void
+TransformJob::UpdateSubtrees(Scene* scene, ThreadPool* threadPool) {
+  uint32_t nodeCount = 0;
+  for (auto [begin, end] : m_ranges) nodeCount += end - begin;
+  m_updateCount += nodeCount;
+
+  // the descendants of the patched node are moved too, they are patched, so the jobs after this one observe them. The
+  // signals are emitted here because the observers can't be written by the thread pool.
+  for (auto [begin, end] : m_ranges) {
+    for (uint32_t i = begin; i < end; i++) {
+      if (scene->AnyOf<TransformComp>(m_nodes[i].entity)) scene->Patch<TransformComp>(m_nodes[i].entity);
+    }
+  }
+
+  if (threadPool == nullptr || nodeCount < parallelNodeCount) {
+    for (auto [begin, end] : m_ranges) UpdateRange(scene, begin, end);
+    return;
+  }
+
+  // split the big subtree into the subtrees of the children of its root until every thread has several chunks. The
+  // root is updated before splitting, so every chunk only reads the parent updated already.
+  const uint32_t chunkSize = std::max(nodeCount / ((threadPool->GetThreadCount() + 1) * 4), 1u);
+  m_chunks.clear();
+  while (!m_ranges.empty()) {
+    auto [begin, end] = m_ranges.back();
+    m_ranges.pop_back();
+    if (end - begin <= chunkSize) {
+      m_chunks.emplace_back(begin, end);
+      continue;
+    }
+
+    UpdateRange(scene, begin, begin + 1);
+    for (uint32_t child = begin + 1; child < end; child = m_nodes[child].subtreeEnd) {
+      m_ranges.emplace_back(child, m_nodes[child].subtreeEnd);
+    }
+  }
+
+  // the chunks write the different components and read the registry only, the storage of the components isn't changed
+  threadPool->ParallelFor(static_cast<uint32_t>(m_chunks.size()), [&](uint32_t index) {
+    UpdateRange(scene, m_chunks[index].first, m_chunks[index].second);
+  });
+}
+
+void
+TransformJob::UpdateRange(Scene* scene, uint32_t begin, uint32_t end) {
+  static const glm::mat4 identity(1.0);
+  for (uint32_t i = begin; i < end; i++) {
+    const auto& node = m_nodes[i];
+    const auto& parentGlobalTrans = node.parent == invalidIndex ? identity : m_globalTransforms[node.parent];
+
+    // the node without transform passes the transform of its parent to its children
+    if (!scene->AnyOf<TransformComp>(node.entity)) {
+      m_globalTransforms[i] = parentGlobalTrans;
+      continue;
+    }
+    scene->Update<TransformComp>(node.entity, [&](auto& component) {
+      component.SetLocalTransform(component.GetLocalTransform(), parentGlobalTrans);
+      m_globalTransforms[i] = component.GetGlobalTransform();
+      return false;  // not emit an update signal
+    });
   }
 }
 
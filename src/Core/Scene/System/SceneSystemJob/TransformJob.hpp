@@ -1,23 +1,75 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <limits>
 
+#include "Common/ThreadPool.hpp"
 #include "Core/Scene/Scene.hpp"
 
 namespace Marbas::Job {
 
+/**
+ * @brief update the global transform of the nodes whose transform is patched and of their subtrees.
+ *
+ * The hierarchy is flattened in depth first order, so the parent is before its children and every subtree is a
+ * contiguous range after its root. A patched node only updates its own range in a linear sweep, and the global
+ * transforms of the parents are read from a cache in the same order. The flattened hierarchy is built again when the
+ * hierarchy is changed.
+ *
+ * The subtrees of the siblings are independent, so the big update is split into the subtrees and run on the thread
+ * pool of SceneUserData, the result is the same as updating serially.
+ *
+ * Every updated node is patched, so the observers of the jobs after this one see the moved descendants too.
+ */
 class TransformJob : public entt::process<TransformJob, uint32_t> {
  public:
   void
   update(uint32_t deltaTime, void* data);
 
+  /**
+   * @brief the count of the nodes updated by the last update, it's used to check that only the dirty subtrees are
+   * updated
+   */
+  size_t
+  GetUpdateCount() const {
+    return m_updateCount;
+  }
+
  private:
   void
-  UpdateTransformRecursion(Scene* scene, entt::entity entity);
+  BuildHierarchy(Scene* scene);
+
+  /**
+   * @brief update the subtrees in m_ranges, they must be disjoint and their parents must be updated
+   */
+  void
+  UpdateSubtrees(Scene* scene, ThreadPool* threadPool);
+
+  /**
+   * @brief update the global transform of the nodes in [begin, end) of the flattened hierarchy
+   */
+  void
+  UpdateRange(Scene* scene, uint32_t begin, uint32_t end);
 
  private:
+  static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t parallelNodeCount = 4096;  // the update with fewer nodes isn't worth to split
+
+  struct HierarchyNode {
+    entt::entity entity;
+    uint32_t parent;      // the index of the parent, invalidIndex for the root
+    uint32_t subtreeEnd;  // the subtree of the node is [index of the node, subtreeEnd)
+  };
+
   entt::observer m_observer;
-  // Scene* m_currentObserverScene = nullptr;
+  entt::observer m_hierarchyObserver;
+  Vector<HierarchyNode> m_nodes;
+  Vector<glm::mat4> m_globalTransforms;  // the global transforms of m_nodes
+  Vector<uint32_t> m_nodeIndices;        // the index in m_nodes, indexed by the entity
+  Vector<uint32_t> m_dirtyNodes;
+  Vector<std::pair<uint32_t, uint32_t>> m_ranges;  // the subtrees to update, [begin, end) of m_nodes
+  Vector<std::pair<uint32_t, uint32_t>> m_chunks;  // the subtrees updated by the thread pool
+  size_t m_updateCount = 0;
 };
 
 }  // namespace Marbas::Job
@@ -3,6 +3,8 @@
 #include <IconsFontAwesome6.h>
 #include <glog/logging.h>
 
+#include <array>
+
 // clang-format off
 #include <imgui/imgui.h>
 #include <ImGuizmo.h>
@@ -47,14 +49,21 @@ Application::Application(const ApplicationData& appData) {
   for (int i = 0; i < m_swapChain->imageViews.size(); i++) {
     m_aviableSemaphores.push_back(m_rhiFactory->CreateGPUSemaphore());
     m_finishSemaphores.push_back(m_rhiFactory->CreateGPUSemaphore());
+    m_renderFinishSemaphores.push_back(m_rhiFactory->CreateGPUSemaphore());
   }
-  m_renderFinishSemaphore = m_rhiFactory->CreateGPUSemaphore();
   m_imguiFinishSemaphore = m_rhiFactory->CreateGPUSemaphore();
+  m_renderBeginSemaphore = m_rhiFactory->CreateGPUSemaphore();
+  m_frameFinishSemaphore = m_rhiFactory->CreateGPUSemaphore();
 
   m_imguiContext = m_rhiFactory->GetImguiContext();
   m_imguiContext->SetRenderResultImage(m_swapChain->imageViews);
 
-  m_frameFence = m_rhiFactory->CreateFence();
+  auto* bufCtx = m_rhiFactory->GetBufferContext();
+  for (int i = 0; i < frameInFlightCount; i++) {
+    m_frameFences.push_back(m_rhiFactory->CreateFence());
+    m_frameBeginCommandBuffers.push_back(bufCtx->CreateGraphicsCommandBuffer());
+    m_frameEndCommandBuffers.push_back(bufCtx->CreateGraphicsCommandBuffer());
+  }
 
   auto registry = AssetRegistry::GetInstance();
   registry->SetProjectDir(appData.projectDir);
@@ -112,7 +121,7 @@ Application::Initialize() {
 
   // create render engine
   GPUDataManager::SetUp(m_rhiFactory.get());
-  RenderSystem::Initialize(m_rhiFactory.get());
+  RenderSystem::Initialize(m_rhiFactory.get(), frameInFlightCount);
   SceneSystem::Initialize();
   // RenderSystem::CreateRenderGraph(m_rhiFactory.get());
 
@@ -125,7 +134,9 @@ Application::Initialize() {
 void
 Application::Run() {
   int currentFrame = 0;
+  uint64_t frameCount = 0;
   bool needResize = false;
+  bool isFrameFinishSignaled = false;
 
   // SceneTreeWidget sceneTree(m_rhiFactory.get());
   Gui::GuiSceneTree sceneTree("mytree");
@@ -149,7 +160,9 @@ Application::Run() {
   voxelImageWindow.SetRenderImage(voxelImageView);
 
   // TODO
-  m_rhiFactory->ResetFence(m_frameFence);
+  for (auto* fence : m_frameFences) {
+    m_rhiFactory->ResetFence(fence);
+  }
 
   while (!glfwWindowShouldClose(m_glfwWindow)) {
     glfwPollEvents();
@@ -186,17 +199,43 @@ Application::Run() {
     auto sceneManager = SceneManager::GetInstance();
     auto scene = sceneManager->GetActiveScene();
 
-    // render scene
+    // render scene, the render graph uses the resources of the frame in flight in turn, so wait for the frame
+    // which used the same resources
+    const auto frameIndex = frameCount % frameInFlightCount;
+    auto* frameFence = m_frameFences[frameIndex];
     {
+      if (frameCount >= frameInFlightCount) {
+        m_rhiFactory->WaitForFence(frameFence);
+        m_rhiFactory->ResetFence(frameFence);
+      }
+
       SceneSystem::Update(scene).start([](auto&&) {});
 
+      // the imgui of the last frame samples the textures written by the render graph, so the graph waits for it
+      std::array<Semaphore*, 2> beginWaits = {m_aviableSemaphores[currentFrame], m_frameFinishSemaphore};
+      auto* beginCommandBuffer = m_frameBeginCommandBuffers[frameIndex];
+      beginCommandBuffer->Begin();
+      beginCommandBuffer->End();
+      beginCommandBuffer->Submit({beginWaits.data(), isFrameFinishSignaled ? 2u : 1u}, {&m_renderBeginSemaphore, 1},
+                                 nullptr);
+
       RenderSystem::Update(RenderInfo{
           .scene = scene,
           .imageIndex = currentFrame,
-          .waitSemaphore = m_aviableSemaphores[currentFrame],
-          .signalSemaphore = m_renderFinishSemaphore,
-          .fence = m_frameFence,
+          .waitSemaphore = m_renderBeginSemaphore,
+          .signalSemaphore = m_renderFinishSemaphores[currentFrame],
       });
+      frameCount++;
+
+      // the output textures are recreated when the render graph is resized
+      if (auto* imageView = renderGraphResourceManager->GetImageView("direct light"); imageView != outputImageView) {
+        outputImageView = imageView;
+        renderImageWindow.SetRenderImage(outputImageView);
+      }
+      if (auto* imageView = renderGraphResourceManager->GetImageView("vxgi color"); imageView != voxelImageView) {
+        voxelImageView = imageView;
+        voxelImageWindow.SetRenderImage(voxelImageView);
+      }
     }
 
     // draw imgui
@@ -218,14 +257,24 @@ Application::Run() {
         }
       }
 
-      EndImgui(imageIndex, m_renderFinishSemaphore, m_finishSemaphores[currentFrame]);
+      EndImgui(imageIndex, m_renderFinishSemaphores[currentFrame], m_imguiFinishSemaphore);
+
+      // the fence is signaled after the imgui, so the frame in flight isn't reused until the editor has drawn it
+      std::array<Semaphore*, 2> endSignals = {m_finishSemaphores[currentFrame], m_frameFinishSemaphore};
+      auto* endCommandBuffer = m_frameEndCommandBuffers[frameIndex];
+      endCommandBuffer->Begin();
+      endCommandBuffer->End();
+      endCommandBuffer->Submit({&m_imguiFinishSemaphore, 1}, endSignals, frameFence);
+      isFrameFinishSignaled = true;
+
+      // render the next frame at the size of the viewport
+      auto viewportSize = renderImageWindow.GetImageSize();
+      RenderSystem::SetOutputExtent(static_cast<uint32_t>(viewportSize.x), static_cast<uint32_t>(viewportSize.y));
     }
 
     // present result
     {
       auto presentResult = m_rhiFactory->Present(m_swapChain, {&m_finishSemaphores[currentFrame], 1}, imageIndex);
-      m_rhiFactory->WaitForFence(m_frameFence);
-      m_rhiFactory->ResetFence(m_frameFence);
       if (-1 == presentResult) {
         needResize = true;
         continue;
@@ -247,7 +296,18 @@ Application::Quit() {
   // clear context
   m_imguiContext->ClearUp();
 
-  m_rhiFactory->DestroyFence(m_frameFence);
+  for (auto* fence : m_frameFences) {
+    m_rhiFactory->DestroyFence(fence);
+  }
+  auto* bufCtx = m_rhiFactory->GetBufferContext();
+  for (auto* commandBuffer : m_frameBeginCommandBuffers) {
+    bufCtx->DestroyCommandBuffer(commandBuffer);
+  }
+  for (auto* commandBuffer : m_frameEndCommandBuffers) {
+    bufCtx->DestroyCommandBuffer(commandBuffer);
+  }
+  m_rhiFactory->DestroyGPUSemaphore(m_renderBeginSemaphore);
+  m_rhiFactory->DestroyGPUSemaphore(m_frameFinishSemaphore);
   RenderSystem::Destroy(m_rhiFactory.get());
 }
 
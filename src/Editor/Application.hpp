@@ -51,12 +51,20 @@ class Application final {
 
   Swapchain* m_swapChain;
   std::vector<Semaphore*> m_aviableSemaphores;
-  Semaphore* m_renderFinishSemaphore;
+  std::vector<Semaphore*> m_renderFinishSemaphores;
   Semaphore* m_imguiFinishSemaphore;
+  Semaphore* m_renderBeginSemaphore;  // the swapchain image is available and the last frame is drawn
+  Semaphore* m_frameFinishSemaphore;  // the imgui of the last frame is drawn
   std::vector<Semaphore*> m_finishSemaphores;
-  Fence* m_frameFence;
+  std::vector<Fence*> m_frameFences;  // one fence for each frame in flight
+  std::vector<GraphicsCommandBuffer*> m_frameBeginCommandBuffers;  // the empty submissions of each frame in flight
+  std::vector<GraphicsCommandBuffer*> m_frameEndCommandBuffers;
   uint32_t m_currentFrame;
 
+  // the render graph and the render data written by the CPU have a copy for each frame in flight, but the textures
+  // shown in the editor are shared, so the graph of a frame waits for the imgui of the last frame on the GPU
+  constexpr static uint32_t frameInFlightCount = 2;
+
   ImguiContext* m_imguiContext;
 };
 
@@ -61,9 +61,11 @@ RenderImageWidget::OnDraw() {
    * push the render result into the image
    */
   auto imageSize = ImGui::GetContentRegionAvail();
+  m_imageSize = imageSize;
   // auto ImagePos = ImGui::GetCursorPos();
   auto ImagePos = ImGui::GetCursorScreenPos();
   ImGui::Image(*m_image, imageSize, ImVec2(0, 0), ImVec2(1, 1));
+  const bool isImageClicked = ImGui::IsItemClicked(ImGuiMouseButton_Left);
 
   // set imguizmo draw array
   auto camera = activeScene->GetEditorCamrea();
@@ -79,6 +81,11 @@ RenderImageWidget::OnDraw() {
                            0x4FFFFFFF);
   camera->SetViewMatrix(viewMatrix);
 
+  // the click on the image selects the entity, the gizmo and the camera moving by shift are not clicks
+  if (isImageClicked && !ImGui::IsKeyDown(ImGuiKey_LeftShift) && !ImGuizmo::IsOver()) {
+    PickEntity(activeScene, ImagePos, camera.get());
+  }
+
   // draw
   auto& world = activeScene->GetWorld();
   if (world.any_of<ModelSceneNode>(m_zmoEntity) || world.any_of<EmptySceneNode>(m_zmoEntity)) {
@@ -96,6 +103,25 @@ RenderImageWidget::OnDraw() {
   camera->SetAspect(aspect);
 };
 
+void
+RenderImageWidget::PickEntity(Scene* scene, const ImVec2& imagePos, Camera* camera) {
+  auto [x, y] = ImGui::GetIO().MousePos;
+  if (m_imageSize.x <= 0 || m_imageSize.y <= 0) return;
+
+  // the y axis of the projection matrix is flipped already, so the image coordinate is mapped to ndc directly
+  const float ndcX = (x - imagePos.x) / m_imageSize.x * 2 - 1;
+  const float ndcY = (y - imagePos.y) / m_imageSize.y * 2 - 1;
+  auto invViewProjection = glm::inverse(camera->GetProjectionMatrix() * camera->GetViewMatrix());
+  auto farPoint = invViewProjection * glm::vec4(ndcX, ndcY, 1, 1);
+  auto origin = camera->GetPosition();
+  auto direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+  auto entity = scene->Pick(origin, direction, camera->GetFar());
+  if (entity != entt::null) {
+    m_zmoEntity = entity;
+  }
+}
+
 void
 RenderImageWidget::DrawModelManipulate(Scene* scene, entt::entity entity, Camera* camera) {
   using enum ImGuizmo::OPERATION;
@@ -25,6 +25,19 @@ class RenderImageWidget : public GuiWidget {
     m_image = imageId;
   }
 
+  const std::optional<ImTextureID>&
+  GetImage() const {
+    return m_image;
+  }
+
+  /**
+   * @brief the size of the region where the image is drawn, it's updated when the widget is drawn
+   */
+  ImVec2
+  GetImageSize() const {
+    return m_imageSize;
+  }
+
   void
   OnDraw() override final;
 
@@ -43,6 +56,12 @@ class RenderImageWidget : public GuiWidget {
   void
   Manipulate(Scene* scene);
 
+  /**
+   * @brief select the entity under the mouse by the bounding volume hierarchy of the scene
+   */
+  void
+  PickEntity(Scene* scene, const ImVec2& imagePos, Camera* camera);
+
   void
   DrawModelManipulate(Scene* scene, entt::entity entity, Camera* camera);
 
@@ -51,6 +70,7 @@ class RenderImageWidget : public GuiWidget {
 
  private:
   std::optional<ImTextureID> m_image;
+  ImVec2 m_imageSize = ImVec2(0, 0);
   ImguiZmoDrawInfo m_zmoDrawInfo;
   entt::entity m_zmoEntity = entt::null;
 };
@@ -92,10 +112,23 @@ class RenderImageWindow : public GuiWindow {
     m_rhiFactory = rhiFactory;
   }
 
+  /**
+   * @brief show the image view, the image created for the last image view is destroyed
+   *
+   * @note the GPU must not use the last image view, e.g. it's called after the render graph is resized
+   */
   void
   SetRenderImage(ImageView* imageView) {
-    auto image = m_rhiFactory->GetImguiContext()->CreateImGuiImage(imageView);
-    m_imageWidget.SetImage(image);
+    auto* imguiContext = m_rhiFactory->GetImguiContext();
+    if (const auto& lastImage = m_imageWidget.GetImage(); lastImage.has_value()) {
+      imguiContext->DestroyImGuiImage(*lastImage);
+    }
+    m_imageWidget.SetImage(imguiContext->CreateImGuiImage(imageView));
+  }
+
+  ImVec2
+  GetImageSize() const {
+    return m_imageWidget.GetImageSize();
   }
 
  public:
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "Common/AABBTree.hpp"
+
+namespace Marbas {
+
+class AABBTreeTest : public ::testing::Test {
+ protected:
+  BoundingBox
+  RandomBox() {
+    std::uniform_real_distribution<float> position(-100, 100);
+    std::uniform_real_distribution<float> size(0.1, 5);
+    glm::vec3 min(position(m_random), position(m_random), position(m_random));
+    return {min, min + glm::vec3(size(m_random), size(m_random), size(m_random))};
+  }
+
+  /**
+   * @brief the query of the tree must return the same boxes as testing every box
+   */
+  template <typename Query, typename Test>
+  void
+  CheckQuery(Query&& query, Test&& test) {
+    Vector<uint32_t> result;
+    query([&](uint32_t userData) { result.push_back(userData); });
+    std::sort(result.begin(), result.end());
+
+    Vector<uint32_t> expect;
+    for (uint32_t i = 0; i < m_proxies.size(); i++) {
+      if (m_proxies[i] != AABBTree::nullNode && test(m_boxes[i])) expect.push_back(i);
+    }
+    ASSERT_EQ(result, expect);
+  }
+
+  void
+  CheckQueries() {
+    auto queryBox = RandomBox();
+    queryBox.max = queryBox.max + glm::vec3(20);
+    CheckQuery([&](auto&& func) { m_tree.QueryBox(queryBox, func); },
+               [&](const BoundingBox& box) { return box.Overlap(queryBox); });
+
+    const glm::vec3 center(10, -20, 5);
+    CheckQuery([&](auto&& func) { m_tree.QuerySphere(center, 30, func); },
+               [&](const BoundingBox& box) { return box.IntersectSphere(center, 30); });
+
+    // a cube with the planes facing inside
+    Frustum frustum;
+    frustum.leftFace = Plan(glm::vec3(-30, 0, 0), glm::vec3(1, 0, 0));
+    frustum.rightFace = Plan(glm::vec3(30, 0, 0), glm::vec3(-1, 0, 0));
+    frustum.bottomFace = Plan(glm::vec3(0, -10, 0), glm::vec3(0, 1, 0));
+    frustum.topFace = Plan(glm::vec3(0, 50, 0), glm::vec3(0, -1, 0));
+    frustum.nearFace = Plan(glm::vec3(0, 0, -40), glm::vec3(0, 0, 1));
+    frustum.farFace = Plan(glm::vec3(0, 0, 20), glm::vec3(0, 0, -1));
+    CheckQuery([&](auto&& func) { m_tree.QueryFrustum(frustum, func); },
+               [&](const BoundingBox& box) { return box.IsOnFrustum(frustum); });
+
+    const glm::vec3 origin(-120, -1, 2);
+    const auto direction = glm::normalize(glm::vec3(1, 0.01, 0.02));
+    const auto invDirection = 1.0f / direction;
+    float distance;
+    CheckQuery(
+        [&](auto&& func) {
+          m_tree.QueryRay(origin, direction, 200, [&](uint32_t userData, float distance) { func(userData); });
+        },
+        [&](const BoundingBox& box) { return box.IntersectRay(origin, invDirection, 200, distance); });
+  }
+
+ protected:
+  std::mt19937 m_random{42};
+  AABBTree m_tree;
+  Vector<BoundingBox> m_boxes;
+  Vector<int32_t> m_proxies;
+};
+
+TEST_F(AABBTreeTest, Query) {
+  for (uint32_t i = 0; i < 5000; i++) {
+    m_boxes.push_back(RandomBox());
+    m_proxies.push_back(m_tree.Insert(m_boxes.back(), i));
+  }
+  ASSERT_EQ(m_tree.GetProxyCount(), 5000);
+  CheckQueries();
+
+  // move a little, move far away and remove some boxes
+  std::uniform_real_distribution<float> offset(-0.1, 0.1);
+  for (uint32_t i = 0; i < m_boxes.size(); i++) {
+    auto& box = m_boxes[i];
+    if (i % 7 == 0) {
+      m_tree.Remove(m_proxies[i]);
+      m_proxies[i] = AABBTree::nullNode;
+      continue;
+    }
+    auto delta = i % 3 == 0 ? RandomBox().min - box.min : glm::vec3(offset(m_random), offset(m_random), 0);
+    box = {box.min + delta, box.max + delta};
+    m_tree.Move(m_proxies[i], box);
+    ASSERT_TRUE(m_tree.GetFatBox(m_proxies[i]).Contains(box));
+  }
+  CheckQueries();
+
+  // the tree is balanced, so the height is O(log n)
+  ASSERT_LE(m_tree.GetHeight(), 4 * std::log2(m_tree.GetProxyCount()));
+}
+
+TEST_F(AABBTreeTest, MoveInsideFatBox) {
+  BoundingBox box{glm::vec3(0), glm::vec3(10)};
+  auto proxy = m_tree.Insert(box, 0);
+  m_tree.Insert(RandomBox(), 1);
+
+  // the small move doesn't change the tree
+  ASSERT_FALSE(m_tree.Move(proxy, {glm::vec3(0.5), glm::vec3(10.5)}));
+  ASSERT_TRUE(m_tree.Move(proxy, {glm::vec3(5), glm::vec3(15)}));
+  ASSERT_EQ(m_tree.GetBox(proxy).min, glm::vec3(5));
+}
+
+}  // namespace Marbas
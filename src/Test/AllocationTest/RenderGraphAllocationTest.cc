@@ -0,0 +1,103 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "Core/Renderer/RenderGraph/RenderGraph.hpp"
+#include "Core/Renderer/RenderGraph/RenderGraphBuilder.hpp"
+#include "Core/Renderer/RenderGraph/RenderGraphRegistry.hpp"
+#include "Test/FakeClass/FakeRHIFactory.hpp"
+
+// count the heap allocations of the test program, it's used to check that executing the graph doesn't allocate memory.
+// The replaced operator new affects the whole program, so the test has its own binary.
+static std::atomic_size_t s_allocationCount = 0;
+
+void*
+operator new(std::size_t size) {
+  s_allocationCount++;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace Marbas {
+
+class RenderGraphAllocationTest : public ::testing::Test {
+ public:
+  void
+  SetUp() override {
+    m_rhiFactory = new FakeRHIFactory();
+    m_bufferContext = static_cast<MockBufferContext*>(m_rhiFactory->GetBufferContext());
+    m_renderGraphResourceManager = std::make_shared<RenderGraphResourceManager>(m_rhiFactory);
+  }
+
+  void
+  TearDown() override {
+    m_renderGraphResourceManager = nullptr;
+    delete m_rhiFactory;
+  }
+
+ protected:
+  FakeRHIFactory* m_rhiFactory;
+  MockBufferContext* m_bufferContext;
+  std::shared_ptr<RenderGraphResourceManager> m_renderGraphResourceManager;
+};
+
+TEST_F(RenderGraphAllocationTest, ExecuteWithoutAllocation) {
+  using ::testing::Return;
+
+  // the mocks allocate memory when they are called
+  FakeGraphicsCommandBuffer graphicsCommandBuffer;
+  FakeComputeCommandBuffer computeCommandBuffer;
+  ON_CALL(*m_bufferContext, CreateGraphicsCommandBuffer()).WillByDefault(Return(&graphicsCommandBuffer));
+  ON_CALL(*m_bufferContext, CreateComputeCommandBuffer()).WillByDefault(Return(&computeCommandBuffer));
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  bool isShadowEnable = true;
+  graph.AddPass("geometry", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  graph.AddPass(
+      "shadow",
+      [&](RenderGraphGraphicsBuilder& builder) {
+        builder.BeginPipeline();
+        builder.EndPipeline();
+        return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+      },
+      [&] { return isShadowEnable; });
+  graph.AddPass("inject", [&](RenderGraphComputeBuilder& builder) {
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphComputeRegistry& registry, ComputeCommandBuffer& commandBuffer) {};
+  });
+  graph.Compile();
+
+  // the schedules of both combinations of the enabled passes are planned in the first executions
+  for (int i = 0; i < 2; i++) {
+    isShadowEnable = i == 0;
+    graph.Execute(nullptr, nullptr);
+  }
+
+  const size_t allocationCount = s_allocationCount;
+  for (int i = 0; i < 16; i++) {
+    isShadowEnable = i % 3 != 0;
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(s_allocationCount, allocationCount);
+  ASSERT_EQ(graph.GetSubmitBatches().size(), 2);
+}
+
+}  // namespace Marbas
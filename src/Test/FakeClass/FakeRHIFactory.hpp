@@ -5,6 +5,7 @@
 namespace Marbas {
 
 class MockComputeCommandBuffer final : public ComputeCommandBuffer {
+ public:
   MOCK_METHOD(void, Begin, ());
   MOCK_METHOD(void, End, ());
   MOCK_METHOD(void, Submit, (std::span<Semaphore*>, std::span<Semaphore*>, Fence*));
@@ -16,6 +17,7 @@ class MockComputeCommandBuffer final : public ComputeCommandBuffer {
 };
 
 class MockGraphicsCommandBuffer final : public GraphicsCommandBuffer {
+ public:
   MOCK_METHOD(void, Begin, ());
   MOCK_METHOD(void, End, ());
   MOCK_METHOD(void, Submit, (std::span<Semaphore*>, std::span<Semaphore*>, Fence*));
@@ -36,6 +38,87 @@ class MockGraphicsCommandBuffer final : public GraphicsCommandBuffer {
   MOCK_METHOD(void, ClearColor, (Image*, const ClearValue&, int, int, int, int));
 };
 
+/**
+ * @brief the command buffers doing nothing, unlike the mocks, calling them doesn't allocate memory
+ */
+class FakeComputeCommandBuffer final : public ComputeCommandBuffer {
+ public:
+  void
+  Begin() override {}
+
+  void
+  End() override {}
+
+  void
+  Submit(std::span<Semaphore*>, std::span<Semaphore*>, Fence*) override {}
+
+  void
+  BeginPipeline(uintptr_t) override {}
+
+  void
+  EndPipeline(uintptr_t) override {}
+
+  void
+  BindDescriptorSet(uintptr_t, const std::vector<uintptr_t>&) override {}
+
+  void
+  ClearColor(Image*, const ClearValue&, int, int, int, int) override {}
+
+  void
+  Dispatch(uint32_t, uint32_t, uint32_t) override {}
+};
+
+class FakeGraphicsCommandBuffer final : public GraphicsCommandBuffer {
+ public:
+  void
+  Begin() override {}
+
+  void
+  End() override {}
+
+  void
+  Submit(std::span<Semaphore*>, std::span<Semaphore*>, Fence*) override {}
+
+  void
+  BeginPipeline(uintptr_t, FrameBuffer*, const std::vector<ClearValue>&) override {}
+
+  void
+  EndPipeline(uintptr_t) override {}
+
+  void
+  BindDescriptorSet(uintptr_t, const std::vector<uintptr_t>&) override {}
+
+  void
+  PushConstant(uintptr_t, const void*, uint32_t, uint32_t) override {}
+
+  void
+  SetViewports(std::span<ViewportInfo>) override {}
+
+  void
+  SetScissors(std::span<ScissorInfo>) override {}
+
+  void
+  SetCullMode(CullMode) override {}
+
+  void
+  BindVertexBuffer(Buffer*) override {}
+
+  void
+  BindIndexBuffer(Buffer*) override {}
+
+  void
+  Draw(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+
+  void
+  DrawIndexed(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+
+  void
+  GenerateMipmap(Image*, uint32_t) override {}
+
+  void
+  ClearColor(Image*, const ClearValue&, int, int, int, int) override {}
+};
+
 class MockPipelineContext final : public PipelineContext {
  public:
   MOCK_METHOD(uintptr_t, CreatePipeline, (const GraphicsPipeLineCreateInfo&));
@@ -139,11 +222,7 @@ class FakeRHIFactory final : public RHIFactory {
 
   MOCK_METHOD(void, DestroyFence, (Fence*), (override));
   MOCK_METHOD(Semaphore*, CreateGPUSemaphore, (), (override));
-
-  void
-  DestroyGPUSemaphore(Semaphore* semaphore) override {
-    return;
-  }
+  MOCK_METHOD(void, DestroyGPUSemaphore, (Semaphore*), (override));
 };
 
 }  // namespace Marbas
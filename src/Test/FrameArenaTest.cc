@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "Common/FrameArena.hpp"
+
+namespace Marbas {
+
+TEST(FrameArenaTest, Allocate) {
+  FrameArena arena(256);
+  auto bytes = arena.Allocate<uint8_t>(3);
+  auto values = arena.Allocate<double>(4);
+  ASSERT_EQ(bytes.size(), 3);
+  ASSERT_EQ(values.size(), 4);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(values.data()) % alignof(double), 0);
+  for (auto value : values) {
+    ASSERT_EQ(value, 0);
+  }
+  ASSERT_TRUE(arena.Allocate<int>(0).empty());
+
+  // the allocation larger than the block gets its own block
+  auto large = arena.Allocate<uint64_t>(100);
+  ASSERT_EQ(large.size(), 100);
+  ASSERT_EQ(arena.GetBlockCount(), 2);
+  ASSERT_GE(arena.GetCapacity(), 256 + 800);
+}
+
+TEST(FrameArenaTest, ResetMergeBlocks) {
+  FrameArena arena(64);
+  for (int i = 0; i < 10; i++) {
+    arena.Allocate<uint32_t>(16);
+  }
+  const auto capacity = arena.GetCapacity();
+  ASSERT_EQ(arena.GetBlockCount(), 10);
+
+  // the memory of the last frame is merged into one block, so the same allocations fit in it in the next frame
+  arena.Reset();
+  ASSERT_EQ(arena.GetBlockCount(), 1);
+  ASSERT_EQ(arena.GetCapacity(), capacity);
+  auto first = arena.Allocate<uint32_t>(16);
+  for (int i = 1; i < 10; i++) {
+    arena.Allocate<uint32_t>(16);
+  }
+  ASSERT_EQ(arena.GetBlockCount(), 1);
+
+  arena.Reset();
+  ASSERT_EQ(arena.Allocate<uint32_t>(16).data(), first.data());
+}
+
+}  // namespace Marbas
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+
+#include "Common/AABBTree.hpp"
+#include "Common/BoundingBoxArray.hpp"
+#include "Core/Scene/Component/AABBComponent.hpp"
+
+namespace Marbas {
+
+class FrustumCullingTest : public ::testing::Test {
+ protected:
+  void
+  SetUp() override {
+    // a camera at the origin looking at +z with 90 degree field of view
+    m_frustum.leftFace = Plan(glm::vec3(0), glm::vec3(1, 0, 1));
+    m_frustum.rightFace = Plan(glm::vec3(0), glm::vec3(-1, 0, 1));
+    m_frustum.bottomFace = Plan(glm::vec3(0), glm::vec3(0, 1, 1));
+    m_frustum.topFace = Plan(glm::vec3(0), glm::vec3(0, -1, 1));
+    m_frustum.nearFace = Plan(glm::vec3(0, 0, 0.1), glm::vec3(0, 0, 1));
+    m_frustum.farFace = Plan(glm::vec3(0, 0, 500), glm::vec3(0, 0, -1));
+  }
+
+  BoundingBox
+  RandomBox() {
+    std::uniform_real_distribution<float> position(-500, 500);
+    std::uniform_real_distribution<float> size(0.1, 10);
+    glm::vec3 min(position(m_random), position(m_random), position(m_random));
+    return {min, min + glm::vec3(size(m_random), size(m_random), size(m_random))};
+  }
+
+  template <typename Func>
+  static double
+  MeasureMilliseconds(Func&& func) {
+    // the best of several runs, so the result isn't disturbed by the other processes
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < 10; i++) {
+      auto begin = std::chrono::steady_clock::now();
+      func();
+      auto end = std::chrono::steady_clock::now();
+      best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+    return best;
+  }
+
+ protected:
+  std::mt19937 m_random{42};
+  Frustum m_frustum;
+};
+
+TEST_F(FrustumCullingTest, SameAsScalar) {
+  // the count isn't a multiple of the SIMD width, so the remaining boxes are tested too
+  Vector<BoundingBox> boxes;
+  BoundingBoxArray boxArray;
+  for (int i = 0; i < 1003; i++) {
+    boxes.push_back(RandomBox());
+    boxArray.Push(boxes.back());
+  }
+
+  auto check = [&]() {
+    Vector<uint32_t> expect;
+    for (uint32_t i = 0; i < boxes.size(); i++) {
+      if (boxes[i].IsOnFrustum(m_frustum)) expect.push_back(i);
+    }
+    Vector<uint32_t> visible;
+    boxArray.CullFrustum(m_frustum, visible);
+    ASSERT_FALSE(expect.empty());
+    ASSERT_EQ(visible, expect);
+  };
+  check();
+
+  for (size_t i = 0; i < boxes.size(); i += 3) {
+    boxes[i] = RandomBox();
+    boxArray.Set(i, boxes[i]);
+  }
+  boxArray.RemoveSwapBack(10);
+  boxes[10] = boxes.back();
+  boxes.pop_back();
+  ASSERT_EQ(boxArray.GetSize(), boxes.size());
+  check();
+}
+
+// run it with --gtest_also_run_disabled_tests, the timings are recorded in the test report
+TEST_F(FrustumCullingTest, DISABLED_Benchmark) {
+  constexpr size_t count = 100000;
+  Vector<AABBComponent> components;
+  Vector<glm::mat4> transforms;
+  for (size_t i = 0; i < count; i++) {
+    auto box = RandomBox();
+    components.emplace_back(glm::vec3(-1), glm::vec3(1));
+    transforms.push_back(glm::translate(glm::mat4(1.0), box.GetCenter()));
+  }
+
+  // the world space bounding boxes are cached, they are computed again only when the transform is changed
+  BoundingBoxArray boxArray;
+  AABBTree tree;
+  for (size_t i = 0; i < count; i++) {
+    auto box = components[i].GetBoundingBox().Transform(transforms[i]);
+    boxArray.Push(box);
+    tree.Insert(box, i);
+  }
+
+  Vector<uint32_t> expect;
+  Vector<uint32_t> visible;
+  Vector<uint32_t> treeVisible;
+  double componentTime = MeasureMilliseconds([&]() {
+    expect.clear();
+    for (uint32_t i = 0; i < count; i++) {
+      if (components[i].IsOnFrustum(m_frustum, transforms[i])) expect.push_back(i);
+    }
+  });
+  double arrayTime = MeasureMilliseconds([&]() {
+    visible.clear();
+    boxArray.CullFrustum(m_frustum, visible);
+  });
+  double treeTime = MeasureMilliseconds([&]() {
+    treeVisible.clear();
+    tree.QueryFrustum(m_frustum, [&](uint32_t index) { treeVisible.push_back(index); });
+  });
+  RecordProperty("visible", static_cast<int>(visible.size()));
+  RecordProperty("AABBComponent::IsOnFrustum", FORMAT("{:.3f} ms", componentTime));
+  RecordProperty("BoundingBoxArray", FORMAT("{:.3f} ms", arrayTime));
+  RecordProperty("AABBTree", FORMAT("{:.3f} ms", treeTime));
+
+  std::sort(treeVisible.begin(), treeVisible.end());
+  ASSERT_EQ(visible, expect);
+  ASSERT_EQ(treeVisible, expect);
+}
+
+}  // namespace Marbas
@@ -58,7 +58,7 @@ TEST_F(RenderGraphTest, CreatePass) {
 }
 
 TEST_F(RenderGraphTest, MultiPass) {
-  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).Times(1);
+  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).Times(0);
 
   RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
 
@@ -83,6 +83,8 @@ TEST_F(RenderGraphTest, MultiPass) {
 
   graph.Compile();
   graph.Execute(nullptr, nullptr);
+
+  ASSERT_EQ(graph.GetSubmitBatches().size(), 1);
 }
 
 TEST_F(RenderGraphTest, CreateStructPass) {
@@ -148,6 +150,38 @@ TEST_F(RenderGraphTest, DisablePass) {
   ASSERT_EQ(init, 0);
 }
 
+TEST_F(RenderGraphTest, SignalWithoutEnabledPass) {
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  using ::testing::Eq;
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddPass(
+      "name",
+      [](RenderGraphGraphicsBuilder& builder) {
+        builder.BeginPipeline();
+        builder.EndPipeline();
+        return [](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+      },
+      []() { return false; });
+  graph.Compile();
+
+  // the caller waits for the semaphore and the fence, so they are signaled even if no pass is executed
+  Semaphore waitSemaphore;
+  Semaphore signalSemaphore;
+  Fence fence;
+  EXPECT_CALL(m_mockGraphicsCommandBuffer,
+              Submit(ElementsAre(&waitSemaphore), ElementsAre(&signalSemaphore), Eq(&fence)))
+      .Times(2);
+  graph.Execute(&waitSemaphore, &signalSemaphore, &fence);
+  graph.Execute(&waitSemaphore, &signalSemaphore, &fence);
+  ASSERT_TRUE(graph.GetSubmitBatches().empty());
+
+  // nothing is submitted if there is nothing to signal
+  EXPECT_CALL(m_mockGraphicsCommandBuffer, Submit(_, _, _)).Times(0);
+  graph.Execute(nullptr, nullptr);
+}
+
 TEST_F(RenderGraphTest, ExecutePassAlone) {
   RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
   struct TestStruct {
@@ -180,4 +214,1225 @@ TEST_F(RenderGraphTest, ExecutePassAlone) {
   graph.ExecuteAlone("name2", nullptr, nullptr, nullptr, nullptr);
 }
 
+TEST_F(RenderGraphTest, SortPassByDependency) {
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto texture1 = m_renderGraphResourceManager->CreateTexture("texture1", createInfo);
+  auto texture2 = m_renderGraphResourceManager->CreateTexture("texture2", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  Vector<String> executeOrder;
+
+  // the pass which reads the texture is added before the pass which writes it
+  graph.AddPass("reader", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(texture1, 0);
+    builder.WriteTexture(texture2);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      executeOrder.push_back("reader");
+    };
+  });
+  graph.AddPass("writer", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(texture1);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      executeOrder.push_back("writer");
+    };
+  });
+
+  // the passes aren't reordered silently, the reader must be added after the writer
+  ASSERT_FALSE(graph.Compile());
+  graph.Execute(nullptr, nullptr);
+  ASSERT_TRUE(graph.GetExecuteOrder().empty());
+  ASSERT_TRUE(executeOrder.empty());
+
+  graph.RemovePass("reader");
+  graph.AddPass("reader", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(texture1, 0);
+    builder.WriteTexture(texture2);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      executeOrder.push_back("reader");
+    };
+  });
+  ASSERT_TRUE(graph.Compile());
+  graph.Execute(nullptr, nullptr);
+
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"writer", "reader"}));
+  ASSERT_EQ(executeOrder, Vector<String>({"writer", "reader"}));
+}
+
+TEST_F(RenderGraphTest, CullUnusedPass) {
+  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).Times(0);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo);
+  auto unused = m_renderGraphResourceManager->CreateTexture("unused", createInfo);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddGraphOutput(finalTexture);
+
+  int unusedPassExecuteCount = 0;
+  auto addPass = [&](const char* name, std::optional<RenderGraphTextureHandler> input,
+                     RenderGraphTextureHandler output, int* counter) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      if (input.has_value()) builder.ReadTexture(*input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+        if (counter != nullptr) (*counter)++;
+      };
+    });
+  };
+  addPass("geometry", std::nullopt, gbuffer, nullptr);
+  addPass("unused1", gbuffer, unused, &unusedPassExecuteCount);
+  addPass("unused2", unused, unused, &unusedPassExecuteCount);
+  addPass("lighting", gbuffer, finalTexture, nullptr);
+
+  graph.Compile();
+  graph.Execute(nullptr, nullptr);
+
+  ASSERT_TRUE(graph.IsCulled("unused1"));
+  ASSERT_TRUE(graph.IsCulled("unused2"));
+  ASSERT_FALSE(graph.IsCulled("geometry"));
+  ASSERT_FALSE(graph.IsCulled("lighting"));
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "lighting"}));
+  ASSERT_EQ(unusedPassExecuteCount, 0);
+}
+
+TEST_F(RenderGraphTest, AliasTransientTexture) {
+  EXPECT_CALL(*m_bufferContext, CreateImage(::testing::_)).Times(3);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.format = ImageFormat::RGBA;
+  createInfo.mipMapLevel = 1;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto texture0 = m_renderGraphResourceManager->CreateTexture("texture0", createInfo, true);
+  auto texture1 = m_renderGraphResourceManager->CreateTexture("texture1", createInfo, true);
+  auto texture2 = m_renderGraphResourceManager->CreateTexture("texture2", createInfo, true);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddGraphOutput(finalTexture);
+
+  auto addPass = [&](const char* name, std::optional<RenderGraphTextureHandler> input,
+                     RenderGraphTextureHandler output) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      if (input.has_value()) builder.ReadTexture(*input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addPass("pass0", std::nullopt, texture0);
+  addPass("pass1", texture0, texture1);
+  addPass("pass2", texture1, texture2);
+  addPass("pass3", texture2, finalTexture);
+
+  graph.Compile();
+
+  // texture2 reuses the image of texture0, texture1 is alive when texture2 is written
+  const uint64_t textureSize = 800 * 600 * 4;
+  const auto& report = graph.GetMemoryReport();
+  ASSERT_EQ(report.textureCount, 4);
+  ASSERT_EQ(report.imageCount, 3);
+  ASSERT_EQ(report.naiveBytes, 4 * textureSize);
+  ASSERT_EQ(report.allocatedBytes, 3 * textureSize);
+  ASSERT_EQ(report.peakBytes, 3 * textureSize);
+}
+
+TEST_F(RenderGraphTest, ExportGraph) {
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.format = ImageFormat::RGBA;
+  createInfo.width = 4;
+  createInfo.height = 4;
+  auto texture0 = m_renderGraphResourceManager->CreateTexture("texture0", createInfo, true);
+  auto texture1 = m_renderGraphResourceManager->CreateTexture("texture1", createInfo, true);
+  auto texture2 = m_renderGraphResourceManager->CreateTexture("texture2", createInfo, true);
+  auto unusedTexture = m_renderGraphResourceManager->CreateTexture("unused", createInfo, true);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddGraphOutput(finalTexture);
+
+  auto addPass = [&](const char* name, std::optional<RenderGraphTextureHandler> input,
+                     RenderGraphTextureHandler output) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      if (input.has_value()) builder.ReadTexture(*input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addPass("pass0", std::nullopt, texture0);
+  addPass("unused", texture0, unusedTexture);
+  addPass("pass1", texture0, texture1);
+  addPass("pass2", texture1, texture2);
+  addPass("pass3", texture2, finalTexture);
+  graph.Compile();
+
+  // the dump is compared as text, so it must be the same for the same graph
+  using ::testing::HasSubstr;
+  auto json = graph.ExportJson();
+  ASSERT_EQ(json, graph.ExportJson());
+  ASSERT_THAT(json, HasSubstr(R"({"name": "unused", "queue": "graphics", "culled": true, "order": -1, "batch": -1)"));
+  ASSERT_THAT(json, HasSubstr(R"({"name": "pass3", "queue": "graphics", "culled": false, "order": 3, "batch": 0)"));
+  ASSERT_THAT(json, HasSubstr(R"({"name": "texture2", "type": "texture", "bytes": 64, "copies": 1, "first": 2, )"
+                              R"("last": 3, "persistent": false, "history": false, "aliasOwner": "texture0"})"));
+  ASSERT_THAT(json, HasSubstr(R"({"name": "final", "type": "texture", "bytes": 64, "copies": 1, "first": 0, )"
+                              R"("last": 3, "persistent": true, "history": false, "aliasOwner": "final"})"));
+  ASSERT_THAT(json, HasSubstr(R"("aliasGroups": [)" "\n" R"(    ["texture0", "texture2"])" "\n  ]"));
+  ASSERT_THAT(json, HasSubstr(R"("memory": {"naiveBytes": 256, "allocatedBytes": 192, "peakBytes": 192)"));
+
+  auto dot = graph.ExportGraphviz();
+  ASSERT_THAT(dot, HasSubstr(R"(pass1 [shape=box, style=dashed, label="unused\ngraphics culled"];)"));
+  ASSERT_THAT(dot, HasSubstr(R"(resource3 [shape=ellipse, label="texture2\n64 bytes x1\n[2, 3]"];)"));
+  ASSERT_THAT(dot, HasSubstr("subgraph cluster_alias0 {\n    label=\"alias texture0\";\n"
+                             "    resource0;\n    resource3;"));
+  ASSERT_THAT(dot, HasSubstr("pass3 -> resource3;\n  resource3 -> pass4;"));
+}
+
+TEST_F(RenderGraphTest, BatchSubmit) {
+  using ::testing::_;
+
+  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).Times(2);
+  EXPECT_CALL(m_mockGraphicsCommandBuffer, Submit(_, _, _)).Times(2);
+  EXPECT_CALL(m_mockComputeCommandBuffer, Submit(_, _, _)).Times(1);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo);
+  auto voxel = m_renderGraphResourceManager->CreateTexture("voxel", createInfo);
+  auto lighting = m_renderGraphResourceManager->CreateTexture("lighting", createInfo);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  auto addPass = [&](const char* name, Vector<RenderGraphTextureHandler> inputs, RenderGraphTextureHandler output) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      for (const auto& input : inputs) builder.ReadTexture(input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addPass("geometry", {}, gbuffer);
+  graph.AddPass("inject", [&](RenderGraphComputeBuilder& builder) {
+    builder.ReadTexture(gbuffer, 0);
+    builder.ReadStorageImage(voxel);
+    return [=](RenderGraphComputeRegistry& registry, ComputeCommandBuffer& commandBuffer) {};
+  });
+  addPass("lighting", {gbuffer, voxel}, lighting);
+  addPass("post", {lighting}, finalTexture);
+
+  graph.Compile();
+  graph.Execute(nullptr, nullptr);
+
+  // the consecutive graphics passes are submitted together, the semaphores are only used between the queues
+  const auto& batches = graph.GetSubmitBatches();
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "inject", "lighting", "post"}));
+  ASSERT_EQ(batches.size(), 3);
+  ASSERT_EQ(batches[0].passes, Vector<int>({0}));
+  ASSERT_EQ(batches[1].passes, Vector<int>({1}));
+  ASSERT_EQ(batches[2].passes, Vector<int>({2, 3}));
+  ASSERT_EQ(batches[0].waitBatches, Vector<int>({}));
+  ASSERT_EQ(batches[1].waitBatches, Vector<int>({0}));
+  ASSERT_EQ(batches[2].waitBatches, Vector<int>({1}));
+}
+
+TEST_F(RenderGraphTest, AsyncCompute) {
+  // the semaphores are kept between the executions and destroyed with the graph
+  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).Times(4);
+  EXPECT_CALL(*m_rhiFactory, DestroyGPUSemaphore(::testing::_)).Times(4);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo);
+  auto shadowMap = m_renderGraphResourceManager->CreateTexture("shadowMap", createInfo);
+  auto voxel = m_renderGraphResourceManager->CreateTexture("voxel", createInfo);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  auto addPass = [&](const char* name, Vector<RenderGraphTextureHandler> inputs, RenderGraphTextureHandler output) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      for (const auto& input : inputs) builder.ReadTexture(input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addPass("geometry", {}, gbuffer);
+  graph.AddPass("inject", [&](RenderGraphComputeBuilder& builder) {
+    builder.ReadTexture(gbuffer, 0);
+    builder.ReadStorageImage(voxel);
+    return [=](RenderGraphComputeRegistry& registry, ComputeCommandBuffer& commandBuffer) {};
+  });
+  addPass("shadow", {}, shadowMap);
+  addPass("lighting", {gbuffer, shadowMap, voxel}, finalTexture);
+
+  graph.Compile();
+
+  // the shadow pass doesn't depend on the compute pass, so it only waits for the first batch which waits the external
+  // semaphore. The lighting pass waits for the shadow pass by a semaphore too, the submission order on the same queue
+  // doesn't make the shadow map visible to it.
+  const auto& batches = graph.GetSubmitBatches();
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "inject", "shadow", "lighting"}));
+  ASSERT_EQ(batches.size(), 4);
+  ASSERT_EQ(batches[1].queue, PassType::Compute);
+  ASSERT_EQ(batches[1].waitBatches, Vector<int>({0}));
+  ASSERT_EQ(batches[2].passes, Vector<int>({2}));
+  ASSERT_EQ(batches[2].waitBatches, Vector<int>({0}));
+  ASSERT_EQ(batches[3].passes, Vector<int>({3}));
+  ASSERT_EQ(batches[3].waitBatches, Vector<int>({2, 1}));
+}
+
+TEST_F(RenderGraphTest, AliasAcrossQueue) {
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo, true);
+  auto shadowMap = m_renderGraphResourceManager->CreateTexture("shadowMap", createInfo, true);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  auto addComputePass = [&](const char* name, RenderGraphTextureHandler input) {
+    graph.AddPass(name, [=](RenderGraphComputeBuilder& builder) {
+      builder.ReadTexture(input, 0);
+      return [=](RenderGraphComputeRegistry& registry, ComputeCommandBuffer& commandBuffer) {};
+    });
+  };
+  auto addGraphicsPass = [&](const char* name, RenderGraphTextureHandler output) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addGraphicsPass("geometry", gbuffer);
+  addComputePass("inject", gbuffer);
+  addGraphicsPass("shadow", shadowMap);
+  addComputePass("lighting", shadowMap);
+
+  ASSERT_TRUE(graph.Compile());
+
+  // the shadow map reuses the image of the gbuffer, so the shadow pass must wait for the compute pass reading the
+  // gbuffer, although they don't share any resource
+  const auto& batches = graph.GetSubmitBatches();
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 1);
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "inject", "shadow", "lighting"}));
+  ASSERT_EQ(batches.size(), 4);
+  ASSERT_EQ(batches[1].waitBatches, Vector<int>({0}));
+  ASSERT_EQ(batches[2].waitBatches, Vector<int>({1}));
+  ASSERT_EQ(batches[3].waitBatches, Vector<int>({2}));
+}
+
+TEST_F(RenderGraphTest, ExternalTextureDependency) {
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image3DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::STORAGE;
+  auto voxel = m_renderGraphResourceManager->AddExternalTexture("voxel", createInfo, {});
+  auto radiance = m_renderGraphResourceManager->AddExternalTexture("radiance", createInfo, {});
+
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  auto addComputePass = [&](const char* name, auto&& setUp) {
+    graph.AddPass(name, [=](RenderGraphComputeBuilder& builder) {
+      setUp(builder);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=](RenderGraphComputeRegistry& registry, ComputeCommandBuffer& commandBuffer) {};
+    });
+  };
+
+  // the injection is declared first, so it reads the voxels written by the voxelization of the last frame, and the
+  // voxelization must wait for it
+  addComputePass("inject", [=](RenderGraphComputeBuilder& builder) {
+    builder.ReadExternalTexture(voxel);
+    builder.WriteExternalTexture(radiance);
+  });
+  graph.AddPass("voxelization", [=](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteExternalTexture(voxel);
+    builder.SetFramebufferSize(256, 256, 1);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  graph.AddPass("trace", [=](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadExternalTexture(radiance);
+    builder.WriteTexture(finalTexture);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+
+  // the compute pass without any dependency keeps its declaration order instead of being moved forward
+  addComputePass("other", [](RenderGraphComputeBuilder& builder) {});
+  graph.AddGraphOutput(finalTexture);
+  ASSERT_TRUE(graph.Compile());
+
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"inject", "voxelization", "trace", "other"}));
+}
+
+TEST_F(RenderGraphTest, ParallelCompile) {
+  using ::testing::An;
+
+  // the last pass has the same pipeline as the first one, it's created once even if they are initialized together
+  EXPECT_CALL(*m_pipelineContext, CreatePipeline(An<const GraphicsPipeLineCreateInfo&>())).Times(8);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.SetCompileThreadPool(std::make_shared<ThreadPool>(3));
+
+  for (uint32_t i = 0; i < 9; i++) {
+    auto name = FORMAT("pass{}", i + 1);
+    graph.AddPass(name.c_str(), [=](RenderGraphGraphicsBuilder& builder) {
+      builder.BeginPipeline();
+      builder.SetPushConstantSize(4 * (i % 8 + 1));
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  }
+  graph.Compile();
+
+  // every initialized pass reports its compile time in execute order
+  const auto& report = graph.GetCompileReport();
+  const auto executeOrder = graph.GetExecuteOrder();
+  ASSERT_EQ(report.passes.size(), 9);
+  for (size_t i = 0; i < report.passes.size(); i++) {
+    ASSERT_EQ(report.passes[i].name, executeOrder[i]);
+    ASSERT_GE(report.passes[i].milliseconds, 0);
+  }
+
+  // nothing is initialized again
+  graph.Compile();
+  ASSERT_TRUE(graph.GetCompileReport().passes.empty());
+}
+
+TEST_F(RenderGraphTest, PassTiming) {
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+
+  bool isShadowEnable = true;
+  auto addPass = [&](const char* name, std::function<bool()> isEnable) {
+    graph.AddPass(
+        name,
+        [&](RenderGraphGraphicsBuilder& builder) {
+          builder.BeginPipeline();
+          builder.EndPipeline();
+          return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+        },
+        isEnable);
+  };
+  addPass("geometry", nullptr);
+  addPass("shadow", [&] { return isShadowEnable; });
+  graph.Compile();
+
+  // the passes are recorded into one command buffer, only the leader submits it
+  graph.Execute(nullptr, nullptr);
+  isShadowEnable = false;
+  graph.Execute(nullptr, nullptr);
+  ASSERT_EQ(graph.GetPassTimingHistory("geometry").size(), 2);
+  ASSERT_EQ(graph.GetPassTimingHistory("shadow").size(), 1);
+  ASSERT_EQ(graph.GetPassTimingHistory("shadow")[0].submitMilliseconds, 0);
+  ASSERT_TRUE(graph.GetPassTimingHistory("unknown").empty());
+  ASSERT_FALSE(graph.GetAveragePassTiming("unknown").has_value());
+
+  // only the last executions are kept
+  for (uint32_t i = 0; i < details::RenderGraphPass::timingHistorySize; i++) {
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(graph.GetPassTimingHistory("geometry").size(), details::RenderGraphPass::timingHistorySize);
+  auto average = graph.GetAveragePassTiming("geometry");
+  ASSERT_TRUE(average.has_value());
+  ASSERT_GE(average->recordMilliseconds, 0);
+  ASSERT_GE(average->submitMilliseconds, 0);
+}
+
+TEST_F(RenderGraphTest, InferAttachmentAction) {
+  using ::testing::_;
+  using ::testing::An;
+
+  Vector<Vector<ColorTargetDesc>> colorTargets;
+  ON_CALL(*m_pipelineContext, CreatePipeline(An<const GraphicsPipeLineCreateInfo&>()))
+      .WillByDefault([&](const GraphicsPipeLineCreateInfo& createInfo) {
+        colorTargets.push_back(createInfo.outputRenderTarget.colorAttachments);
+        return 0;
+      });
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo, true);
+  auto scratch = m_renderGraphResourceManager->CreateTexture("scratch", createInfo, true);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  const ColorTargetDesc keepTarget = {
+      .initAction = AttachmentInitAction::KEEP,
+      .finalAction = AttachmentFinalAction::READ,
+      .usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET,
+      .sampleCount = SampleCount::BIT1,
+      .format = ImageFormat::RGBA,
+  };
+  graph.AddPass("geometry", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(gbuffer);
+    builder.BeginPipeline();
+    builder.AddColorTarget(keepTarget);
+    builder.EndPipeline();
+    return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  graph.AddPass("lighting", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(gbuffer, 0);
+    builder.WriteTexture(finalTexture);
+    builder.WriteTexture(scratch);
+    builder.BeginPipeline();
+    builder.AddColorTarget(keepTarget);
+    builder.AddColorTarget(keepTarget);
+    builder.EndPipeline();
+    return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+
+  graph.Compile();
+
+  // the transient texture isn't written before the pass, so clear it instead of loading the undefined content, and
+  // it's discarded if no pass uses it later
+  ASSERT_EQ(colorTargets.size(), 2);
+  ASSERT_EQ(colorTargets[0][0].initAction, AttachmentInitAction::CLEAR);
+  ASSERT_EQ(colorTargets[0][0].finalAction, AttachmentFinalAction::READ);
+  ASSERT_EQ(colorTargets[1][0].initAction, AttachmentInitAction::KEEP);
+  ASSERT_EQ(colorTargets[1][0].finalAction, AttachmentFinalAction::READ);
+  ASSERT_EQ(colorTargets[1][1].initAction, AttachmentInitAction::CLEAR);
+  ASSERT_EQ(colorTargets[1][1].finalAction, AttachmentFinalAction::DISCARD);
+}
+
+TEST_F(RenderGraphTest, FrameInFlight) {
+  using ::testing::_;
+
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(3);
+  EXPECT_CALL(*m_bufferContext, CreateGraphicsCommandBuffer()).Times(4);
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(_)).Times(4);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo, true);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(finalTexture);
+
+  Vector<uint32_t> frameIndices;
+  graph.AddPass("geometry", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(gbuffer);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      frameIndices.push_back(registry.GetFrameIndex());
+    };
+  });
+  graph.AddPass("lighting", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(gbuffer, 0);
+    builder.WriteTexture(finalTexture);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+
+  graph.Compile();
+  for (int i = 0; i < 3; i++) {
+    graph.Execute(nullptr, nullptr);
+  }
+
+  // the pass executed alone uses the next frame in flight too
+  graph.ExecuteAlone("geometry");
+  graph.Execute(nullptr, nullptr);
+
+  // every frame in flight has its own copy of the transient texture, the output is shared by all frames
+  ASSERT_EQ(graph.GetFrameInFlightCount(), 2);
+  ASSERT_EQ(frameIndices, Vector<uint32_t>({0, 1, 0, 1, 0}));
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 3);
+}
+
+TEST_F(RenderGraphTest, ChainFrameInFlight) {
+  using ::testing::_;
+  using ::testing::ElementsAre;
+  using ::testing::InSequence;
+  using ::testing::Return;
+
+  // the output is shared by the frames in flight, so every execution waits for the last one on the GPU
+  Semaphore frameSemaphore;
+  EXPECT_CALL(*m_rhiFactory, CreateGPUSemaphore()).WillOnce(Return(&frameSemaphore));
+  EXPECT_CALL(*m_rhiFactory, DestroyGPUSemaphore(&frameSemaphore)).Times(1);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(finalTexture);
+
+  bool isEnable = true;
+  graph.AddPass(
+      "lighting",
+      [&](RenderGraphGraphicsBuilder& builder) {
+        builder.WriteTexture(finalTexture);
+        builder.BeginPipeline();
+        builder.EndPipeline();
+        return [](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+      },
+      [&]() { return isEnable; });
+  ASSERT_TRUE(graph.Compile());
+
+  Semaphore waitSemaphore;
+  Semaphore signalSemaphore;
+  {
+    InSequence sequence;
+    EXPECT_CALL(m_mockGraphicsCommandBuffer,
+                Submit(ElementsAre(&waitSemaphore), ElementsAre(&signalSemaphore, &frameSemaphore), _));
+    EXPECT_CALL(m_mockGraphicsCommandBuffer,
+                Submit(ElementsAre(&waitSemaphore, &frameSemaphore), ElementsAre(&signalSemaphore, &frameSemaphore), _))
+        .Times(2);
+    EXPECT_CALL(m_mockGraphicsCommandBuffer, Submit(ElementsAre(&frameSemaphore), ElementsAre(&frameSemaphore), _));
+  }
+  graph.Execute(&waitSemaphore, &signalSemaphore);
+  graph.Execute(&waitSemaphore, &signalSemaphore);
+
+  // the empty submission keeps the chain if no pass is enabled
+  isEnable = false;
+  graph.Execute(&waitSemaphore, &signalSemaphore);
+  isEnable = true;
+  graph.ExecuteAlone("lighting");
+}
+
+TEST_F(RenderGraphTest, IncrementalCompile) {
+  using ::testing::_;
+  using ::testing::An;
+
+  EXPECT_CALL(*m_pipelineContext, CreatePipeline(An<const GraphicsPipeLineCreateInfo&>())).Times(3);
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(_)).Times(6);
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(4);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto gbuffer = m_renderGraphResourceManager->CreateTexture("gbuffer", createInfo, true);
+  auto finalTexture = m_renderGraphResourceManager->CreateTexture("final", createInfo);
+  auto postTexture = m_renderGraphResourceManager->CreateTexture("post", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddGraphOutput(finalTexture);
+
+  // the push constant sizes make the pipelines different, so they aren't shared by the pipeline cache
+  auto addPass = [&](const char* name, std::optional<RenderGraphTextureHandler> input,
+                     RenderGraphTextureHandler output, uint32_t pushConstantSize) {
+    graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+      if (input.has_value()) builder.ReadTexture(*input, 0);
+      builder.WriteTexture(output);
+      builder.BeginPipeline();
+      builder.SetPushConstantSize(pushConstantSize);
+      builder.EndPipeline();
+      return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+    });
+  };
+  addPass("geometry", std::nullopt, gbuffer, 4);
+  addPass("lighting", gbuffer, finalTexture, 8);
+  graph.Compile();
+
+  // only the new pass and its texture are created
+  addPass("post", finalTexture, postTexture, 16);
+  graph.AddGraphOutput(postTexture);
+  graph.Compile();
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "lighting", "post"}));
+
+  // resizing the texture recreates the framebuffers of the passes using it, but not their pipelines
+  createInfo.width = 1024;
+  createInfo.height = 768;
+  m_renderGraphResourceManager->UpdateTexture(gbuffer, createInfo);
+  graph.Compile();
+
+  // the invalidated pass gets its pipeline again, the create info isn't changed, so it's found in the pipeline cache
+  graph.InvalidatePass("post");
+  graph.Compile();
+
+  // nothing is recreated after removing a pass
+  graph.RemovePass("post");
+  graph.Compile();
+  graph.Execute(nullptr, nullptr);
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"geometry", "lighting"}));
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 3);
+}
+
+TEST_F(RenderGraphTest, PipelineCache) {
+  using ::testing::_;
+  using ::testing::An;
+
+  EXPECT_CALL(*m_pipelineContext, CreatePipeline(An<const GraphicsPipeLineCreateInfo&>())).Times(2);
+  EXPECT_CALL(*m_pipelineContext, DestroyPipeline(_)).Times(2);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto firstTexture = m_renderGraphResourceManager->CreateTexture("first", createInfo);
+  auto secondTexture = m_renderGraphResourceManager->CreateTexture("second", createInfo);
+  auto thirdTexture = m_renderGraphResourceManager->CreateTexture("third", createInfo);
+  auto* pipelineCache = m_renderGraphResourceManager->m_pipelineCache.get();
+
+  {
+    RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+    graph.AddGraphOutput(firstTexture);
+    graph.AddGraphOutput(secondTexture);
+    graph.AddGraphOutput(thirdTexture);
+
+    auto addPass = [&](const char* name, RenderGraphTextureHandler output, uint32_t pushConstantSize) {
+      graph.AddPass(name, [=](RenderGraphGraphicsBuilder& builder) {
+        builder.WriteTexture(output);
+        builder.BeginPipeline();
+        builder.SetPushConstantSize(pushConstantSize);
+        builder.EndPipeline();
+        return [=](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+      });
+    };
+
+    // the identical pipelines of two passes are created only once
+    addPass("first", firstTexture, 4);
+    addPass("second", secondTexture, 4);
+    addPass("third", thirdTexture, 8);
+    graph.Compile();
+    ASSERT_EQ(pipelineCache->GetPipelineCount(), 2);
+
+    // the pipeline isn't destroyed with the pass, adding the pass again reuses it
+    graph.RemovePass("third");
+    graph.Compile();
+    addPass("third", thirdTexture, 8);
+    graph.Compile();
+    ASSERT_EQ(pipelineCache->GetPipelineCount(), 2);
+  }
+
+  // the pipelines aren't used after the graph is destroyed
+  pipelineCache->ClearUnused();
+  ASSERT_EQ(pipelineCache->GetPipelineCount(), 0);
+}
+
+TEST_F(RenderGraphTest, ExternalTexture) {
+  using ::testing::_;
+
+  // the image views and framebuffers are identified by the images, only the images of the lighting texture are created
+  // and destroyed by the graph
+  Image lightingImage;
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(2).WillRepeatedly(::testing::Return(&lightingImage));
+  EXPECT_CALL(*m_bufferContext, DestroyImage(_)).Times(::testing::AnyNumber());
+  EXPECT_CALL(*m_bufferContext, DestroyImage(::testing::Ne(&lightingImage))).Times(0);
+  EXPECT_CALL(*m_bufferContext, CreateImageView(_)).WillRepeatedly([](const ImageViewCreateInfo& createInfo) {
+    return reinterpret_cast<ImageView*>(createInfo.image);
+  });
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(_)).Times(8).WillRepeatedly([](const FrameBufferCreateInfo& info) {
+    return reinterpret_cast<FrameBuffer*>(info.attachments.colorAttachments[0]);
+  });
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  Vector<Image*> swapchainImages;
+  for (uintptr_t i = 1; i <= 3; i++) {
+    swapchainImages.push_back(reinterpret_cast<Image*>(i));
+  }
+  auto lighting = m_renderGraphResourceManager->CreateTexture("lighting", createInfo, true);
+  auto swapchain = m_renderGraphResourceManager->AddExternalTexture("swapchain", createInfo, swapchainImages);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(swapchain);
+
+  graph.AddPass("lighting", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(lighting);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  FrameBuffer* framebuffer = nullptr;
+  graph.AddPass("present", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(lighting, 0);
+    builder.WriteTexture(swapchain);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      framebuffer = registry.GetFrameBuffer();
+    };
+  });
+  graph.Compile();
+
+  // the external texture orders the passes like other textures but isn't allocated by the graph, the present pass has
+  // a framebuffer for each swapchain image in every frame in flight, and the lighting pass has one for every frame
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"lighting", "present"}));
+  ASSERT_EQ(graph.GetMemoryReport().textureCount, 1);
+
+  // the selected image is written without compiling again
+  for (uint32_t imageIndex : {2, 0, 1}) {
+    m_renderGraphResourceManager->SetExternalImageIndex(swapchain, imageIndex);
+    graph.Execute(nullptr, nullptr);
+    ASSERT_EQ(framebuffer, reinterpret_cast<FrameBuffer*>(swapchainImages[imageIndex]));
+  }
+}
+
+TEST_F(RenderGraphTest, HistoryTexture) {
+  using ::testing::_;
+
+  // the image views are identified by the images, remember the image view bound to each descriptor set
+  Vector<std::unique_ptr<Image>> images;
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(3).WillRepeatedly([&](const ImageCreateInfo&) {
+    return images.emplace_back(std::make_unique<Image>()).get();
+  });
+  EXPECT_CALL(*m_bufferContext, CreateImageView(_)).WillRepeatedly([](const ImageViewCreateInfo& createInfo) {
+    return reinterpret_cast<ImageView*>(createInfo.image);
+  });
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(_)).WillRepeatedly([](const FrameBufferCreateInfo& info) {
+    const auto& colors = info.attachments.colorAttachments;
+    return colors.empty() ? nullptr : reinterpret_cast<FrameBuffer*>(colors[0]);
+  });
+  uintptr_t descriptorSetId = 0;
+  EXPECT_CALL(*m_pipelineContext, CreateDescriptorSet(_)).WillRepeatedly([&](const DescriptorSetArgument&) {
+    return ++descriptorSetId;
+  });
+  HashMap<uintptr_t, ImageView*> boundImages;
+  EXPECT_CALL(*m_pipelineContext, BindImage(_)).WillRepeatedly([&](const BindImageInfo& info) {
+    boundImages[info.descriptorSet] = info.imageView;
+  });
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto accumulation = m_renderGraphResourceManager->CreateHistoryTexture("accumulation", createInfo);
+
+  // the pass reads the previous frame and writes the current frame, it isn't culled though nothing reads its output
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  Vector<std::pair<FrameBuffer*, ImageView*>> frames;
+  Vector<bool> isHistoryValid;
+  graph.AddPass("taa", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadHistoryTexture(accumulation, 0);
+    builder.WriteTexture(accumulation);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      frames.emplace_back(registry.GetFrameBuffer(), boundImages[registry.GetInputDescriptorSet()]);
+      isHistoryValid.push_back(registry.IsHistoryValid(accumulation));
+    };
+  });
+  graph.AddPass("other", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadHistoryTexture(accumulation, 0);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  graph.Compile();
+  ASSERT_EQ(graph.GetExecuteOrder(), Vector<StringView>({"taa", "other"}));
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 3);
+
+  // every frame reads the image written by the last frame
+  for (int i = 0; i < 4; i++) {
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(frames.size(), 4);
+  for (int i = 1; i < 4; i++) {
+    ASSERT_NE(reinterpret_cast<void*>(frames[i].first), reinterpret_cast<void*>(frames[i].second));
+    ASSERT_EQ(reinterpret_cast<void*>(frames[i].second), reinterpret_cast<void*>(frames[i - 1].first));
+  }
+  ASSERT_EQ(isHistoryValid, Vector<bool>({false, true, true, true}));
+}
+
+TEST_F(RenderGraphTest, HistoryTextureSkipWriter) {
+  using ::testing::_;
+
+  Vector<std::unique_ptr<Image>> images;
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(2).WillRepeatedly([&](const ImageCreateInfo&) {
+    return images.emplace_back(std::make_unique<Image>()).get();
+  });
+  EXPECT_CALL(*m_bufferContext, CreateImageView(_)).WillRepeatedly([](const ImageViewCreateInfo& createInfo) {
+    return reinterpret_cast<ImageView*>(createInfo.image);
+  });
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(_)).WillRepeatedly([](const FrameBufferCreateInfo& info) {
+    const auto& colors = info.attachments.colorAttachments;
+    return colors.empty() ? nullptr : reinterpret_cast<FrameBuffer*>(colors[0]);
+  });
+  uintptr_t descriptorSetId = 0;
+  EXPECT_CALL(*m_pipelineContext, CreateDescriptorSet(_)).WillRepeatedly([&](const DescriptorSetArgument&) {
+    return ++descriptorSetId;
+  });
+  HashMap<uintptr_t, ImageView*> boundImages;
+  EXPECT_CALL(*m_pipelineContext, BindImage(_)).WillRepeatedly([&](const BindImageInfo& info) {
+    boundImages[info.descriptorSet] = info.imageView;
+  });
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 800;
+  createInfo.height = 600;
+  auto accumulation = m_renderGraphResourceManager->CreateHistoryTexture("accumulation", createInfo);
+
+  // the history texture has its own copy of the previous frame even with one frame in flight
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  bool isTaaEnable = true;
+  Vector<std::pair<void*, void*>> taaFrames;  // the written and the history image of the taa pass
+  Vector<void*> otherHistory;
+  graph.AddPass(
+      "taa",
+      [&](RenderGraphGraphicsBuilder& builder) {
+        builder.ReadHistoryTexture(accumulation, 0);
+        builder.WriteTexture(accumulation);
+        builder.BeginPipeline();
+        builder.EndPipeline();
+        return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+          taaFrames.emplace_back(registry.GetFrameBuffer(), boundImages[registry.GetInputDescriptorSet()]);
+        };
+      },
+      [&]() { return isTaaEnable; });
+  graph.AddPass("other", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadHistoryTexture(accumulation, 0);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      otherHistory.push_back(boundImages[registry.GetInputDescriptorSet()]);
+    };
+  });
+  graph.Compile();
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 2);
+
+  for (bool isEnable : {true, true, false, true}) {
+    isTaaEnable = isEnable;
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(taaFrames.size(), 3);
+  ASSERT_EQ(otherHistory.size(), 4);
+  for (const auto& [written, history] : taaFrames) {
+    ASSERT_NE(written, history);
+  }
+
+  // the texture isn't advanced in the frame the writer is skipped, so the history is still the last written frame
+  ASSERT_EQ(otherHistory[1], taaFrames[0].first);
+  ASSERT_EQ(otherHistory[2], taaFrames[1].first);
+  ASSERT_EQ(otherHistory[3], taaFrames[1].first);
+  ASSERT_EQ(taaFrames[2].second, taaFrames[1].first);
+}
+
+TEST_F(RenderGraphTest, UpdatePolicy) {
+  using ::testing::_;
+
+  Image image;
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).WillRepeatedly(::testing::Return(&image));
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 256;
+  createInfo.height = 128;
+  auto sky = m_renderGraphResourceManager->CreateTexture("sky", createInfo, true);
+  auto output = m_renderGraphResourceManager->CreateTexture("output", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(output);
+  HashMap<String, Vector<int>> executeFrames;
+  Vector<uint32_t> slices;
+  int frame = 0;
+  graph.AddPass("sky", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(sky);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      executeFrames["sky"].push_back(frame);
+    };
+  });
+  graph.AddPass("final", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.ReadTexture(sky, 0);
+    builder.WriteTexture(output);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      executeFrames["final"].push_back(frame);
+    };
+  });
+  graph.AddPass("cascade", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      slices.push_back(registry.GetUpdateSlice());
+    };
+  });
+  for (const char* name : {"probeA", "probeB"}) {
+    graph.AddPass(name, [&, name](RenderGraphGraphicsBuilder& builder) {
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [&, name](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+        executeFrames[name].push_back(frame);
+      };
+    });
+  }
+  graph.SetPassUpdatePolicy("sky", {.interval = 3});
+  graph.SetPassUpdatePolicy("cascade", {.sliceCount = 3});
+  graph.SetPassUpdatePolicy("probeA", {.isBudgeted = true});
+  graph.SetPassUpdatePolicy("probeB", {.isBudgeted = true});
+  graph.Compile();
+
+  // the transient output of the amortized pass is kept between the frames, so it has only one image
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 2);
+
+  for (frame = 0; frame < 7; frame++) {
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(executeFrames["sky"], Vector<int>({0, 3, 6}));
+  ASSERT_EQ(executeFrames["final"], Vector<int>({0, 1, 2, 3, 4, 5, 6}));
+  ASSERT_EQ(slices, Vector<uint32_t>({0, 1, 2, 0, 1, 2, 0}));
+
+  // no budget, only the budgeted pass waiting the longest is executed in a frame
+  auto& probeA = executeFrames["probeA"];
+  auto& probeB = executeFrames["probeB"];
+  ASSERT_EQ(probeA.size() + probeB.size(), 7);
+  ASSERT_EQ(std::abs(static_cast<int>(probeA.size()) - static_cast<int>(probeB.size())), 1);
+  for (size_t i = 1; i < probeA.size(); i++) {
+    ASSERT_EQ(probeA[i] - probeA[i - 1], 2);
+  }
+
+  // the budget is big enough for both passes
+  graph.SetUpdateBudget(1000);
+  probeA.clear();
+  probeB.clear();
+  for (frame = 0; frame < 2; frame++) {
+    graph.Execute(nullptr, nullptr);
+  }
+  ASSERT_EQ(probeA, Vector<int>({0, 1}));
+  ASSERT_EQ(probeB, Vector<int>({0, 1}));
+
+  // the pass is executed again after its outputs are recreated
+  createInfo.width = 512;
+  m_renderGraphResourceManager->UpdateTexture(sky, createInfo);
+  graph.Compile();
+  executeFrames["sky"].clear();
+  graph.Execute(nullptr, nullptr);
+  ASSERT_EQ(executeFrames["sky"].size(), 1);
+}
+
+TEST_F(RenderGraphTest, SkipUnchangedPass) {
+  using ::testing::_;
+
+  Image image;
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).WillRepeatedly(::testing::Return(&image));
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 256;
+  createInfo.height = 64;
+  auto lut = m_renderGraphResourceManager->CreateTexture("lut", createInfo, true);
+  auto sky = m_renderGraphResourceManager->CreateTexture("sky", createInfo, true);
+  auto output = m_renderGraphResourceManager->CreateTexture("output", createInfo);
+
+  // the lut depends on a parameter, the sky only depends on the lut, the final pass is executed in every frame
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(output);
+  uint64_t lutParam = 1;
+  Vector<String> executed;
+  auto addPass = [&](const char* name, std::optional<RenderGraphTextureHandler> input,
+                     RenderGraphTextureHandler outputTexture) {
+    graph.AddPass(name, [&, name, input, outputTexture](RenderGraphGraphicsBuilder& builder) {
+      if (input.has_value()) builder.ReadTexture(*input, 0);
+      builder.WriteTexture(outputTexture);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [&, name](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+        executed.push_back(name);
+      };
+    });
+  };
+  addPass("lut", std::nullopt, lut);
+  addPass("sky", lut, sky);
+  addPass("final", sky, output);
+  graph.SetPassInputHash("lut", [&]() { return lutParam; });
+  graph.SetPassInputHash("sky", []() { return 0; });
+  graph.Compile();
+
+  // the skipped passes keep their transient outputs
+  ASSERT_EQ(graph.GetMemoryReport().imageCount, 3);
+
+  auto executeFrame = [&]() {
+    executed.clear();
+    graph.Execute(nullptr, nullptr);
+    return executed;
+  };
+  ASSERT_EQ(executeFrame(), Vector<String>({"lut", "sky", "final"}));
+  ASSERT_EQ(executeFrame(), Vector<String>({"final"}));
+
+  // the sky is executed again because the content of its input is changed
+  lutParam = 2;
+  ASSERT_EQ(executeFrame(), Vector<String>({"lut", "sky", "final"}));
+  ASSERT_EQ(executeFrame(), Vector<String>({"final"}));
+
+  auto statistics = graph.GetPassStatistics("sky");
+  ASSERT_EQ(statistics.executeCount, 2);
+  ASSERT_EQ(statistics.skipCount, 2);
+
+  // the pass is executed again after its output is recreated
+  createInfo.width = 512;
+  m_renderGraphResourceManager->UpdateTexture(sky, createInfo);
+  graph.Compile();
+  ASSERT_EQ(executeFrame(), Vector<String>({"sky", "final"}));
+}
+
+TEST_F(RenderGraphTest, BufferResource) {
+  using ::testing::_;
+
+  uintptr_t bufferId = 0;
+  EXPECT_CALL(*m_bufferContext, CreateBuffer(_, _, _, _)).Times(7).WillRepeatedly([&](auto...) {
+    return reinterpret_cast<Buffer*>(++bufferId);
+  });
+
+  auto camera = m_renderGraphResourceManager->CreateBuffer("camera", BufferType::UNIFORM_BUFFER, 256, true);
+  auto vertex0 = m_renderGraphResourceManager->CreateBuffer("vertex0", BufferType::VERTEX_BUFFER, 1024, true);
+  auto vertex1 = m_renderGraphResourceManager->CreateBuffer("vertex1", BufferType::VERTEX_BUFFER, 1024, true);
+  auto vertex2 = m_renderGraphResourceManager->CreateBuffer("vertex2", BufferType::VERTEX_BUFFER, 512, true);
+  auto result = m_renderGraphResourceManager->CreateBuffer("result", BufferType::VERTEX_BUFFER, 512);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager, 2);
+  graph.AddGraphOutput(result);
+
+  HashMap<String, Vector<Buffer*>> writtenBuffers;
+  auto addPass = [&](const char* name, Vector<RenderGraphBufferHandler> inputs, RenderGraphBufferHandler output) {
+    graph.AddPass(name, [=, &writtenBuffers](RenderGraphGraphicsBuilder& builder) {
+      for (const auto& input : inputs) builder.ReadBuffer(input);
+      builder.WriteBuffer(output);
+      builder.BeginPipeline();
+      builder.EndPipeline();
+      return [=, &writtenBuffers](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+        writtenBuffers[name].push_back(registry.GetBuffer(output));
+      };
+    });
+  };
+  addPass("camera", {}, camera);
+  addPass("pass0", {}, vertex0);
+  addPass("pass1", {vertex0, camera}, vertex1);
+  addPass("pass2", {vertex1}, vertex2);
+  addPass("pass3", {vertex2, camera}, result);
+
+  ASSERT_TRUE(graph.Compile());
+  graph.Execute(nullptr, nullptr);
+  graph.Execute(nullptr, nullptr);
+
+  auto order = graph.GetExecuteOrder();
+  auto indexOf = [&](StringView name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+  ASSERT_EQ(order.size(), 5);
+  ASSERT_LT(indexOf("camera"), indexOf("pass1"));
+  ASSERT_LT(indexOf("pass0"), indexOf("pass1"));
+  ASSERT_LT(indexOf("pass1"), indexOf("pass2"));
+  ASSERT_LT(indexOf("pass2"), indexOf("pass3"));
+
+  // every frame in flight has its own copy of the transient buffer, vertex2 reuses the buffers of vertex0, and the
+  // uniform buffer is updated by the CPU during recording, so it's never aliased
+  ASSERT_EQ(graph.GetMemoryReport().bufferCount, 7);
+  ASSERT_EQ(graph.GetMemoryReport().textureCount, 0);
+  ASSERT_NE(writtenBuffers["camera"][0], writtenBuffers["camera"][1]);
+  ASSERT_NE(writtenBuffers["pass0"][0], writtenBuffers["pass1"][0]);
+  ASSERT_EQ(writtenBuffers["pass0"], writtenBuffers["pass2"]);
+  ASSERT_EQ(writtenBuffers["pass3"][0], writtenBuffers["pass3"][1]);
+}
+
+TEST_F(RenderGraphTest, RelativeTextureSize) {
+  using ::testing::_;
+  using ::testing::AllOf;
+  using ::testing::Field;
+
+  // the framebuffer follows the size of the render target, and only the resized texture is recreated
+  EXPECT_CALL(*m_bufferContext, CreateImage(_)).Times(3);
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(AllOf(Field(&FrameBufferCreateInfo::width, 800),
+                                                          Field(&FrameBufferCreateInfo::height, 600))))
+      .Times(1);
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(AllOf(Field(&FrameBufferCreateInfo::width, 200),
+                                                          Field(&FrameBufferCreateInfo::height, 150))))
+      .Times(1);
+
+  ImageCreateInfo createInfo;
+  createInfo.imageDesc = Image2DDesc();
+  createInfo.usage = ImageUsageFlags::SHADER_READ | ImageUsageFlags::COLOR_RENDER_TARGET;
+  createInfo.width = 64;
+  createInfo.height = 64;
+  m_renderGraphResourceManager->SetOutputExtent(1600, 1200);
+  auto halfTexture = m_renderGraphResourceManager->CreateTexture("half", createInfo, RenderGraphRelativeSize{0.5, 0.5});
+  auto fixedTexture = m_renderGraphResourceManager->CreateTexture("fixed", createInfo);
+
+  RenderGraph graph(m_rhiFactory, m_renderGraphResourceManager);
+  graph.AddGraphOutput(halfTexture);
+  graph.AddGraphOutput(fixedTexture);
+
+  Vector<std::pair<uint32_t, uint32_t>> viewports;
+  graph.AddPass("pass", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(halfTexture);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {
+      viewports.emplace_back(registry.GetFramebufferWidth(), registry.GetFramebufferHeight());
+    };
+  });
+  graph.AddPass("fixedPass", [&](RenderGraphGraphicsBuilder& builder) {
+    builder.WriteTexture(fixedTexture);
+    builder.BeginPipeline();
+    builder.EndPipeline();
+    builder.SetFramebufferSize(64, 64, 1);
+    return [&](RenderGraphGraphicsRegistry& registry, GraphicsCommandBuffer& commandBuffer) {};
+  });
+  EXPECT_CALL(*m_pipelineContext, CreateFrameBuffer(Field(&FrameBufferCreateInfo::width, 64))).Times(1);
+
+  graph.Compile();
+  graph.Execute(nullptr, nullptr);
+
+  m_renderGraphResourceManager->SetOutputExtent(400, 300);
+  graph.Compile();
+  graph.Execute(nullptr, nullptr);
+
+  ASSERT_EQ(viewports, (Vector<std::pair<uint32_t, uint32_t>>{{800, 600}, {200, 150}}));
+  ASSERT_EQ(m_renderGraphResourceManager->GetOutputWidth(), 400);
+  ASSERT_EQ(m_renderGraphResourceManager->GetOutputHeight(), 300);
+}
+
 }  // namespace Marbas
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "Core/Scene/Scene.hpp"
+#include "Core/Scene/System/SceneSystemJob/SceneSystem.hpp"
+
+namespace Marbas::Test {
+
+class BVHJobTest : public ::testing::Test {
+ protected:
+  entt::entity
+  AddNode(entt::entity parent, const glm::vec3& translate) {
+    auto entity = m_scene.AddChild(parent);
+    m_scene.Emplace<EmptySceneNode>(entity);
+    SetTranslate(entity, translate);
+    return entity;
+  }
+
+  entt::entity
+  AddBox(entt::entity parent, const glm::vec3& translate) {
+    auto entity = AddNode(parent, translate);
+    m_scene.Emplace<AABBComponent>(entity, glm::vec3(-1), glm::vec3(1));
+    return entity;
+  }
+
+  void
+  SetTranslate(entt::entity entity, const glm::vec3& translate) {
+    m_scene.Update<TransformComp>(entity, [&](TransformComp& component) {
+      component.SetLocalTransform(glm::translate(glm::mat4(1.0), translate));
+      return true;
+    });
+  }
+
+  void
+  Update(bool isSceneChange = false) {
+    Job::SceneUserData userData{.m_scene = &m_scene, .m_sceneChange = isSceneChange};
+    m_transformJob.update(0, &userData);
+    m_bvhJob.update(0, &userData);
+  }
+
+  Vector<entt::entity>
+  QueryBox(const glm::vec3& min, const glm::vec3& max) {
+    Vector<entt::entity> result;
+    m_scene.QueryBox({min, max}, [&](entt::entity entity) { result.push_back(entity); });
+    return result;
+  }
+
+ protected:
+  Scene m_scene;
+  Job::TransformJob m_transformJob;
+  Job::BVHJob m_bvhJob;
+};
+
+TEST_F(BVHJobTest, FollowTransform) {
+  auto parent = AddNode(m_scene.GetRootNode(), {10, 0, 0});
+  auto box = AddBox(parent, {0, 5, 0});
+  Update(true);
+  ASSERT_EQ(m_scene.GetBoundsCount(), 1);
+  ASSERT_EQ(QueryBox(glm::vec3(9, 4, -1), glm::vec3(11, 6, 1)), Vector<entt::entity>{box});
+
+  // the box is moved with its parent
+  SetTranslate(parent, {-10, 0, 0});
+  Update();
+  ASSERT_TRUE(QueryBox(glm::vec3(9, 4, -1), glm::vec3(11, 6, 1)).empty());
+  ASSERT_EQ(QueryBox(glm::vec3(-11, 4, -1), glm::vec3(-9, 6, 1)), Vector<entt::entity>{box});
+
+  Vector<entt::entity> result;
+  m_scene.QuerySphere(glm::vec3(-10, 8, 0), 2.5, [&](entt::entity entity) { result.push_back(entity); });
+  ASSERT_EQ(result, Vector<entt::entity>{box});
+
+  // the box added later is inserted, and the removed one is removed
+  auto other = AddBox(m_scene.GetRootNode(), {0, 0, 0});
+  Update();
+  ASSERT_EQ(m_scene.GetBoundsCount(), 2);
+  m_scene.Remove<AABBComponent>(box);
+  Update();
+  ASSERT_EQ(m_scene.GetBoundsCount(), 1);
+  ASSERT_EQ(QueryBox(glm::vec3(-100), glm::vec3(100)), Vector<entt::entity>{other});
+
+  // the cached bounding boxes culled by the SIMD kernel are kept in sync too
+  Frustum frustum;
+  frustum.leftFace = Plan(glm::vec3(-100, 0, 0), glm::vec3(1, 0, 0));
+  frustum.rightFace = Plan(glm::vec3(100, 0, 0), glm::vec3(-1, 0, 0));
+  frustum.bottomFace = Plan(glm::vec3(0, -100, 0), glm::vec3(0, 1, 0));
+  frustum.topFace = Plan(glm::vec3(0, 100, 0), glm::vec3(0, -1, 0));
+  frustum.nearFace = Plan(glm::vec3(0, 0, -100), glm::vec3(0, 0, 1));
+  frustum.farFace = Plan(glm::vec3(0, 0, 100), glm::vec3(0, 0, -1));
+  Vector<entt::entity> visible;
+  m_scene.CullFrustum(frustum, visible);
+  ASSERT_EQ(visible, Vector<entt::entity>{other});
+}
+
+TEST_F(BVHJobTest, RemoveAndAddInOneUpdate) {
+  auto root = m_scene.GetRootNode();
+  auto box = AddBox(root, {0, 0, 0});
+  Update(true);
+
+  // the count of the bounding boxes isn't changed, but the removed one must not be found anymore
+  m_scene.Remove<AABBComponent>(box);
+  auto other = AddBox(root, {10, 0, 0});
+  Update();
+  ASSERT_EQ(m_scene.GetBoundsCount(), 1);
+  ASSERT_EQ(QueryBox(glm::vec3(-100), glm::vec3(100)), Vector<entt::entity>{other});
+
+  // the box losing its transform is removed too, and it's inserted again with the component
+  m_scene.Remove<TransformComp>(other);
+  Update();
+  ASSERT_EQ(m_scene.GetBoundsCount(), 0);
+  m_scene.Emplace<AABBComponent>(box, glm::vec3(-1), glm::vec3(1));
+  Update();
+  ASSERT_EQ(QueryBox(glm::vec3(-100), glm::vec3(100)), Vector<entt::entity>{box});
+}
+
+TEST_F(BVHJobTest, Pick) {
+  auto root = m_scene.GetRootNode();
+  auto near = AddBox(root, {0, 0, 5});
+  auto far = AddBox(root, {0, 0, 10});
+  AddBox(root, {5, 0, 5});
+  Update(true);
+
+  ASSERT_EQ(m_scene.Pick(glm::vec3(0, 0, 0), glm::vec3(0, 0, 1)), near);
+  ASSERT_EQ(m_scene.Pick(glm::vec3(0, 0, 20), glm::vec3(0, 0, -1)), far);
+  ASSERT_EQ(m_scene.Pick(glm::vec3(0, 0, 0), glm::vec3(0, 0, -1)), entt::entity(entt::null));
+  ASSERT_EQ(m_scene.Pick(glm::vec3(0, 0, 0), glm::vec3(0, 0, 1), 3), entt::entity(entt::null));
+}
+
+}  // namespace Marbas::Test
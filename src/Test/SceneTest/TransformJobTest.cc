@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "Core/Scene/Scene.hpp"
+#include "Core/Scene/System/SceneSystemJob/SceneSystem.hpp"
+
+namespace Marbas::Test {
+
+class TransformJobTest : public ::testing::Test {
+ protected:
+  entt::entity
+  AddNode(entt::entity parent, const glm::vec3& translate) {
+    auto entity = m_scene.AddChild(parent);
+    m_scene.Emplace<EmptySceneNode>(entity);
+    SetTranslate(entity, translate);
+    return entity;
+  }
+
+  void
+  SetTranslate(entt::entity entity, const glm::vec3& translate) {
+    m_scene.Update<TransformComp>(entity, [&](TransformComp& component) {
+      component.SetLocalTransform(glm::translate(glm::mat4(1.0), translate));
+      return true;
+    });
+  }
+
+  glm::vec3
+  GetGlobalTranslate(entt::entity entity) {
+    return glm::vec3(m_scene.Get<TransformComp>(entity).GetGlobalTransform()[3]);
+  }
+
+  void
+  Update(bool isSceneChange = false) {
+    Job::SceneUserData userData;
+    userData.m_scene = &m_scene;
+    userData.m_sceneChange = isSceneChange;
+    m_job.update(0, &userData);
+  }
+
+ protected:
+  Scene m_scene;
+  Job::TransformJob m_job;
+};
+
+TEST_F(TransformJobTest, UpdateDirtySubtree) {
+  auto root = m_scene.GetRootNode();
+  auto a = AddNode(root, {1, 0, 0});
+  auto a1 = AddNode(a, {0, 1, 0});
+  auto a2 = AddNode(a, {0, 2, 0});
+  auto b = AddNode(root, {0, 0, 1});
+  auto b1 = AddNode(b, {0, 0, 2});
+
+  Update(true);
+  ASSERT_EQ(m_job.GetUpdateCount(), 6);
+  ASSERT_EQ(GetGlobalTranslate(a1), glm::vec3(1, 1, 0));
+  ASSERT_EQ(GetGlobalTranslate(a2), glm::vec3(1, 2, 0));
+  ASSERT_EQ(GetGlobalTranslate(b1), glm::vec3(0, 0, 3));
+
+  // nothing is changed
+  Update();
+  ASSERT_EQ(m_job.GetUpdateCount(), 0);
+
+  // only the moved leaf is updated
+  SetTranslate(a2, {0, 3, 0});
+  Update();
+  ASSERT_EQ(m_job.GetUpdateCount(), 1);
+  ASSERT_EQ(GetGlobalTranslate(a2), glm::vec3(1, 3, 0));
+
+  // the subtree of the moved node is updated once even if its child is moved too
+  SetTranslate(a, {2, 0, 0});
+  SetTranslate(a1, {0, 4, 0});
+  Update();
+  ASSERT_EQ(m_job.GetUpdateCount(), 3);
+  ASSERT_EQ(GetGlobalTranslate(a1), glm::vec3(2, 4, 0));
+  ASSERT_EQ(GetGlobalTranslate(a2), glm::vec3(2, 3, 0));
+  ASSERT_EQ(GetGlobalTranslate(b1), glm::vec3(0, 0, 3));
+
+  // the new node rebuilds the hierarchy
+  auto b2 = AddNode(b1, {1, 0, 0});
+  Update();
+  ASSERT_EQ(m_job.GetUpdateCount(), 7);
+  ASSERT_EQ(GetGlobalTranslate(b2), glm::vec3(1, 0, 3));
+}
+
+TEST(TransformJobParallelTest, SameAsSerial) {
+  // build the same random hierarchy in two scenes, one is updated serially and the other on the thread pool
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> distance(-10, 10);
+  Scene serialScene;
+  Scene parallelScene;
+  Vector<std::pair<entt::entity, entt::entity>> nodes = {{serialScene.GetRootNode(), parallelScene.GetRootNode()}};
+  auto setTranslate = [&](size_t node) {
+    auto translate = glm::translate(glm::mat4(1.0), glm::vec3(distance(random), distance(random), distance(random)));
+    auto update = [&](TransformComp& component) {
+      component.SetLocalTransform(translate);
+      return true;
+    };
+    serialScene.Update<TransformComp>(nodes[node].first, update);
+    parallelScene.Update<TransformComp>(nodes[node].second, update);
+  };
+  for (int i = 0; i < 20000; i++) {
+    auto parent = nodes[std::uniform_int_distribution<size_t>(0, nodes.size() - 1)(random)];
+    auto serialNode = serialScene.AddChild(parent.first);
+    auto parallelNode = parallelScene.AddChild(parent.second);
+    serialScene.Emplace<EmptySceneNode>(serialNode);
+    parallelScene.Emplace<EmptySceneNode>(parallelNode);
+    nodes.emplace_back(serialNode, parallelNode);
+    setTranslate(nodes.size() - 1);
+  }
+
+  ThreadPool threadPool(4);
+  Job::TransformJob serialJob;
+  Job::TransformJob parallelJob;
+  auto update = [&](bool isSceneChange) {
+    Job::SceneUserData serialData{.m_scene = &serialScene, .m_sceneChange = isSceneChange};
+    Job::SceneUserData parallelData{
+        .m_scene = &parallelScene, .m_sceneChange = isSceneChange, .m_threadPool = &threadPool};
+    serialJob.update(0, &serialData);
+    parallelJob.update(0, &parallelData);
+    ASSERT_EQ(serialJob.GetUpdateCount(), parallelJob.GetUpdateCount());
+    for (auto [serialNode, parallelNode] : nodes) {
+      const auto& serialTransform = serialScene.Get<TransformComp>(serialNode).GetGlobalTransform();
+      const auto& parallelTransform = parallelScene.Get<TransformComp>(parallelNode).GetGlobalTransform();
+      ASSERT_TRUE(serialTransform == parallelTransform);
+    }
+  };
+  update(true);
+  ASSERT_EQ(parallelJob.GetUpdateCount(), nodes.size());
+
+  // move the random nodes, then move the root so the whole scene is updated again
+  for (int i = 0; i < 100; i++) {
+    setTranslate(std::uniform_int_distribution<size_t>(1, nodes.size() - 1)(random));
+  }
+  update(false);
+  setTranslate(0);
+  update(false);
+  ASSERT_EQ(parallelJob.GetUpdateCount(), nodes.size());
+}
+
+}  // namespace Marbas::Test
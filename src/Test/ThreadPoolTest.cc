@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "Common/ThreadPool.hpp"
+
+namespace Marbas {
+
+TEST(ThreadPoolTest, Submit) {
+  ThreadPool threadPool(4);
+
+  Vector<std::future<int>> futures;
+  for (int i = 0; i < 100; i++) {
+    futures.push_back(threadPool.Submit([i] { return i * i; }));
+  }
+
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(futures[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+  ThreadPool threadPool(4);
+
+  Vector<int> values(1000, 0);
+  threadPool.ParallelFor(values.size(), [&](uint32_t index) { values[index] += index; });
+  for (int i = 0; i < values.size(); i++) {
+    ASSERT_EQ(values[i], i);
+  }
+
+  // the nested ParallelFor can't dead lock even if all threads are busy
+  std::atomic_int count = 0;
+  threadPool.ParallelFor(8, [&](uint32_t) { threadPool.ParallelFor(8, [&](uint32_t) { count++; }); });
+  ASSERT_EQ(count, 64);
+}
+
+TEST(ThreadPoolTest, ParallelForException) {
+  ThreadPool threadPool(4);
+
+  // the exception thrown in any thread is rethrown in the caller after all the tasks are finished
+  std::atomic_int count = 0;
+  auto func = [&](uint32_t index) {
+    count++;
+    if (index % 10 == 3) throw std::runtime_error("failed");
+  };
+  ASSERT_THROW(threadPool.ParallelFor(100, func), std::runtime_error);
+  ASSERT_GT(count, 0);
+
+  // the pool can still be used
+  count = 0;
+  threadPool.ParallelFor(100, [&](uint32_t) { count++; });
+  ASSERT_EQ(count, 100);
+}
+
+}  // namespace Marbas
@@ -39,3 +39,23 @@ target('Marbas.Test', function()
 
   add_packages('gtest', 'abseil', 'toml++', 'entt', 'glfw', 'glm', 'glog', 'fmt', 'cereal')
 end)
+
+-- the allocation test replaces the global operator new to count the allocations, so it doesn't share the binary with
+-- the other tests
+target('Marbas.AllocationTest', function()
+  set_kind('binary')
+  set_languages('c11', 'cxx20')
+  add_deps('Marbas.Core', 'Marbas.RHI', 'Marbas.Common')
+
+  add_includedirs('$(projectdir)/src')
+  add_includedirs('$(projectdir)/src/Test')
+
+  add_files('$(projectdir)/src/Test/main.cc')
+  add_files('$(projectdir)/src/Test/AllocationTest/*.cc')
+
+  if is_mode('debug') then
+    add_defines('DEBUG')
+  end
+
+  add_packages('gtest', 'abseil', 'toml++', 'entt', 'glfw', 'glm', 'glog', 'fmt', 'cereal')
+end)